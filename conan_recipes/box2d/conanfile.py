@@ -1,5 +1,6 @@
 from conan import ConanFile, tools
 import os
+import re
 import shutil
 
 class Recipe(ConanFile):
@@ -26,6 +27,28 @@ class Recipe(ConanFile):
 					shutil.move(name, self.source_folder)
 			shutil.rmtree("Contributions")
 			shutil.rmtree("Box2d_old")
+		else:
+			self.makeCountersThreadLocal()
+
+	def makeCountersThreadLocal(self):
+		# The GJK and TOI profiling counters are plain globals that every
+		# b2World increments. Zones are stepped concurrently in separate worlds
+		# (see phys_step_threads) so make them per thread instead of racing.
+		pattern = re.compile(r"\b(B2_API\s+(?:extern\s+)?)((?:int32|float)\s+b2_(?:gjk|toi)\w*)")
+		count = 0
+		for folder in ["src", "include"]:
+			for root, dirs, files in os.walk(os.path.join(self.source_folder, folder)):
+				for name in files:
+					if not name.endswith((".h", ".cpp")): continue
+					path = os.path.join(root, name)
+					with open(path, "r") as f: text = f.read()
+					text, n = pattern.subn(r"\1thread_local \2", text)
+					if n == 0: continue
+					with open(path, "w") as f: f.write(text)
+					count += n
+
+		if count == 0:
+			raise Exception("Unable to find the Box2D GJK/TOI counters to make thread local.")
 
 	def generate(self):
 		tc = tools.cmake.CMakeToolchain(self)
@@ -196,6 +196,12 @@ namespace Engine::ECS {
 			/** The containers for storing components. */
 			void* compContainers[sizeof...(Cs)] = {};
 
+			/** The stamp of the last modification of each component. Indexed by entity id. @see markModified */
+			std::array<std::vector<uint64>, sizeof...(Cs)> modifiedStamps;
+
+			/** The stamp to use for the next modification. Zero is never used. */
+			uint64 nextModifiedStamp = 1;
+
 			struct {
 				// TODO: what happens here when set call setNextTick? is this okay?
 				Tick tick = invalidTick;
@@ -400,6 +406,7 @@ namespace Engine::ECS {
 				
 				auto& container = getComponentContainer<C>();
 				auto& comp = container.add(ent, std::forward<Args>(args)...);
+				markModified<C>(ent);
 
 				// Update filters
 				for (const auto i : compToFilter[cid]) {
@@ -457,7 +464,7 @@ namespace Engine::ECS {
 				C* comp = nullptr;
 
 				if constexpr (!IsFlagComponent<C>::value) {
-					comp = &getComponent<C>(ent);
+					comp = &getComponentContainer<C>()[ent];
 				}
 
 				// Callbacks
@@ -500,13 +507,20 @@ namespace Engine::ECS {
 				);
 
 				ENGINE_DEBUG_ASSERT(hasComponent<Component>(ent), "Attempting to get a component that an entity doesn't have.");
+				if constexpr (IsModifiedTracked<Component>::value) { markModified<Component>(ent); }
 				return getComponentContainer<Component>()[ent];
 			}
 
 			template<class Component>
 			ENGINE_INLINE const Component& getComponent(Entity ent) const {
 				debugEntityCheck(ent);
-				return const_cast<World*>(this)->getComponent<Component>(ent);
+				static_assert(!IsFlagComponent<Component>::value,
+					"Calling World::getComponent on a flag component is not allowed. Use World::hasComponent instead."
+				);
+
+				// Don't go through the non-const getComponent, that would mark tracked components as modified.
+				ENGINE_DEBUG_ASSERT(hasComponent<Component>(ent), "Attempting to get a component that an entity doesn't have.");
+				return const_cast<World*>(this)->getComponentContainer<Component>()[ent];
 			}
 
 			/**
@@ -518,6 +532,33 @@ namespace Engine::ECS {
 				return hasComponent<Component>(ent) ? &getComponent<Component>(ent) : nullptr;
 			}
 
+			/**
+			 * Marks a component as modified. Systems that change a component outside of
+			 * snapshots should call this so that change tracking (such as network
+			 * replication) can pick up the change. Adding a component also marks it, as
+			 * does any mutable access to a component that specializes IsModifiedTracked.
+			 * @see getModifiedStamp
+			 */
+			template<class C>
+			ENGINE_INLINE void markModified(Entity ent) {
+				auto& stamps = modifiedStamps[getComponentId<C>()];
+				if (ent.id >= stamps.size()) { stamps.resize(ent.id + 1); }
+				stamps[ent.id] = nextModifiedStamp++;
+			}
+
+			/**
+			 * Gets a value that changes every time a component is marked as modified.
+			 * Stamps are unique across all components so they can be compared for equality
+			 * to check if a component has been modified since the stamp was taken.
+			 * @see markModified
+			 */
+			template<class C>
+			ENGINE_INLINE uint64 getModifiedStamp(Entity ent) const {
+				debugEntityCheck(ent);
+				const auto& stamps = modifiedStamps[getComponentId<C>()];
+				return ent.id < stamps.size() ? stamps[ent.id] : 0;
+			}
+
 			template<class C>
 			ENGINE_INLINE bool hadComponent(Entity ent, Tick tick) const {
 				return history.get(tick).getComponentContainer<C>().contains(ent);
@@ -1,5 +1,8 @@
 #pragma once
 
+// STD
+#include <type_traits>
+
 // Engine
 #include <Engine/ECS/Entity.hpp>
 #include <Engine/SparseSet.hpp>
@@ -43,6 +46,16 @@ namespace Engine::ECS {
 	using SystemBitset = Bitset<MAX_SYSTEMS>; // TODO: is there a reason this isnt a member of World?
 
 	using EntityStates = std::vector<EntityState>;
+
+	/**
+	 * Components that specialize this as true are marked as modified whenever a
+	 * mutable reference is acquired through World::getComponent. Use this for
+	 * components that are written from many places where calling markModified
+	 * manually would be easy to miss. Read through a const World to avoid marking.
+	 * @see World::markModified
+	 */
+	template<class T>
+	struct IsModifiedTracked : std::false_type {};
 }
 
 // Asserts
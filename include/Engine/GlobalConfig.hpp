@@ -1,11 +1,18 @@
 #pragma once
 
+// STD
+#include <string>
+
 // Engine
 #include <Engine/Types.hpp>
 #include <Engine/Net/IPv4Address.hpp>
 #include <Engine/Logger.hpp>
 
 
+namespace Engine::Net {
+	class LoopbackNetwork;
+}
+
 namespace Engine {
 	class GlobalConfig {
 		public:
@@ -22,6 +29,16 @@ namespace Engine {
 			// Command line only
 			uint16 port = 0;
 			Net::IPv4Address group = {};
+			uint16 bots = 0;
+
+			/** If set all datagrams received by the main game socket are written to this file. @see Net::PacketCapture */
+			std::string capture;
+
+			/** If set the main game socket is replaced by datagrams read from this capture file. @see Net::PacketReplay */
+			std::string replay;
+
+			/** If set the main game socket uses this in-process network instead of the OS. */
+			Net::LoopbackNetwork* loopback = nullptr;
 
 			// TODO: shouldn't be including "Game" files in Engine
 			struct CVars {
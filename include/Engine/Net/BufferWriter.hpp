@@ -30,18 +30,18 @@ namespace Engine::Net {
 				bitStore |= uint64{t} << bitCount;
 				bitCount += N;
 				while (bitCount >= 8) {
-					self().write<uint8>(static_cast<uint8>(bitStore));
+					self().template write<uint8>(static_cast<uint8>(bitStore));
 					bitStore >>= 8;
 					bitCount -= 8;
 				}
 			}
 
 			void writeFlushBits() {
-				while (bitCount > 0) {
-					self().write<uint8>(static_cast<uint8>(bitStore));
-					bitStore >>= 8;
-					bitCount -= 8;
+				// writeBits always leaves less than a byte pending.
+				if (bitCount > 0) {
+					self().template write<uint8>(static_cast<uint8>(bitStore));
 				}
+				bitStore = 0;
 				bitCount = 0;
 			}
 
@@ -105,8 +105,9 @@ namespace Engine::Net {
 
 			ENGINE_INLINE_REL bool write(const void* src, int64 sz) {
 				ENGINE_DEBUG_ASSERT(sz > 0);
-				ENGINE_DEBUG_ASSERT(sz <= capacity(), capacity());
 
+				// Larger than the capacity is allowed since channels may be given
+				// limited space. @see Connection::fillPacket
 				if (curr + sz > stop) { return false; }
 				memcpy(curr, src, sz);
 				curr += sz;
@@ -266,13 +267,12 @@ namespace Engine::Net {
 				static_assert(sizeof(T) * CHAR_BIT >= N, "Invalid output type for given number of bits");
 
 				while (bitCount < N) {
+					if (curr == stop) { return false; }
 					bitStore |= uint64{*curr} << bitCount;
 					bitCount += 8;
 					curr += 1;
 				}
 
-				ENGINE_DEBUG_ASSERT(curr <= stop, "Read to many bits from buffer.");
-
 				constexpr uint64 mask = (1ull << N) - 1ull;
 				*out = static_cast<T>(bitStore & mask);
 				bitStore >>= N;
@@ -1,6 +1,11 @@
 #pragma once
 
+// STD
+#include <limits>
+#include <optional>
+
 // Engine
+#include <Engine/StaticVector.hpp>
 #include <Engine/Net/MessageHeader.hpp>
 #include <Engine/Net/BufferWriter.hpp>
 #include <Engine/Net/Packet.hpp> // TODO: once we have configurable limits this isnt needed
@@ -24,15 +29,12 @@ namespace Engine::Net {
 	// TODO: make MAX_ACTIVE_MESSAGES_PER_CHANNEL a template argument of Channel_ReliableSender instead of global?
 	constexpr inline int MAX_ACTIVE_MESSAGES_PER_CHANNEL = 64;
 
-	// TODO: This isn't ideal for reliable channels (Channel_ReliableSender). We do an extra copy of
-	//       all data:
-	// 
-	//       1. Copy to the temp buffer. That is the buffer passed to the constructor from Connection::beginMessage.
-	//       2. When endMessage is called (then Channel_ReliableSender::endMessage) the data is copied a
-	//          second time to another buffer.
-	// 
-	//       For reliable channels we should have a way to write directly to the channels buffer and skip
-	//       the extra copy to the temp Connection buffer.
+	/** The retransmission timeout used before any round trip times have been measured. */
+	constexpr inline Engine::Clock::Duration DEFAULT_RETRANSMIT_TIMEOUT = std::chrono::milliseconds{200};
+
+	// NOTE: Unreliable channels write to the temp buffer from Connection::beginMessage and copy
+	//       the message in endMessage. Reliable channels (Channel_ReliableSender) write directly
+	//       to their MessageSlab and skip that copy.
 	// 
 	// TODO: Change to just inherit BufferWriter to avoid re-implementing write functions.
 	template<class Channel, class BufferWriter, bool PopulateHeader>
@@ -101,6 +103,18 @@ namespace Engine::Net {
 			}
 	};
 
+	/**
+	 * How a channel shares packet space with other channels on the same connection.
+	 * @see Connection::setChannelSchedule
+	 */
+	struct ChannelSchedule {
+		/** The relative share of packet space this channel gets when multiple channels have data to send. */
+		float32 weight = 1.0f;
+
+		/** The fraction of each packet reserved for this channel, in [0, 1], whenever it has data to send. */
+		float32 minShare = 0.0f;
+	};
+
 	/**
 	 * The base class used by all channels.
 	 * @tparam Ms... A sequential list of messages handled by this channel.
@@ -119,6 +133,8 @@ namespace Engine::Net {
 			}
 			static_assert(contiguous(), "The messages handled by a channel must be contiguous.");
 		public:
+			/** The default schedule used for this channel. Derived channels may hide this to change it. */
+			constexpr static ChannelSchedule schedule = {};
 
 		public:
 			Channel_Base() = default;
@@ -148,6 +164,20 @@ namespace Engine::Net {
 			 */
 			constexpr static void recvPacketAck(SeqNum seq) noexcept {}
 
+			/**
+			 * Called when the connection updates its retransmission timeout estimate.
+			 * Usually used for implementing message level reliability.
+			 * @param rto The minimum time to wait for an ack before resending.
+			 */
+			constexpr static void setRetransmitTimeout(Engine::Clock::Duration rto) noexcept {}
+
+			/**
+			 * Called before filling packets with the number of bytes per second the connection may send.
+			 * Usually used for pacing channels that could otherwise use the whole packet budget.
+			 * @param bytesPerSecond The send bandwidth of the connection.
+			 */
+			constexpr static void setSendBandwidth(float32 bytesPerSecond) noexcept {}
+
 			/**
 			 * Checks if this channel can have messages written to it.
 			 */
@@ -173,11 +203,18 @@ namespace Engine::Net {
 
 			/**
 			 * Fills the given packet/buffer with messages from this channel.
+			 * May be called multiple times per packet with a limited amount of space each time.
 			 * @param pktSeq The sequence number of the packet to fill.
 			 * @param buff The buffer to write the messages to.
 			 */
 			void fill(SeqNum pktSeq, StaticBufferWriter& buff) = delete;
 
+			/**
+			 * Called after all packets for a call to Connection::send have been filled.
+			 * Usually used to discard unreliable messages that didn't fit.
+			 */
+			constexpr static void finishSend() noexcept {}
+
 			/**
 			 * Determines if a message should be processed by a connection.
 			 * @param hdr The header for the message.
@@ -196,6 +233,12 @@ namespace Engine::Net {
 			 * Gets the number of messages waiting to be sent.
 			 */
 			int32 getQueueSize() = delete;
+
+			/**
+			 * Gets the number of bytes that could be sent right now. Messages that are only
+			 * waiting on an ack are not included. Used to decide which channels compete for packet space.
+			 */
+			int32 getSendableSize() = delete;
 	};
 
 	/**
@@ -232,13 +275,21 @@ namespace Engine::Net {
 						break;
 					}
 				}
+			}
 
+			void finishSend() noexcept {
 				messages.clear();
 			}
 
 			int32 getQueueSize() const noexcept {
 				return static_cast<int32>(messages.size());
 			}
+
+			int32 getSendableSize() const noexcept {
+				int32 size = 0;
+				for (const auto& msg : messages) { size += static_cast<int32>(msg.size()); }
+				return size;
+			}
 	};
 	
 	/**
@@ -281,73 +332,218 @@ namespace Engine::Net {
 						break;
 					}
 				}
+			}
 
+			void finishSend() noexcept {
 				messages.clear();
 			}
 
 			int32 getQueueSize() const noexcept {
 				return messages.size();
 			}
+
+			int32 getSendableSize() const noexcept {
+				int32 size = 0;
+				for (const auto& msg : messages) { size += static_cast<int32>(msg.size()); }
+				return size;
+			}
+	};
+
+	/**
+	 * Fixed size slots for storing messages until they are no longer needed.
+	 * Allocated once so that writing and resending messages never allocates.
+	 */
+	template<int32 N>
+	class MessageSlab {
+		public:
+			/** The size of each slot. Large enough for any message that fits in a packet. */
+			constexpr static int32 slotSize = sizeof(Packet::body);
+
+		private:
+			std::unique_ptr<byte[]> storage = std::make_unique_for_overwrite<byte[]>(N * slotSize);
+
+		public:
+			ENGINE_INLINE byte* slot(int32 i) noexcept {
+				ENGINE_DEBUG_ASSERT(0 <= i && i < N);
+				return storage.get() + i * slotSize;
+			}
+
+			ENGINE_INLINE const byte* slot(int32 i) const noexcept {
+				return const_cast<MessageSlab*>(this)->slot(i);
+			}
 	};
 
 	/**
 	 * Implements the sending portion of a reliable network channel.
+	 * Messages are written directly to a slab slot and stay there until acked.
 	 * @see Channel_Base
 	 */
 	template<MessageType... Ms>
 	class Channel_ReliableSender : public Channel_Base<Ms...> {
 		protected:
+			constexpr static auto capacity = MAX_ACTIVE_MESSAGES_PER_CHANNEL;
+
 			/** The sequence number to use for the next message */
 			SeqNum nextSeq = 0;
 
+			/** The maximum number of times the resend delay is doubled for a message. */
+			constexpr static uint8 maxBackoff = 4;
+
 			struct MsgData {
 				Engine::Clock::TimePoint lastSendTime;
-				std::vector<byte> data;
+
+				/** The size of the message, including the header. The data is in the slot for the message. */
+				uint16 size;
+
+				/** The number of times this message has been sent. */
+				uint8 sendCount;
 			};
-			SequenceBuffer<SeqNum, MsgData, MAX_ACTIVE_MESSAGES_PER_CHANNEL> msgData; // TODO: ideal size?
+			SequenceBuffer<SeqNum, MsgData, capacity> msgData; // TODO: ideal size?
+
+			/** Message data. Uses the same indices as msgData so a slot is free whenever its msgData entry is. */
+			MessageSlab<capacity> msgSlab;
+
+			/** The writer for the message currently being written. */
+			std::optional<StaticBufferWriter> msgWriter;
+
+			/** The number of messages that have not been sent yet. */
+			int32 unsentCount = 0;
+
+			/** The current retransmission timeout. @see setRetransmitTimeout */
+			Engine::Clock::Duration rto = DEFAULT_RETRANSMIT_TIMEOUT;
+
+			/** The packet that resendOffered and resendSize are for. */
+			SeqNum resendPktSeq = 0;
+
+			/** The number of bytes this channel has been given in packet resendPktSeq. */
+			int64 resendOffered = 0;
+
+			/** The number of bytes resent in packet resendPktSeq. */
+			int64 resendSize = 0;
 
 			struct PacketData {
-				std::vector<SeqNum> messages;
+				StaticVector<SeqNum, capacity> messages;
 			};
-			SequenceBuffer<SeqNum, PacketData, MAX_ACTIVE_MESSAGES_PER_CHANNEL> pktData; // TODO: ideal size?
+
+			/** Sized to match the ack window so we can still use acks for any packet in it. */
+			SequenceBuffer<SeqNum, PacketData, AckBitset::size()> pktData;
 
 			void addMessageToPacket(SeqNum pktSeq, SeqNum msgSeq) {
 				auto* pkt = pktData.find(pktSeq);
-				if (!pkt) { pkt = &pktData.insert(pktSeq); }
+				if (!pkt) {
+					pkt = &pktData.insertNoInit(pktSeq);
+					pkt->messages.clear();
+				}
 				pkt->messages.push_back(msgSeq);
 			}
 
+			ENGINE_INLINE byte* getMessageData(SeqNum msgSeq) noexcept {
+				return msgSlab.slot(msgSeq % capacity);
+			}
+
+			/**
+			 * Gets the time to wait for an ack before resending a message. Doubled for each
+			 * resend so we back off under loss or congestion instead of adding to it.
+			 */
+			ENGINE_INLINE Engine::Clock::Duration getResendDelay(const MsgData& msg) const noexcept {
+				return rto * (1 << std::min<uint8>(msg.sendCount - 1, maxBackoff));
+			}
+
 		public:
 			int32 getQueueSize() const noexcept {
 				return msgData.span();
 			}
 
+			/** Unsent messages and resends that are due. */
+			int32 getSendableSize() const noexcept {
+				const auto now = Engine::Clock::now();
+				int32 size = 0;
+				for (auto seq = msgData.minValid(); Math::Seq::less(seq, msgData.max() + 1); ++seq) {
+					const auto* msg = msgData.find(seq);
+					if (!msg) { continue; }
+					if (msg->sendCount == 0 || now >= msg->lastSendTime + getResendDelay(*msg)) {
+						size += msg->size;
+					}
+				}
+				return size;
+			}
+
 			bool canWriteMessage() const {
 				return !msgData.entryAt(nextSeq);
 			}
 
+			template<class Channel>
+			[[nodiscard]]
+			auto beginMessage(Channel& channel, MessageType type) {
+				StaticBufferWriter* writer = nullptr;
+				if (channel.canWriteMessage()) {
+					writer = &msgWriter.emplace(getMessageData(nextSeq), MessageSlab<capacity>::slotSize);
+				}
+				return MessageWriter<Channel, StaticBufferWriter, true>{channel, type, writer};
+			}
+
+			/**
+			 * @copydoc Channel_Base::beginMessage
+			 * The message is written directly to its slot. @p buff is unused.
+			 */
+			template<class Channel>
+			[[nodiscard]]
+			auto beginMessage(Channel& channel, MessageType type, StaticBufferWriter& /*buff*/) {
+				return beginMessage(channel, type);
+			}
+
 			void endMessage(StaticBufferWriter& buff) {
 				ENGINE_DEBUG_ASSERT(canWriteMessage());
+				ENGINE_DEBUG_ASSERT(buff.data() == getMessageData(nextSeq), "Reliable messages must be written to their slot.");
 				auto* hdr = reinterpret_cast<MessageHeader*>(buff.data());
 				hdr->seq = nextSeq++;
 
 				ENGINE_DEBUG_ASSERT(msgData.canInsert(hdr->seq));
-				auto& msg = msgData.insert(hdr->seq);
-				msg.data.assign(buff.cbegin(), buff.cend());
+				auto& msg = msgData.insertNoInit(hdr->seq);
+				msg.size = static_cast<uint16>(buff.size());
 				msg.lastSendTime = {};
+				msg.sendCount = 0;
+				++unsentCount;
+				msgWriter.reset();
+			}
+
+			void setRetransmitTimeout(Engine::Clock::Duration rto) noexcept {
+				this->rto = rto;
 			}
 			
 			void fill(SeqNum pktSeq, StaticBufferWriter& buff) {
 				const auto now = Engine::Clock::now();
-				// BUG: at our current call rate this may overwrite packets before we have a chance to ack them because they are overwritten with a new packets info
+
+				// While there are unsent messages resends may only use half of the space so they
+				// share the packet budget with new data instead of starving it. Fill may be called
+				// multiple times for the same packet so this is tracked per packet instead of per call.
+				if (pktSeq != resendPktSeq) {
+					resendPktSeq = pktSeq;
+					resendOffered = 0;
+					resendSize = 0;
+				}
+				resendOffered += buff.space();
+				const auto resendLimit = resendOffered / 2;
+
 				for (auto seq = msgData.minValid(); Math::Seq::less(seq, msgData.max() + 1); ++seq) {
 					auto* msg = msgData.find(seq);
+					if (!msg) { continue; }
+
+					const bool resend = msg->sendCount > 0;
+					if (resend) {
+						if (now < msg->lastSendTime + getResendDelay(*msg)) { continue; }
+						if (unsentCount && resendSize + msg->size > resendLimit) { continue; }
+					}
 
-					// TODO: resend time should be configurable per channel
-					if (msg && (now > msg->lastSendTime + std::chrono::milliseconds{50})) {
-						if (buff.write(msg->data.data(), msg->data.size())) {
-							msg->lastSendTime = now;
-							addMessageToPacket(pktSeq, seq);
+					if (buff.write(getMessageData(seq), msg->size)) {
+						msg->lastSendTime = now;
+						msg->sendCount = static_cast<uint8>(std::min(msg->sendCount + 1, 255));
+						addMessageToPacket(pktSeq, seq);
+
+						if (resend) {
+							resendSize += msg->size;
+						} else {
+							--unsentCount;
 						}
 					}
 				}
@@ -406,7 +602,8 @@ namespace Engine::Net {
 		public:
 			bool recv(const MessageHeader& hdr, const BufferReader buff) {
 				if (recvData.canInsert(hdr.seq) && !recvData.contains(hdr.seq)) {
-					auto& rcv = recvData.insert(hdr.seq);
+					// Reuse the existing allocation. See TODO 0W4vlcPN.
+					auto& rcv = recvData.insertNoInit(hdr.seq);
 					rcv.data.assign(buff.begin(), buff.end());
 				}
 				return false;
@@ -424,122 +621,250 @@ namespace Engine::Net {
 			}
 	};
 
-	// TODO: What determines this? Seems arbitrary.
-	constexpr int32 MAX_MESSAGE_BLOB_SIZE = 0x7FFFFFFF;
+	/**
+	 * The exclusive upper bound on the size of a blob.
+	 * Assembled blobs are delivered with a MessageHeader so their size must fit in MessageHeader::size.
+	 */
+	constexpr int32 MAX_MESSAGE_BLOB_SIZE = std::numeric_limits<decltype(MessageHeader::size)>::max();
+
+	/**
+	 * Configuration for Channel_LargeReliableOrdered.
+	 */
+	struct LargeChannelConfig {
+		/** The maximum number of blobs being sent at once. Must be a power of two. */
+		int32 maxBlobs = 32;
+
+		/** The maximum number of sent fragments waiting for an ack across all blobs. */
+		int32 window = 256;
+
+		/** The number of blob bytes in each fragment. The last fragment of a blob may be smaller. */
+		int32 fragmentSize = 512;
+
+		/** The maximum percentage of the connection's send bandwidth this channel may use. */
+		int32 bandwidthPercent = 75;
+	};
 
 	/**
 	 * A reliable ordered network channel with support for message splitting so that we are able to
 	 * handle data larger than a single packet.
-	 * @see Channel_ReliableSender
+	 *
+	 * Blobs are split into fixed size fragments. Each blob tracks which of its fragments have been
+	 * acked so only lost fragments are resent, with exponential backoff. Sending is limited by a
+	 * sliding window of unacked fragments and paced slightly above the rate fragments are being
+	 * acked so that loss slows sending down instead of being resent at full rate. The pacing rate
+	 * never exceeds a share of the connection's send bandwidth.
+	 * @see LargeChannelConfig
 	 * @see Channel_Base
 	 */
-	template<MessageType... Ms>
-	class Channel_LargeReliableOrdered : public Channel_ReliableSender<Ms...> {
+	template<LargeChannelConfig Config, MessageType... Ms>
+	class Channel_LargeReliableOrdered : public Channel_Base<Ms...> {
+		static_assert(Config.maxBlobs > 0 && std::has_single_bit(static_cast<uint32>(Config.maxBlobs)), "The maximum number of blobs must be a power of two.");
+		static_assert(Config.window > 0, "The window must allow at least one fragment.");
+		static_assert(Config.bandwidthPercent > 0 && Config.bandwidthPercent <= 100, "Invalid bandwidth percentage.");
+
 		private:
-			using Base = Channel_ReliableSender<Ms...>;
-			SeqNum nextRecvSeq = 0;
-			SeqNum nextBlob = 0;
+			constexpr static auto maxBlobs = static_cast<SeqNum>(Config.maxBlobs);
 
-			SequenceBuffer<SeqNum, bool, MAX_ACTIVE_MESSAGES_PER_CHANNEL> recvData;
+			/** The maximum number of fragments tracked for a single packet. */
+			constexpr static int32 maxPacketFragments = 32;
 
-			struct Range {
-				int32 start;
-				int32 stop;
+			/** The maximum amount of unused bandwidth that can be saved up for a burst, in seconds. */
+			constexpr static float32 maxBurstTime = 0.1f;
 
-				ENGINE_INLINE int32 size() const noexcept { return stop - start; }
-				ENGINE_INLINE bool operator<(const Range& other) const noexcept {
-					return start < other.start;
-				}
+			/** The maximum number of times the resend delay is doubled for a fragment. */
+			constexpr static int32 maxBackoff = 4;
+
+			/** How long to measure acked bytes for each ack rate sample. */
+			constexpr static auto ackRateInterval = std::chrono::milliseconds{100};
+
+			/** How much faster than the ack rate we send so the rate can grow when there is room. */
+			constexpr static float32 pacingGain = 1.25f;
+
+			/** The minimum pacing rate in bytes per second so we can recover from heavy loss. */
+			constexpr static float32 minPacingRate = 16.0f * Config.fragmentSize;
+
+			/**
+			 * Written after the MessageHeader of each fragment. The sequence number
+			 * in the MessageHeader is the sequence number of the blob.
+			 */
+			struct FragmentHeader {
+				/** The total size of the blob. Included in every fragment so they can arrive in any order. */
+				int32 blobSize;
+
+				/** The index of this fragment in the blob. */
+				int32 index;
+			};
+			static_assert(Config.fragmentSize > 0
+				&& sizeof(MessageHeader) + sizeof(FragmentHeader) + Config.fragmentSize <= sizeof(Packet::body),
+				"Fragments must fit within a single packet."
+			);
+
+			class FragmentBitmap {
+				private:
+					std::vector<uint64> bits;
+
+				public:
+					ENGINE_INLINE void reset(int32 count) { bits.assign((count + 63) / 64, 0); }
+					ENGINE_INLINE bool test(int32 i) const noexcept { return bits[i / 64] & (1ull << (i % 64)); }
+					ENGINE_INLINE void set(int32 i) noexcept { bits[i / 64] |= 1ull << (i % 64); }
 			};
 
 			struct WriteBlob {
-				int32 curr = 0;
 				std::vector<byte> data;
 				MessageType type;
-				SeqNum parts;
-				const int32 remaining() const noexcept { return static_cast<int32>(data.size()) - curr; }
+				int32 fragmentCount;
+
+				/** The next fragment that has never been sent. */
+				int32 nextFragment;
+
+				/** All fragments before this one have been acked. */
+				int32 firstUnacked;
+
+				/** The number of fragments that have not been acked. */
+				int32 unacked;
+
+				FragmentBitmap acked;
+				std::vector<Engine::Clock::TimePoint> sendTimes;
+				std::vector<uint8> sendCounts;
 			};
 
 			struct RecvBlob {
-				int32 total = 0;
+				/** The assembled message. Includes space for the MessageHeader populated in recvNext. */
 				std::vector<byte> data;
-				std::vector<Range> parts;
+				FragmentBitmap received;
+				int32 remaining;
+			};
 
-				ENGINE_INLINE bool complete() const noexcept {
-					return (parts.size() == 1) && (parts.begin()->size() == total + sizeof(MessageHeader));
-					//return total && (total == data.size() - sizeof(MessageHeader));
-				}
+			struct FragmentId {
+				SeqNum blob;
+				int32 index;
+			};
 
-				void insert(int32 i, const byte* start, const byte* stop) {
-					i = i + sizeof(MessageHeader);
-					const int32 len = static_cast<int32>(stop - start);
-					if (static_cast<int32>(data.size()) < i + len) {
-						data.resize(i + len);
-					}
-					// ENGINE_LOG("Insert: ", len, " ", data.size());
-					memcpy(&data[i], start, len);
+			struct PacketData {
+				StaticVector<FragmentId, maxPacketFragments> fragments;
+			};
 
-					const Range range {i, i + len};
-					auto found = std::upper_bound(parts.begin(), parts.end(), range);
+			SeqNum nextBlob = 0;
+			SeqNum nextRecvSeq = 0;
 
-					// Merge with after
-					if (found != parts.cend() && range.stop == found->start) {
-						// ENGINE_LOG("Merge after: (", range.start, ", ", range.stop, ") U (", found->start, ", ", found->stop, ")");
-						found->start = range.start;
-					} else {
-						found = parts.insert(found, range);
-					}
+			SequenceBuffer<SeqNum, WriteBlob, maxBlobs> writeBlobs;
+			SequenceBuffer<SeqNum, RecvBlob, maxBlobs> recvBlobs;
+			SequenceBuffer<SeqNum, PacketData, AckBitset::size()> pktData;
+			DynamicBufferWriter bufferWriter{nullptr};
 
-					// Merge with before
-					if (found > parts.cbegin()) {
-						auto prev = found - 1;
-						if (prev->stop == found->start) {
-							// ENGINE_LOG("Merge before: (", prev->start, ", ", prev->stop, ") U (", found->start, ", ", found->stop, ")");
-							prev->stop = found->stop;
-							parts.erase(found);
-							found = prev;
-						}
-					}
+			/** The number of sent fragments that have not been acked. */
+			int32 inFlight = 0;
+
+			/** The current retransmission timeout. @see setRetransmitTimeout */
+			Engine::Clock::Duration rto = DEFAULT_RETRANSMIT_TIMEOUT;
+
+			/** The maximum number of bytes per second this channel may send. @see setSendBandwidth */
+			float32 bandwidth = 0;
+
+			/** The estimated number of bytes per second being acked. Negative until the first sample. */
+			float32 ackRate = -1;
+
+			/** The number of bytes acked since ackRateStart. */
+			float32 ackedBytes = 0;
+
+			/** When the current ack rate sample started. Only sampled while fragments are in flight. */
+			Engine::Clock::TimePoint ackRateStart = {};
+
+			/** The number of bytes that can currently be sent. May go negative by up to one fragment. */
+			float32 budget = 0;
+			Engine::Clock::TimePoint lastBudgetUpdate = {};
+
+			ENGINE_INLINE constexpr static int32 getFragmentCount(int32 blobSize) noexcept {
+				return std::max(1, blobSize / Config.fragmentSize + (blobSize % Config.fragmentSize != 0));
+			}
+
+			ENGINE_INLINE constexpr static int32 getFragmentSize(int32 blobSize, int32 index) noexcept {
+				return std::min(Config.fragmentSize, blobSize - index * Config.fragmentSize);
+			}
+
+			/** The number of bytes per second to send at. Before the first ack rate sample this is the maximum. */
+			ENGINE_INLINE float32 getPacingRate() const noexcept {
+				if (ackRate < 0) { return bandwidth; }
+				return std::min(std::max(ackRate * pacingGain, minPacingRate), bandwidth);
+			}
+
+			/** Checks if a sent fragment is unacked and its resend delay has passed. Doubled for each resend. */
+			ENGINE_INLINE bool isResendDue(const WriteBlob& blob, int32 index, Engine::Clock::TimePoint now) const noexcept {
+				if (blob.acked.test(index)) { return false; }
+				return now - blob.sendTimes[index] >= rto * (1 << std::min(blob.sendCounts[index] - 1, maxBackoff));
+			}
+
+			/** Updates the ack rate estimate once per sample interval. */
+			void updateAckRate(Engine::Clock::TimePoint now) {
+				// Idle time says nothing about the available bandwidth so don't sample it.
+				if (inFlight == 0) {
+					ackRateStart = {};
+					ackedBytes = 0;
+					return;
 				}
-			};
 
-			// TODO: MAX_BLOBS is actually a bottleneck atm. If any blobs fit within one packet,
-			//       then we are still limited by MAX_BLOBS even though we might be able to do more writes
-			//       to the Base channel.
-			constexpr static int MAX_BLOBS = 8; // TODO: this should be configurable
-			SequenceBuffer<SeqNum, WriteBlob, MAX_BLOBS> writeBlobs;
-			SequenceBuffer<SeqNum, RecvBlob, MAX_BLOBS> recvBlobs;
-			DynamicBufferWriter bufferWriter{nullptr};
+				if (ackRateStart == Engine::Clock::TimePoint{}) {
+					ackRateStart = now;
+					ackedBytes = 0;
+					return;
+				}
 
-			struct BlobHeader {
-				// TODO: rework this, super sloppy.
-				
-				// The first bit of the length field is used to indicate the first/initial part of a blob.
-				constexpr static int32 LEN_MASK = 0x7FFFFFFF;
+				const auto elapsed = now - ackRateStart;
+				if (elapsed < ackRateInterval) { return; }
 
-				// 4 bytes start
-				// 2 bytes seqnum
-				byte data[4 + 2];
+				const auto sample = ackedBytes / Engine::Clock::Seconds{elapsed}.count();
+				ackRate = ackRate < 0 ? sample : ackRate + (sample - ackRate) * 0.25f;
+				ackRateStart = now;
+				ackedBytes = 0;
+			}
 
-				int32& start() { return *reinterpret_cast<int32*>(data); }
-				const int32& start() const { return const_cast<BlobHeader*>(this)->start(); }
+			/**
+			 * Attempts to write a fragment to the packet.
+			 * @return False if there is no more room in the packet or bandwidth budget.
+			 */
+			bool writeFragment(PacketData& pkt, StaticBufferWriter& buff, WriteBlob& blob, SeqNum seq, int32 index, Engine::Clock::TimePoint now) {
+				if (budget <= 0 || pkt.fragments.full()) { return false; }
+
+				const auto blobSize = static_cast<int32>(blob.data.size());
+				const auto len = getFragmentSize(blobSize, index);
+				const auto total = sizeof(MessageHeader) + sizeof(FragmentHeader) + len;
+				if (buff.space() < total) { return false; }
+
+				buff.write(MessageHeader{
+					.type = blob.type,
+					.size = static_cast<uint16>(sizeof(FragmentHeader) + len),
+					.seq = seq,
+				});
+				buff.write(FragmentHeader{
+					.blobSize = blobSize,
+					.index = index,
+				});
+				if (len > 0) {
+					buff.write(blob.data.data() + index * Config.fragmentSize, len);
+				}
 
-				SeqNum& seq() { return *reinterpret_cast<SeqNum*>(data + 4); }
-				const SeqNum& seq() const { return const_cast<BlobHeader*>(this)->seq(); }
-			};
-			static_assert(sizeof(BlobHeader) == 4 + 2);
+				blob.sendTimes[index] = now;
+				blob.sendCounts[index] = static_cast<uint8>(std::min(blob.sendCounts[index] + 1, 255));
+				pkt.fragments.push_back({seq, index});
+				budget -= static_cast<float32>(total);
+				return true;
+			}
 
 		public:
 			template<class Channel>
 			[[nodiscard]]
 			auto beginMessage(Channel& channel, MessageType type, StaticBufferWriter& /*buff*/) {
-				// We need to grab the canWrite state before we insert the write blob.
-				// TODO: Shouldn't this use canInsert? What is the difference?
-				const bool canWrite = !writeBlobs.entryAt(nextBlob);
+				// Blobs may finish out of order so limit the span instead of the count. The
+				// receiver only accepts blobs within maxBlobs of the next one it will deliver.
+				const bool canWrite = Math::Seq::less(nextBlob, writeBlobs.minValid() + maxBlobs);
 
 				if (canWrite) {
-					auto& blob = writeBlobs.insert(nextBlob);
+					auto& blob = writeBlobs.insertNoInit(nextBlob);
 					blob.type = type;
+					blob.data.clear();
+					blob.fragmentCount = 0; // Set once sending starts. We don't know the size yet.
+					blob.nextFragment = 0;
+					blob.firstUnacked = 0;
 					bufferWriter.reset(&blob.data);
 					++nextBlob;
 				}
@@ -552,160 +877,188 @@ namespace Engine::Net {
 				bufferWriter.reset(nullptr);
 			}
 
-			bool recv(const MessageHeader& hdr, const BufferReader& buff) {
-				if (recvData.canInsert(hdr.seq) && !recvData.contains(hdr.seq)) {
-					recvData.insert(hdr.seq);
+			bool recv(const MessageHeader& hdr, BufferReader buff) {
+				FragmentHeader frag;
+				if (!buff.read(&frag)) {
+					ENGINE_WARN2("Unable to read blob fragment header.");
+					return false;
+				}
 
-					const byte* dataBegin = buff.peek();
-
-					// Read the blob header. The blob header is only used for assembling parts so we
-					// do not include it in the assembled message data.
-					// TODO: cant just reinterpret, should memcpy, possible alignment issues
-					const auto& info = *reinterpret_cast<const BlobHeader*>(dataBegin);
-					dataBegin += sizeof(BlobHeader);
-
-					// Prepend the a MessageHeader if this is the first part of this message. The
-					// message header details are populated in recvNext because we don't know the
-					// final details until we have all parts of the message.
-					auto found = recvBlobs.find(info.seq());
-					if (found == nullptr) {
-						found = &recvBlobs.insert(info.seq());
-						MessageHeader fake{
-							.type = hdr.type,
-						};
-						found->insert(
-							-static_cast<int32>(sizeof(fake)),
-							reinterpret_cast<byte*>(&fake),
-							reinterpret_cast<byte*>(&fake) + sizeof(fake)
-						);
-					}
+				// Already delivered or too far ahead to be valid.
+				if (Math::Seq::less(hdr.seq, nextRecvSeq) || !Math::Seq::less(hdr.seq, nextRecvSeq + maxBlobs)) {
+					return false;
+				}
 
-					// If this is the first part of a blob read the final total message length.
-					if (info.start() & ~BlobHeader::LEN_MASK) {
-						// TODO: cant just reinterpret, should memcpy, possible alignment issues
-						found->total = *reinterpret_cast<const int32*>(dataBegin);
-						dataBegin += sizeof(found->total);
-					}
+				// Validate the size before using it so the fragment math can't overflow.
+				const auto len = static_cast<int32>(buff.remaining());
+				if (frag.blobSize < 0 || frag.blobSize >= MAX_MESSAGE_BLOB_SIZE) {
+					ENGINE_WARN2("Invalid blob fragment size: {}", frag.blobSize);
+					return false;
+				}
+
+				const auto count = getFragmentCount(frag.blobSize);
+				if (frag.index < 0 || frag.index >= count || len != getFragmentSize(frag.blobSize, frag.index)) {
+					ENGINE_WARN2("Invalid blob fragment (size: {}, index: {}, len: {})", frag.blobSize, frag.index, len);
+					return false;
+				}
+
+				auto* blob = recvBlobs.find(hdr.seq);
+				if (!blob) {
+					blob = &recvBlobs.insertNoInit(hdr.seq);
+					blob->data.resize(sizeof(MessageHeader) + frag.blobSize);
+					reinterpret_cast<MessageHeader*>(blob->data.data())->type = hdr.type;
+					blob->received.reset(count);
+					blob->remaining = count;
+				} else if (blob->data.size() != sizeof(MessageHeader) + frag.blobSize) {
+					ENGINE_WARN2("Mismatched blob fragment size.");
+					return false;
+				}
+
+				if (blob->received.test(frag.index)) { return false; }
+				blob->received.set(frag.index);
+				--blob->remaining;
 
-					// Append the blob part data.
-					const auto dataEnd = buff.end();
-					//ENGINE_INFO("Recv blob part: ", info.seq(), " ", dataEnd - dataBegin, " ", info.start() & BlobHeader::LEN_MASK);
-					found->insert(info.start() & BlobHeader::LEN_MASK, dataBegin, dataEnd);
+				if (len > 0) {
+					memcpy(blob->data.data() + sizeof(MessageHeader) + frag.index * Config.fragmentSize, buff.peek(), len);
 				}
 
 				return false;
 			}
 
-			void attemptWriteBlob(StaticBufferWriter& buff, SeqNum seq) {
-				auto* blob = writeBlobs.find(seq);
-				if (!blob) { return; }
-
-				while (Base::canWriteMessage()) {
-					if (blob->remaining() == 0) { return; }
+			void fill(SeqNum pktSeq, StaticBufferWriter& buff) {
+				const auto now = Engine::Clock::now();
+				updateAckRate(now);
 
-					// TODO: this should be configurable some where
-					// Always leave some room for other messages.
-					constexpr static int32 maxPacketUsage = sizeof(Packet::body) - 128;
-					const auto space = std::min(maxPacketUsage, std::max(0,
-						static_cast<int32>(buff.space())
-						- static_cast<int32>(sizeof(MessageHeader))
-						- static_cast<int32>(sizeof(BlobHeader))
-						- static_cast<int32>(sizeof(int32)) // Optional size field
-					));
+				const auto rate = getPacingRate();
+				budget += Engine::Clock::Seconds{now - lastBudgetUpdate}.count() * rate;
+				budget = std::min(budget, std::max(rate * maxBurstTime, static_cast<float32>(Config.fragmentSize)));
+				lastBudgetUpdate = now;
 
-					if (space < 32) { // Arbitrary minimum data size
-						return;
-					}
+				if (budget <= 0 || writeBlobs.span() == 0) { return; }
 
-					// We need to use an alias because beginMessage expects an "empty" buffer
-					auto alias = buff.alias();
-					if (auto msg = Base::beginMessage(*static_cast<Base*>(this), blob->type, alias)) {
-						BlobHeader head;
-						head.start() = blob->curr | (blob->curr > 0 ? 0 : ~BlobHeader::LEN_MASK);
-						head.seq() = seq;
-						msg.write(head);
-
-						// If this is the first part of the blob, also include the final total message length.
-						if (blob->curr == 0) {
-							msg.write(static_cast<int32>(blob->data.size()));
-						}
+				// May be called multiple times for the same packet. @see Channel_Base::fill
+				auto* found = pktData.find(pktSeq);
+				if (!found) {
+					found = &pktData.insertNoInit(pktSeq);
+					found->fragments.clear();
+				}
+				auto& pkt = *found;
 
-						const int32 len = std::min(space, blob->remaining());
-						msg.write(blob->data.data() + blob->curr, len);
-						//ENGINE_INFO("Write blob part: ", head.seq(), " = ", seq, " ", len);
-						blob->curr += len;
-						++blob->parts;
-						buff.advance(alias.size());
+				const auto stop = writeBlobs.max() + 1;
+				bool full = false;
 
-						// TODO: If we have written the whole blob to the base at this point, we
-						//       should be good to go ahead an discard the blob so we can free up
-						//       the write slot. This would allow better throughput if any blobs fit
-						//       within a single message. If we could then do an attemptWriteBlob in
-						//       the endMessage, it would solve the MAX_BLOBS bottleneck issue.
+				// Resend expired fragments first, oldest blobs first, so blobs complete in order.
+				for (auto seq = writeBlobs.minValid(); !full && Math::Seq::less(seq, stop); ++seq) {
+					auto* blob = writeBlobs.find(seq);
+					if (!blob) { continue; }
 
-					} else {
-						ENGINE_DEBUG_ASSERT(false, "Unable to write to underlying channel. This should not occur.");
+					for (int32 i = blob->firstUnacked; i < blob->nextFragment; ++i) {
+						if (!isResendDue(*blob, i, now)) { continue; }
+						if (!writeFragment(pkt, buff, *blob, seq, i, now)) { full = true; break; }
 					}
 				}
-			}
 
-			void fill(SeqNum pktSeq, StaticBufferWriter& buff) {
-				for (auto seq = writeBlobs.minValid(); Math::Seq::less(seq, writeBlobs.max() + 1); ++seq) {
-					attemptWriteBlob(buff, seq);
-				}
+				// Then send new fragments while the window allows.
+				for (auto seq = writeBlobs.minValid(); !full && Math::Seq::less(seq, stop); ++seq) {
+					auto* blob = writeBlobs.find(seq);
+					if (!blob) { continue; }
+
+					if (blob->fragmentCount == 0) {
+						blob->fragmentCount = getFragmentCount(static_cast<int32>(blob->data.size()));
+						blob->unacked = blob->fragmentCount;
+						blob->acked.reset(blob->fragmentCount);
+						blob->sendTimes.resize(blob->fragmentCount);
+						blob->sendCounts.assign(blob->fragmentCount, 0);
+					}
 
-				Base::fill(pktSeq, buff);
-			}
+					while (blob->nextFragment < blob->fragmentCount) {
+						if (inFlight >= Config.window || !writeFragment(pkt, buff, *blob, seq, blob->nextFragment, now)) {
+							full = true;
+							break;
+						}
 
-			const MessageHeader* recvNext() {
-				for (auto seq = recvBlobs.minValid(); Math::Seq::less(seq, recvBlobs.max() + 1); ++seq) {
-					auto* blob = recvBlobs.find(seq);
-
-					if (blob && blob->complete()) {
-						recvBlobs.remove(seq);
-						auto head = reinterpret_cast<MessageHeader*>(blob->data.data());
-						head->size = blob->total;
-						head->seq = seq;
-						return head;
+						++blob->nextFragment;
+						++inFlight;
 					}
 				}
 
-				return nullptr;
+				if (pkt.fragments.empty()) {
+					pktData.remove(pktSeq);
+				}
+			}
+
+			const MessageHeader* recvNext() {
+				auto* blob = recvBlobs.find(nextRecvSeq);
+				if (!blob || blob->remaining != 0) { return nullptr; }
+
+				// The data stays valid until the slot is reused.
+				recvBlobs.remove(nextRecvSeq);
+				auto* head = reinterpret_cast<MessageHeader*>(blob->data.data());
+				head->size = static_cast<uint16>(blob->data.size() - sizeof(MessageHeader));
+				head->seq = nextRecvSeq;
+				++nextRecvSeq;
+				return head;
 			}
 
 			void recvPacketAck(SeqNum pktSeq) {
-				// TODO: why did we inherit. This is dumb.
-				auto* pkt = Base::pktData.find(pktSeq);
+				auto* pkt = pktData.find(pktSeq);
 				if (!pkt) { return; }
 
-				for (SeqNum s : pkt->messages) {
-					if (auto* data = Base::msgData.find(s)) {
-						Base::msgData.remove(s);
-
-						// Now remove blobs
-						const byte* start = data->data.data();
-						start += sizeof(MessageHeader);
-
-						const auto* head = reinterpret_cast<const BlobHeader*>(start);
-						const auto seq = head->seq();
-
-						auto* blob = writeBlobs.find(seq);
-						if (blob) {
-							--blob->parts;
-							// ENGINE_INFO("Blob part ack: ", pktSeq, " ", s, " ", seq, " ", blob->parts);
-							if (blob->parts == 0 && blob->remaining() == 0) {
-								writeBlobs.remove(seq);
-								//ENGINE_SUCCESS2("Blob complete! {}", seq);
-							}
-						} else {
-							// This shouldn't happen?
-							ENGINE_ASSERT(false, "Blob not found! ", seq);
-							ENGINE_DIE;
-						}
+				for (const auto& frag : pkt->fragments) {
+					auto* blob = writeBlobs.find(frag.blob);
+					if (!blob || blob->acked.test(frag.index)) { continue; }
+
+					blob->acked.set(frag.index);
+					--blob->unacked;
+					--inFlight;
+					ackedBytes += static_cast<float32>(getFragmentSize(static_cast<int32>(blob->data.size()), frag.index));
+
+					while (blob->firstUnacked < blob->fragmentCount && blob->acked.test(blob->firstUnacked)) {
+						++blob->firstUnacked;
+					}
+
+					if (blob->unacked == 0) {
+						writeBlobs.remove(frag.blob);
 					}
 				}
 
-				Base::pktData.remove(pktSeq);
+				pktData.remove(pktSeq);
+			}
+
+			ENGINE_INLINE void setRetransmitTimeout(Engine::Clock::Duration rto) noexcept {
+				this->rto = rto;
+			}
+
+			ENGINE_INLINE void setSendBandwidth(float32 bytesPerSecond) noexcept {
+				bandwidth = bytesPerSecond * (Config.bandwidthPercent / 100.0f);
+			}
+
+			int32 getQueueSize() const noexcept {
+				return writeBlobs.span();
+			}
+
+			/** Expired fragments and new fragments the window allows, or zero while pacing. */
+			int32 getSendableSize() const noexcept {
+				const auto now = Engine::Clock::now();
+				if (budget + Engine::Clock::Seconds{now - lastBudgetUpdate}.count() * getPacingRate() <= 0) { return 0; }
+
+				int64 size = 0;
+				int32 window = Config.window - inFlight;
+				for (auto seq = writeBlobs.minValid(); Math::Seq::less(seq, writeBlobs.max() + 1); ++seq) {
+					const auto* blob = writeBlobs.find(seq);
+					if (!blob) { continue; }
+
+					const auto blobSize = static_cast<int32>(blob->data.size());
+					for (int32 i = blob->firstUnacked; i < blob->nextFragment; ++i) {
+						if (isResendDue(*blob, i, now)) { size += getFragmentSize(blobSize, i); }
+					}
+
+					const auto count = getFragmentCount(blobSize);
+					for (int32 i = blob->nextFragment; i < count && window > 0; ++i, --window) {
+						size += getFragmentSize(blobSize, i);
+					}
+				}
+				return static_cast<int32>(std::min<int64>(size, std::numeric_limits<int32>::max()));
 			}
 	};
 }
@@ -1,13 +1,20 @@
 #pragma once
 
+// STD
+#include <array>
+#include <cmath>
+#include <cstring>
+
 // Meta
 #include <Meta/IndexOf.hpp>
 
 // Engine
 #include <Engine/Clock.hpp>
 #include <Engine/Net/BufferWriter.hpp>
+#include <Engine/Net/Channel.hpp>
 #include <Engine/Net/net.hpp>
 #include <Engine/Net/Packet.hpp>
+#include <Engine/Net/PacketCodec.hpp>
 #include <Engine/Net/UDPSocket.hpp>
 #include <Engine/SequenceBuffer.hpp>
 
@@ -25,8 +32,12 @@ namespace Engine::Net {
 			using ChannelId = uint8;
 
 			const IPv4Address addr = {};
-			uint16 keyLocal = 0;
-			uint16 keyRemote = 0;
+
+			/** The key the remote puts in packets sent to us. Zero if none has been assigned yet. */
+			uint32 keyLocal = 0;
+
+			/** The key we put in packets sent to the remote. Zero if none has been assigned yet. */
+			uint32 keyRemote = 0;
 
 			struct PacketData {
 				Engine::Clock::TimePoint sendTime;
@@ -37,6 +48,17 @@ namespace Engine::Net {
 			byte msgBuffer[sizeof(Packet::body)];
 			StaticBufferWriter msgBufferWriter{msgBuffer};
 
+			/** Used to decompress received packets and, if enabled, compress sent packets. */
+			const PacketCodec* codec = nullptr;
+			bool compressSend = false;
+
+			/** Total packet body bytes before and after compression. Only includes compressed packets. */
+			uint64 codecBytesIn = 0;
+			uint64 codecBytesOut = 0;
+
+			/** The body of the last received packet if it was compressed. */
+			byte recvBuffer[sizeof(Packet::body)];
+
 			/** How many packets per second we can send */
 			float32 packetSendRate = 16.0f;
 
@@ -52,15 +74,32 @@ namespace Engine::Net {
 			/** The next recv ack we are expecting */
 			SeqNum nextRecvAck = {};
 
-			/** Acks for the prev N packets before nextRecvAck */
+			/** Acks for the prev N packets before nextRecvAck. Bit N is the ack for `nextRecvAck - 1 - N`. */
 			AckBitset recvAcks = {};
 
+			/**
+			 * How long each received packet should be acked for. Determines how
+			 * many ack words are sent based on the rate we receive packets at.
+			 * A packet is only known to be lost once it leaves this window.
+			 */
+			constexpr static float32 ackWindowTime = 1.0f;
+
 			constexpr static float64 pingSmoothing = 0.02;
 			Engine::Clock::Duration ping = std::chrono::milliseconds{50};
 			
 			constexpr static float64 jitterSmoothing = 0.02;
 			Engine::Clock::Duration jitter = {};
 
+			// Retransmission timeout estimate. See RFC 6298.
+			// Separate from ping/jitter since it needs to react much faster.
+			constexpr static float64 srttSmoothing = 1.0 / 8.0;
+			constexpr static float64 rttvarSmoothing = 1.0 / 4.0;
+			constexpr static Engine::Clock::Duration minRetransmitTimeout = std::chrono::milliseconds{20};
+			constexpr static Engine::Clock::Duration maxRetransmitTimeout = std::chrono::milliseconds{1000};
+			Engine::Clock::Duration srtt = {};
+			Engine::Clock::Duration rttvar = {};
+			Engine::Clock::Duration rto = DEFAULT_RETRANSMIT_TIMEOUT;
+
 			constexpr static float32 lossSmoothing = 0.01f;
 			float32 loss = {};
 
@@ -70,6 +109,8 @@ namespace Engine::Net {
 			float32 packetSentBandwidthAccum = 0;
 			float32 packetRecvBandwidth = 0;
 			float32 packetRecvBandwidthAccum = 0;
+			float32 packetRecvFrequency = 0;
+			float32 packetRecvCountAccum = 0;
 			uint32 packetTotalBytesSent = 0;
 			uint32 packetTotalBytesRecv = 0;
 
@@ -79,8 +120,25 @@ namespace Engine::Net {
 			// TODO: really this might be better as part of a subclass, nothing in here actually uses state other than debug checks.
 			ConnectionState state = {};
 
-			// TODO: channel - float32 sendBandwidth[sizeof...(Cs)] = {};
-			// TODO: channel - float32 recvBandwidth[sizeof...(Cs)] = {};
+			/** Per channel bytes per second, excluding packet headers. Same smoothing as the totals above. */
+			std::array<float32, sizeof...(Cs)> channelSendBandwidth = {};
+			std::array<float32, sizeof...(Cs)> channelRecvBandwidth = {};
+			std::array<float32, sizeof...(Cs)> channelSentAccum = {};
+			std::array<float32, sizeof...(Cs)> channelRecvAccum = {};
+			std::array<uint64, sizeof...(Cs)> channelTotalBytesSent = {};
+			std::array<uint64, sizeof...(Cs)> channelTotalBytesRecv = {};
+
+			/** How packet space is shared between channels. @see fillPacket */
+			std::array<ChannelSchedule, sizeof...(Cs)> channelSchedules = {Cs::schedule...};
+
+			/**
+			 * The number of bytes each channel may still write before it has used
+			 * its weighted share. Negative if it has used more than its share.
+			 */
+			std::array<float32, sizeof...(Cs)> channelDeficit = {};
+
+			/** The channel that gets first use of the next packet. Rotated so no channel is always last. */
+			ChannelId nextFirstChannel = 0;
 
 			struct {
 				/** The time the message was received */
@@ -132,6 +190,87 @@ namespace Engine::Net {
 				})(std::make_integer_sequence<MessageType, maxMessageType() + 1>{});
 			}
 
+			/**
+			 * Fills a channel using at most @p limit bytes of @p buff.
+			 * @return The number of bytes written.
+			 */
+			template<class C>
+			int32 fillChannel(SeqNum seq, StaticBufferWriter& buff, int64 limit) {
+				limit = std::min<int64>(limit, buff.space());
+				if (limit <= 0) { return 0; }
+
+				StaticBufferWriter view{buff.end(), static_cast<uintz>(limit)};
+				getChannel<C>().fill(seq, view);
+				buff.advance(view.size());
+
+				const auto used = static_cast<int32>(view.size());
+				channelSentAccum[getChannelId<C>()] += used;
+				return used;
+			}
+
+			/**
+			 * Fills a packet from all channels using weighted fair queuing.
+			 *
+			 * Each channel with data first gets its minimum share of the packet.
+			 * The remaining space is split using deficit round robin: every
+			 * channel with data earns its weighted share of a packet and may
+			 * spend what it has earned. Any space left over after that is given
+			 * to whichever channels can use it so we never send a partially empty
+			 * packet while data is waiting.
+			 *
+			 * A channel only has data if it could send something now. Messages
+			 * waiting on an ack don't count so those channels don't earn deficit
+			 * they can't spend. @see Channel_Base::getSendableSize
+			 */
+			void fillPacket(SeqNum seq, StaticBufferWriter& buff) {
+				using FillFunc = int32(Connection::*)(SeqNum, StaticBufferWriter&, int64);
+				constexpr FillFunc fills[] = {&Connection::fillChannel<Cs>...};
+				constexpr auto count = static_cast<ChannelId>(getChannelCount());
+				const auto total = static_cast<float32>(buff.capacity());
+
+				const bool active[] = {(getChannel<Cs>().getSendableSize() > 0)...};
+				float32 weightSum = 0;
+				for (ChannelId i = 0; i < count; ++i) {
+					if (active[i]) {
+						weightSum += channelSchedules[i].weight;
+					} else {
+						// Idle channels don't get to save up bandwidth.
+						channelDeficit[i] = std::min(channelDeficit[i], 0.0f);
+					}
+				}
+
+				const auto fill = [&](ChannelId i, float32 limit) ENGINE_INLINE {
+					const auto used = (this->*fills[i])(seq, buff, static_cast<int64>(limit));
+					channelDeficit[i] = std::max(channelDeficit[i] - used, -total);
+				};
+
+				const auto first = nextFirstChannel;
+				nextFirstChannel = (nextFirstChannel + 1) % count;
+
+				for (ChannelId n = 0; n < count; ++n) {
+					const auto i = static_cast<ChannelId>((first + n) % count);
+					if (active[i] && channelSchedules[i].minShare > 0) {
+						fill(i, channelSchedules[i].minShare * total);
+					}
+				}
+
+				if (weightSum > 0) {
+					for (ChannelId n = 0; n < count; ++n) {
+						const auto i = static_cast<ChannelId>((first + n) % count);
+						if (!active[i]) { continue; }
+
+						channelDeficit[i] = std::min(channelDeficit[i] + channelSchedules[i].weight / weightSum * total, total);
+						if (channelDeficit[i] > 0) {
+							fill(i, channelDeficit[i]);
+						}
+					}
+				}
+
+				for (ChannelId n = 0; n < count && buff.space() > 0; ++n) {
+					fill(static_cast<ChannelId>((first + n) % count), total);
+				}
+			}
+
 		public:
 			ENGINE_DEBUG_ONLY(bool _debug_AllowMessages = true);
 
@@ -156,11 +295,59 @@ namespace Engine::Net {
 			ENGINE_INLINE auto getPing() const noexcept { return ping; }
 			ENGINE_INLINE auto getLoss() const noexcept { return loss; }
 			ENGINE_INLINE auto getJitter() const noexcept { return jitter; }
+			ENGINE_INLINE auto getRetransmitTimeout() const noexcept { return rto; }
 			ENGINE_INLINE auto getSendBandwidth() const noexcept { return packetSendBandwidth; }
 			ENGINE_INLINE auto getRecvBandwidth() const noexcept { return packetRecvBandwidth; }
 			ENGINE_INLINE auto getTotalBytesSent() const noexcept { return packetTotalBytesSent; }
 			ENGINE_INLINE auto getTotalBytesRecv() const noexcept { return packetTotalBytesRecv; }
 
+			/** Per channel send bandwidth in bytes per second. Indexed in the same order as the channels. */
+			ENGINE_INLINE const auto& getChannelSendBandwidth() const noexcept { return channelSendBandwidth; }
+			ENGINE_INLINE const auto& getChannelRecvBandwidth() const noexcept { return channelRecvBandwidth; }
+			ENGINE_INLINE const auto& getChannelTotalBytesSent() const noexcept { return channelTotalBytesSent; }
+			ENGINE_INLINE const auto& getChannelTotalBytesRecv() const noexcept { return channelTotalBytesRecv; }
+
+			template<class C>
+			ENGINE_INLINE const ChannelSchedule& getChannelSchedule() const noexcept { return channelSchedules[getChannelId<C>()]; }
+
+			/**
+			 * Changes how a channel shares packet space with other channels.
+			 * The sum of all minimum shares should not exceed one.
+			 */
+			template<class C>
+			void setChannelSchedule(const ChannelSchedule& sched) noexcept {
+				ENGINE_DEBUG_ASSERT(sched.weight > 0, "Channel weight must be positive.");
+				ENGINE_DEBUG_ASSERT(0 <= sched.minShare && sched.minShare <= 1, "Channel minimum share must be in [0, 1].");
+				channelSchedules[getChannelId<C>()] = sched;
+			}
+
+			/**
+			 * Sets the codec used for compressed packets. Received packets are
+			 * only decompressed if a codec is set. Sent packets are only compressed
+			 * if compression has also been enabled. @see setPacketCompression
+			 */
+			ENGINE_INLINE void setPacketCodec(const PacketCodec* c) noexcept { codec = c; compressSend = compressSend && c; }
+			ENGINE_INLINE const PacketCodec* getPacketCodec() const noexcept { return codec; }
+
+			/** The id of the current codec or zero if there is none. */
+			ENGINE_INLINE uint32 getPacketCodecId() const noexcept { return codec ? codec->getId() : 0; }
+
+			/**
+			 * Enables compression of sent packets. Should only be enabled once the
+			 * remote has confirmed it uses the same codec. Packets are still sent
+			 * uncompressed if compression does not reduce their size.
+			 */
+			ENGINE_INLINE void setPacketCompression(bool enabled) noexcept {
+				ENGINE_DEBUG_ASSERT(!enabled || codec, "Attempting to enable compression without a codec.");
+				compressSend = enabled && codec;
+			}
+			ENGINE_INLINE bool getPacketCompression() const noexcept { return compressSend; }
+
+			/** The ratio of compressed to uncompressed size for sent packets. */
+			ENGINE_INLINE float32 getCompressionRatio() const noexcept {
+				return codecBytesIn ? static_cast<float32>(codecBytesOut) / codecBytesIn : 1.0f;
+			}
+
 			ENGINE_INLINE void setKeyLocal(decltype(keyLocal) keyLocal) noexcept { this->keyLocal = keyLocal; }
 			ENGINE_INLINE auto getKeyLocal() const noexcept { return keyLocal; }
 
@@ -176,38 +363,73 @@ namespace Engine::Net {
 			ENGINE_INLINE ConnectionState getState() const noexcept { return state; }
 			ENGINE_INLINE void setState(ConnectionState s) noexcept { state = s; }
 
-			// TODO: why does this have a return value? isnt it always true?
+			/**
+			 * Reads the header of a received packet. Messages are then read with recvNext.
+			 * @return False if the packet could not be read and should be ignored.
+			 */
 			[[nodiscard]]
 			bool recv(const Packet& pkt, int32 sz, Engine::Clock::TimePoint time) {
+				if (sz <= static_cast<int32>(sizeof(pkt.head))) {
+					ENGINE_WARN("Received packet without a body.");
+					return false;
+				}
+
+				AckBitset acks;
+				const auto bodySize = pkt.readAcks(acks, sz - static_cast<int32>(sizeof(pkt.head)));
+				if (bodySize <= 0) {
+					ENGINE_WARN("Received packet with invalid acks.");
+					return false;
+				}
+
 				rdat2.time = time;
 				rdat2.curr = pkt.body;
-				rdat2.last = pkt.head + sz;
-				ENGINE_DEBUG_ASSERT(sz > 0);
-				ENGINE_DEBUG_ASSERT(rdat2.curr < rdat2.last);
-
-				const auto& acks = pkt.getAcks();
-				const auto seq = pkt.getSeqNum();
-				packetRecvBandwidthAccum += sz;
+				rdat2.last = pkt.body + bodySize;
 
-				// Update recv packet info
-				do { 
-					const auto min = nextRecvAck - acks.size();
-					if (Math::Seq::less(seq, min))  { continue; }
+				if (pkt.getFlags() & PacketFlag::Compressed) {
+					if (!codec) {
+						ENGINE_WARN("Received compressed packet without a codec.");
+						rdat2.curr = rdat2.last;
+						return false;
+					}
 
-					while (Math::Seq::less(nextRecvAck, seq + 1)) {
-						recvAcks.reset(++nextRecvAck  % recvAcks.size());
+					const auto len = codec->decompress({rdat2.curr, rdat2.last}, recvBuffer);
+					if (len <= 0) {
+						ENGINE_WARN("Unable to decompress packet.");
+						rdat2.curr = rdat2.last;
+						return false;
 					}
 
-					recvAcks.set(seq % recvAcks.size());
-				} while(0);
+					rdat2.curr = recvBuffer;
+					rdat2.last = recvBuffer + len;
+				}
+
+				const auto seq = pkt.getSeqNum();
+				packetRecvBandwidthAccum += sz;
+				packetRecvCountAccum += 1;
+
+				// Update recv packet info. All arithmetic is done in SeqNum so it wraps correctly.
+				if (!Math::Seq::less(seq, nextRecvAck)) {
+					const auto shift = static_cast<SeqNum>(seq + 1 - nextRecvAck);
+					if (shift >= AckBitset::size()) {
+						recvAcks.reset();
+					} else {
+						recvAcks <<= shift;
+					}
+					recvAcks.set(0);
+					nextRecvAck = seq + 1;
+				} else if (const auto age = static_cast<SeqNum>(nextRecvAck - 1 - seq); age < AckBitset::size()) {
+					recvAcks.set(static_cast<AckBitset::SizeType>(age));
+				}
 
 				// Update sent packet info
 				{
-					const auto& next = pkt.getNextAck();
-					const SeqNum min = next - AckBitset::size();
-					for (auto s = min; Math::Seq::less(s, next); ++s) {
-						if (!acks.test(s % acks.size())) { continue; }
+					bool rttSampled = false;
+					const auto next = pkt.getNextAck();
+					const auto count = static_cast<AckBitset::SizeType>(pkt.getAckWordCount() * Packet::ackWordBits);
+					for (AckBitset::SizeType i = 0; i < count; ++i) {
+						if (!acks.test(i)) { continue; }
 
+						const auto s = static_cast<SeqNum>(next - 1 - i);
 						auto* data = packetData.find(s);
 						if (!data || data->recvTime != Engine::Clock::TimePoint{}) { continue; }
 
@@ -224,8 +446,26 @@ namespace Engine::Net {
 							(pktPing - ping) * pingSmoothing
 						);
 
+						if (srtt == Engine::Clock::Duration{}) {
+							srtt = pktPing;
+							rttvar = pktPing / 2;
+						} else {
+							rttvar += std::chrono::duration_cast<Engine::Clock::Duration>(
+								(std::chrono::abs(srtt - pktPing) - rttvar) * rttvarSmoothing
+							);
+							srtt += std::chrono::duration_cast<Engine::Clock::Duration>(
+								(pktPing - srtt) * srttSmoothing
+							);
+						}
+						rttSampled = true;
+
 						(getChannel<Cs>().recvPacketAck(s), ...);
 					}
+
+					if (rttSampled) {
+						rto = std::clamp(srtt + 4 * rttvar, minRetransmitTimeout, maxRetransmitTimeout);
+						(getChannel<Cs>().setRetransmitTimeout(rto), ...);
+					}
 				}
 
 				return true;
@@ -283,6 +523,7 @@ namespace Engine::Net {
 				bool process = true;
 				callWithChannelForMessage(view.hdr.type, [&]<class C>(){
 					auto& ch = getChannel<C>();
+					channelRecvAccum[getChannelId<C>()] += static_cast<float32>(view.msg.size());
 					process = ch.recv(view.hdr, std::as_const(view.msg));
 				});
 
@@ -291,7 +532,12 @@ namespace Engine::Net {
 				return recvNext();
 			}
 
-			void send(UDPSocket& sock) {
+			/**
+			 * Writes and queues packets on the socket. The socket must be flushed for them to be sent.
+			 * @param sock The UDPSocket or NetworkThread to queue packets on.
+			 * @see UDPSocket::flush
+			 */
+			void send(auto& sock) {
 				const auto now = Engine::Clock::now();
 
 				// Update packet budget
@@ -299,21 +545,49 @@ namespace Engine::Net {
 				packetSendBudget = std::min(packetSendBudget, packetSendRate);
 				lastBudgetUpdate = now;
 
+				(getChannel<Cs>().setSendBandwidth(packetSendRate * sizeof(Packet)), ...);
+
+				// Enough acks that each received packet is acked for ackWindowTime.
+				const auto ackWords = std::clamp(
+					static_cast<int32>(std::ceil(packetRecvFrequency * ackWindowTime / Packet::ackWordBits)),
+					1, Packet::maxAckWords
+				);
+
 				// Write + send packets
+				const bool filled = packetSendBudget >= 1;
 				while (packetSendBudget >= 1) {
 					const auto seq = nextSeqNum;
 
 					Packet pkt; // TODO: if we keep this move to be a member variable instead; - should be able to merge with msgBuffer?
 					StaticBufferWriter pktBufferWriter{pkt.body};
-					(getChannel<Cs>().fill(seq, pktBufferWriter), ...);
+					fillPacket(seq, pktBufferWriter);
 					if (pktBufferWriter.size() == 0) { break; }
 					++nextSeqNum;
 
 					pkt.setKey(keyRemote); // TODO: should just be set once after packet is changed to member variable
 					pkt.setNextAck(nextRecvAck);
-					pkt.setAcks(recvAcks);
 					pkt.setProtocol(protocol); // TODO: should just be set once after packet is changed to member variable
+					pkt.setVersion(Packet::version);
 					pkt.setSeqNum(seq);
+					pkt.setFlags(PacketFlag::None);
+
+					auto bodySize = static_cast<uintz>(pktBufferWriter.size());
+					if (compressSend) {
+						// Only use the compressed body if it is smaller.
+						byte buff[sizeof(Packet::body)];
+						const auto len = codec->compress({pkt.body, bodySize}, {buff, bodySize - 1});
+						if (len > 0) {
+							codecBytesIn += bodySize;
+							codecBytesOut += len;
+							memcpy(pkt.body, buff, len);
+							bodySize = len;
+							pkt.setFlags(PacketFlag::Compressed);
+						}
+					}
+
+					// Extended acks only use space left over after the messages.
+					const auto spareWords = static_cast<int32>(sizeof(pkt.body) - bodySize) / (Packet::ackWordBits / CHAR_BIT);
+					bodySize = pkt.writeAcks(recvAcks, std::min(ackWords, 1 + spareWords), static_cast<int32>(bodySize));
 
 					{
 						const float32 val = packetData.get(seq).recvTime == Engine::Clock::TimePoint{};
@@ -322,9 +596,9 @@ namespace Engine::Net {
 
 					packetData.insert(seq) = { .sendTime = now, };
 
-					const auto sz = sizeof(pkt.head) + pktBufferWriter.size();
+					const auto sz = sizeof(pkt.head) + bodySize;
 					packetSentBandwidthAccum += sz;
-					sock.send(&pkt, (int32)sz, addr);
+					sock.queue(&pkt, (int32)sz, addr);
 					packetSendBudget -= 1;
 				}
 
@@ -333,10 +607,25 @@ namespace Engine::Net {
 				Engine::Clock::Seconds sec = diff;
 				packetSendBandwidth += (packetSentBandwidthAccum / sec.count() - packetSendBandwidth) * bandwidthSmoothing;
 				packetRecvBandwidth += (packetRecvBandwidthAccum / sec.count() - packetRecvBandwidth) * bandwidthSmoothing;
+				packetRecvFrequency += (packetRecvCountAccum / sec.count() - packetRecvFrequency) * bandwidthSmoothing;
 				packetTotalBytesSent += static_cast<int32>(packetSentBandwidthAccum);
 				packetTotalBytesRecv += static_cast<int32>(packetRecvBandwidthAccum);
 				packetRecvBandwidthAccum = 0;
+				packetRecvCountAccum = 0;
 				packetSentBandwidthAccum = 0;
+
+				for (uintz i = 0; i < getChannelCount(); ++i) {
+					channelSendBandwidth[i] += (channelSentAccum[i] / sec.count() - channelSendBandwidth[i]) * bandwidthSmoothing;
+					channelRecvBandwidth[i] += (channelRecvAccum[i] / sec.count() - channelRecvBandwidth[i]) * bandwidthSmoothing;
+					channelTotalBytesSent[i] += static_cast<uint64>(channelSentAccum[i]);
+					channelTotalBytesRecv[i] += static_cast<uint64>(channelRecvAccum[i]);
+					channelSentAccum[i] = 0;
+					channelRecvAccum[i] = 0;
+				}
+
+				if (filled) {
+					(getChannel<Cs>().finishSend(), ...);
+				}
 			}
 
 			template<auto M>
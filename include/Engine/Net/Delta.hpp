@@ -0,0 +1,85 @@
+#pragma once
+
+// STD
+#include <type_traits>
+
+// Engine
+#include <Engine/Engine.hpp>
+#include <Engine/Net/BufferWriter.hpp>
+
+
+namespace Engine::Net {
+	/**
+	 * Field mask delta encoding for replicated state.
+	 *
+	 * A delta is a mask of the fields that differ from the previous state followed by the
+	 * value of each of those fields in order. Fields are written as raw bytes so they should
+	 * be trivially copyable.
+	 *
+	 * @tparam Fields Pointers to the members to encode, in the order they are written. At most eight.
+	 */
+	template<auto... Fields>
+	class Delta {
+		static_assert(sizeof...(Fields) > 0 && sizeof...(Fields) <= 8, "A delta must have between one and eight fields.");
+
+		public:
+			using Mask = uint8;
+
+			/**
+			 * Gets the bit used for @p Field in a Mask.
+			 */
+			template<auto Field>
+			constexpr static Mask bit() noexcept {
+				Mask result = 0;
+				Mask flag = 1;
+				([&]{
+					if constexpr (std::is_same_v<decltype(Field), decltype(Fields)>) {
+						if (Field == Fields) { result = flag; }
+					}
+					flag <<= 1;
+				}(), ...);
+				return result;
+			}
+
+			/**
+			 * Gets the fields of @p curr that differ from @p prev. If @p prev is null all fields are included.
+			 */
+			template<class T>
+			static Mask diff(const T& curr, const std::type_identity_t<T>* prev) noexcept {
+				Mask result = 0;
+				Mask flag = 1;
+				((result |= (!prev || !(curr.*Fields == prev->*Fields)) ? flag : 0, flag <<= 1), ...);
+				return result;
+			}
+
+			/**
+			 * Writes the fields of @p curr that differ from @p prev.
+			 * @return The fields that were written.
+			 */
+			template<class T>
+			static Mask write(const T& curr, const std::type_identity_t<T>* prev, StaticBufferWriter& buff) {
+				const auto fields = diff(curr, prev);
+				buff.write(fields);
+
+				Mask flag = 1;
+				((fields & flag ? (void)buff.write(curr.*Fields) : (void)0, flag <<= 1), ...);
+				return fields;
+			}
+
+			/**
+			 * Reads a delta written by write. Only the fields in @p fields are changed in @p obj.
+			 * @param fields Set to the fields that were read.
+			 * @return False if the delta could not be read.
+			 */
+			template<class T>
+			[[nodiscard]]
+			static bool read(T& obj, Mask& fields, BufferReader& buff) noexcept {
+				if (!buff.read<Mask>(&fields)) { return false; }
+
+				bool ok = true;
+				Mask flag = 1;
+				((ok = ok && (!(fields & flag) || buff.read(&(obj.*Fields))), flag <<= 1), ...);
+				return ok;
+			}
+	};
+}
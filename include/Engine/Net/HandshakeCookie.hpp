@@ -0,0 +1,55 @@
+#pragma once
+
+// Engine
+#include <Engine/Engine.hpp>
+#include <Engine/Clock.hpp>
+#include <Engine/Net/IPv4Address.hpp>
+
+
+namespace Engine::Net {
+	/**
+	 * Creates and verifies cookies for stateless connection handshakes.
+	 *
+	 * A cookie is a keyed hash (SipHash-2-4) of the remote address, the remote's
+	 * key and the current period. The server sends it in reply to a connection
+	 * request and the remote has to send it back to finish connecting. This lets
+	 * the server check that the remote can receive at its address without keeping
+	 * any state for it until then.
+	 */
+	class HandshakeCookie {
+		public:
+			/** Cookies are valid for between one and two periods. */
+			constexpr static Engine::Clock::Duration period = std::chrono::seconds{5};
+
+		private:
+			uint64 k0;
+			uint64 k1;
+
+		public:
+			/**
+			 * @param k0, k1 The secret key. Should be random.
+			 */
+			HandshakeCookie(uint64 k0, uint64 k1) noexcept
+				: k0{k0}, k1{k1} {
+			}
+
+			/**
+			 * @param time The time the cookie is created at. Can be relative to any fixed point.
+			 */
+			ENGINE_INLINE uint32 make(const IPv4Address& addr, uint32 key, Engine::Clock::Duration time) const noexcept {
+				return make(addr, key, time / period);
+			}
+
+			/**
+			 * Checks if @p cookie was created for @p addr and @p key in this or the previous period.
+			 * @param time The current time. Must be relative to the same point as used with make.
+			 */
+			ENGINE_INLINE bool verify(uint32 cookie, const IPv4Address& addr, uint32 key, Engine::Clock::Duration time) const noexcept {
+				const auto p = time / period;
+				return cookie == make(addr, key, p) || cookie == make(addr, key, p - 1);
+			}
+
+		private:
+			uint32 make(const IPv4Address& addr, uint32 key, int64 p) const noexcept;
+	};
+}
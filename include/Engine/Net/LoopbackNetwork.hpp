@@ -0,0 +1,86 @@
+#pragma once
+
+// STD
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+// Engine
+#include <Engine/Engine.hpp>
+#include <Engine/Clock.hpp>
+#include <Engine/FlatHashMap.hpp>
+#include <Engine/Net/IPv4Address.hpp>
+
+
+namespace Engine::Net {
+	/**
+	 * An in-memory datagram network for endpoints in the same process.
+	 *
+	 * Endpoints are identified by port and all use the address 127.0.0.1.
+	 * Delivery is reliable and in order unless an endpoint's queue is full, in
+	 * which case datagrams are dropped like a full socket buffer would.
+	 * Safe to use from multiple threads.
+	 *
+	 * @see UDPSocket::UDPSocket(LoopbackNetwork&, uint16)
+	 */
+	class LoopbackNetwork {
+		public:
+			/** The address used by all loopback endpoints. */
+			constexpr static IPv4Address address(uint16 port) noexcept { return {127, 0, 0, 1, port}; }
+
+			/** The maximum number of datagrams waiting to be received by each endpoint. */
+			constexpr static uintz maxQueued = 4096;
+
+		private:
+			class Entry {
+				public:
+					IPv4Address from;
+					std::vector<byte> data;
+			};
+
+			class Endpoint {
+				public:
+					std::mutex mutex;
+					std::condition_variable cond;
+					std::deque<Entry> queue;
+
+					/** Previously used buffers so we don't allocate for every datagram. */
+					std::vector<std::vector<byte>> spare;
+			};
+
+			std::mutex mutex;
+			Engine::FlatHashMap<uint16, std::shared_ptr<Endpoint>> endpoints;
+			uint16 nextPort = 49152;
+
+			std::shared_ptr<Endpoint> find(uint16 port);
+
+		public:
+			/**
+			 * Creates an endpoint.
+			 * @param port The port to use. Zero to pick an unused port.
+			 * @return The port used or zero if @p port is already in use.
+			 */
+			uint16 bind(uint16 port);
+			void unbind(uint16 port);
+
+			/**
+			 * Queues a datagram for the endpoint at @p to.
+			 * @return True if the datagram was queued.
+			 */
+			bool send(uint16 from, const IPv4Address& to, const void* data, int32 size);
+
+			/**
+			 * Receives a datagram without blocking.
+			 * @return The size of the received datagram or -1 if none is available.
+			 */
+			int32 recv(uint16 port, void* data, int32 size, IPv4Address& from);
+
+			/**
+			 * Waits until a datagram is available or the timeout expires.
+			 * @return True if a datagram is available.
+			 */
+			bool wait(uint16 port, Engine::Clock::Duration timeout);
+	};
+}
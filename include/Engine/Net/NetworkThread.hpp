@@ -0,0 +1,112 @@
+#pragma once
+
+// STD
+#include <atomic>
+#include <mutex>
+#include <thread>
+
+// Engine
+#include <Engine/Engine.hpp>
+#include <Engine/Clock.hpp>
+#include <Engine/SPSCQueue.hpp>
+#include <Engine/Net/Packet.hpp>
+#include <Engine/Net/UDPSocket.hpp>
+
+
+namespace Engine::Net {
+	/**
+	 * Performs all socket IO for a socket on a dedicated thread.
+	 *
+	 * Packets are received into a preallocated pool, timestamped on arrival and
+	 * handed to the owning thread through lock-free queues. Sent packets go the
+	 * other way. While running, the socket must not be used by any other thread.
+	 */
+	class NetworkThread {
+		public:
+			/** The number of preallocated packets for each direction. */
+			constexpr static uint32 poolSize = 1024;
+
+			class RecvPacket {
+				public:
+					Packet packet;
+					int32 size;
+					IPv4Address address;
+
+					/** The time the packet was read from the socket. */
+					Engine::Clock::TimePoint time;
+			};
+
+			class Stats {
+				public:
+					/** The number of outgoing packets dropped because the send pool was full. */
+					uint64 sendDropped = 0;
+			};
+
+		private:
+			class SendPacket {
+				public:
+					Packet packet;
+					int32 size;
+					IPv4Address address;
+			};
+
+			/** Queue of indices into the recv or send pool. */
+			using Queue = SPSCQueue<uint32, poolSize>;
+
+			UDPSocket& socket;
+			std::unique_ptr<RecvPacket[]> recvPool;
+			std::unique_ptr<SendPacket[]> sendPool;
+
+			/** Owning thread -> network thread. */
+			Queue recvFree;
+			Queue sendReady;
+
+			/** Network thread -> owning thread. */
+			Queue recvReady;
+			Queue sendFree;
+
+			Stats stats;
+			std::atomic<bool> running = true;
+
+			/** Sim settings waiting to be applied by the network thread. @see setSimSettings */
+			std::mutex simMutex;
+			UDPSimSettings simPending;
+			std::atomic<bool> simChanged = false;
+			std::thread thread;
+
+			void run();
+
+		public:
+			NetworkThread(UDPSocket& socket);
+			NetworkThread(const NetworkThread&) = delete;
+			NetworkThread& operator=(const NetworkThread&) = delete;
+			~NetworkThread();
+
+			/**
+			 * Calls @p func for each received packet in the order they were received.
+			 * Packets are only valid for the duration of the call.
+			 */
+			void recvAll(auto&& func) {
+				uint32 i;
+				while (recvReady.pop(i)) {
+					func(std::as_const(recvPool[i]));
+					recvFree.push(i);
+				}
+			}
+
+			/**
+			 * Copies a packet to be sent by the network thread.
+			 * Packets are dropped if the send pool is full.
+			 */
+			void queue(const void* data, int32 size, const IPv4Address& address);
+
+			/**
+			 * Changes the network sim settings of the socket. The settings are
+			 * applied by the network thread since it is the only thread that may
+			 * use the socket while running.
+			 */
+			void setSimSettings(const UDPSimSettings& settings);
+
+			ENGINE_INLINE const Stats& getStats() const noexcept { return stats; }
+	};
+}
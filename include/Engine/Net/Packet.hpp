@@ -1,5 +1,8 @@
 #pragma once
 
+// STD
+#include <cstring>
+
 // Engine
 #include <Engine/Engine.hpp>
 #include <Engine/Net/MessageHeader.hpp>
@@ -11,38 +14,111 @@ namespace Engine::Net {
 	constexpr inline int32 UDP_HEADER_SIZE = 8;
 	constexpr inline int32 MAX_PACKET_SIZE = ASSUMED_MIN_MTU - MAX_IP_HEADER_SIZE - UDP_HEADER_SIZE;
 
+	/** Only the low four bits are available for flags. The rest of the byte is used by the ack word count. */
+	struct PacketFlag_ { enum PacketFlag : uint8 {
+		None = 0,
+		Compressed = 1 << 0, // The body has been compressed. @see PacketCodec
+	};};
+	using PacketFlag = PacketFlag_::PacketFlag;
+	ENGINE_BUILD_ALL_OPS(PacketFlag);
+
 	class Packet {
+		public:
+			/** The version of the header layout. Packets with a different version are not compatible. */
+			constexpr static uint8 version = 2;
+
+			/** The number of acks in each ack word. */
+			constexpr static int32 ackWordBits = 64;
+
+			/** The maximum number of ack words in a packet. */
+			constexpr static int32 maxAckWords = AckBitset::size() / ackWordBits;
+			static_assert(AckBitset::size() % ackWordBits == 0);
+			static_assert(maxAckWords < 16, "The ack word count must fit in four bits.");
+
 		public:
 			// 2 bytes protocol
-			// 2 bytes seq num // TODO: look into seq num wrapping
-			// 2 bytes init ack
-			// 2 bytes key
-			// 8 bytes ack bitset
-			byte head[2 + 2 + 2 + 2 + 8] = {};
+			// 1 byte version
+			// 1 byte flags (low four bits) and ack word count (high four bits)
+			// 2 bytes seq num
+			// 2 bytes next ack
+			// 4 bytes key
+			// 8 bytes first ack word. Any other ack words are at the end of the body. @see writeAcks
+			//
+			// The head size keeps the body size a multiple of eight so message storage sized from it stays aligned.
+			byte head[2 + 1 + 1 + 2 + 2 + 4 + 8] = {};
 			byte body[MAX_PACKET_SIZE - sizeof(head)];
 
+		private:
+			// The header may be at any alignment so all fields are copied in and out.
+			template<class T>
+			ENGINE_INLINE T load(int32 offset) const noexcept {
+				T value;
+				memcpy(&value, head + offset, sizeof(value));
+				return value;
+			}
+
+			template<class T>
+			ENGINE_INLINE void store(int32 offset, const T& value) noexcept {
+				memcpy(head + offset, &value, sizeof(value));
+			}
+
 		public:
-			// TODO: look into alignment/access rules. May need to memcpy.
-			
-			auto& getProtocol() { return *reinterpret_cast<uint16*>(&head[0]); }
-			auto& getProtocol() const { return *reinterpret_cast<const uint16*>(&head[0]); }
-			void setProtocol(uint16 p) { getProtocol() = p; }
-
-			auto& getSeqNum() { return *reinterpret_cast<SeqNum*>(&head[2]); }
-			auto& getSeqNum() const { return *reinterpret_cast<const SeqNum*>(&head[2]); }
-			void setSeqNum(SeqNum n) { getSeqNum() = n; }
-
-			auto& getNextAck() { return *reinterpret_cast<SeqNum*>(&head[4]); }
-			auto& getNextAck() const { return *reinterpret_cast<const SeqNum*>(&head[4]); }
-			void setNextAck(SeqNum s) { getNextAck() = s; }
-
-			auto& getKey() { return *reinterpret_cast<SeqNum*>(&head[6]); }
-			auto& getKey() const { return *reinterpret_cast<const SeqNum*>(&head[6]); }
-			void setKey(uint16 k) { getKey() = k; }
-
-			auto& getAcks() { return *reinterpret_cast<AckBitset*>(&head[8]); }
-			auto& getAcks() const { return *reinterpret_cast<const AckBitset*>(&head[8]); }
-			void setAcks(const AckBitset& a) { getAcks() = a; }
+			ENGINE_INLINE uint16 getProtocol() const noexcept { return load<uint16>(0); }
+			ENGINE_INLINE void setProtocol(uint16 p) noexcept { store(0, p); }
+
+			ENGINE_INLINE uint8 getVersion() const noexcept { return head[2]; }
+			ENGINE_INLINE void setVersion(uint8 v) noexcept { head[2] = v; }
+
+			ENGINE_INLINE PacketFlag getFlags() const noexcept { return static_cast<PacketFlag>(head[3] & 0x0F); }
+			ENGINE_INLINE void setFlags(PacketFlag f) noexcept {
+				ENGINE_DEBUG_ASSERT((f & 0xF0) == 0, "Invalid packet flags.");
+				head[3] = static_cast<byte>((head[3] & 0xF0) | f);
+			}
+
+			ENGINE_INLINE SeqNum getSeqNum() const noexcept { return load<SeqNum>(4); }
+			ENGINE_INLINE void setSeqNum(SeqNum n) noexcept { store(4, n); }
+
+			ENGINE_INLINE SeqNum getNextAck() const noexcept { return load<SeqNum>(6); }
+			ENGINE_INLINE void setNextAck(SeqNum s) noexcept { store(6, s); }
+
+			ENGINE_INLINE uint32 getKey() const noexcept { return load<uint32>(8); }
+			ENGINE_INLINE void setKey(uint32 k) noexcept { store(8, k); }
+
+			ENGINE_INLINE int32 getAckWordCount() const noexcept { return head[3] >> 4; }
+
+			/**
+			 * Writes the first @p words words of @p acks. The first word is
+			 * written to the header and the rest are appended to the body.
+			 * @param bodySize The size of the body before the acks. Must leave room for them.
+			 * @return The size of the body including the acks.
+			 */
+			int32 writeAcks(const AckBitset& acks, int32 words, int32 bodySize) noexcept {
+				constexpr auto wordSize = ackWordBits / CHAR_BIT;
+				ENGINE_DEBUG_ASSERT(0 < words && words <= maxAckWords);
+				ENGINE_DEBUG_ASSERT(bodySize + (words - 1) * wordSize <= static_cast<int32>(sizeof(body)));
+				head[3] = static_cast<byte>((head[3] & 0x0F) | (words << 4));
+				memcpy(head + 12, acks.data(), wordSize);
+				memcpy(body + bodySize, acks.data() + wordSize, (words - 1) * wordSize);
+				return bodySize + (words - 1) * wordSize;
+			}
+
+			/**
+			 * Reads the acks written by writeAcks. Acks not included in the packet are zero.
+			 * @param bodySize The size of the body including the acks.
+			 * @return The size of the body without the acks or -1 if the packet is malformed.
+			 */
+			int32 readAcks(AckBitset& acks, int32 bodySize) const noexcept {
+				constexpr auto wordSize = ackWordBits / CHAR_BIT;
+				const auto words = getAckWordCount();
+				const auto extra = (words - 1) * wordSize;
+				if (words < 1 || words > maxAckWords || extra > bodySize) { return -1; }
+
+				acks.reset();
+				memcpy(acks.data(), head + 12, wordSize);
+				memcpy(acks.data() + wordSize, body + bodySize - extra, extra);
+				return bodySize - extra;
+			}
 	};
 	static_assert(sizeof(Packet) == MAX_PACKET_SIZE);
+	static_assert(sizeof(Packet::body) % 8 == 0);
 }
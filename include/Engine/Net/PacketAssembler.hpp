@@ -0,0 +1,96 @@
+#pragma once
+
+// STD
+#include <vector>
+
+// Engine
+#include <Engine/Engine.hpp>
+#include <Engine/WorkerPool.hpp>
+#include <Engine/Net/IPv4Address.hpp>
+#include <Engine/Net/UDPSocket.hpp>
+
+
+namespace Engine::Net {
+	/**
+	 * Assembles packets for many connections in parallel and then queues them all at once.
+	 *
+	 * Each job writes to its own sink so connections can be sent from worker
+	 * threads without any synchronization on the socket. Sinks are queued in
+	 * job order so the datagrams are the same as if each job was run serially.
+	 *
+	 * Jobs are distributed between the worker threads and the calling thread.
+	 * With zero worker threads everything is run on the calling thread.
+	 */
+	class PacketAssembler {
+		public:
+			/**
+			 * Buffers the datagrams queued by a single job.
+			 * Has the same queue interface as UDPSocket so it can be given to Connection::send.
+			 */
+			class Sink {
+				private:
+					friend class PacketAssembler;
+
+					std::vector<byte> data;
+
+					/** Data pointers are only assigned when flushed. */
+					std::vector<Datagram> datagrams;
+
+				public:
+					void queue(const void* data, int32 size, const IPv4Address& address);
+
+					ENGINE_INLINE int32 size() const noexcept { return static_cast<int32>(datagrams.size()); }
+			};
+
+		private:
+			std::vector<Sink> sinks;
+
+			/** The number of sinks used by the last call to assemble. */
+			int32 sinkCount = 0;
+
+			WorkerPool workers;
+
+		public:
+			/**
+			 * @param threadCount The number of worker threads in addition to the calling thread.
+			 */
+			PacketAssembler(int32 threadCount)
+				: workers{threadCount} {
+			}
+
+			ENGINE_INLINE int32 getThreadCount() const noexcept { return workers.getThreadCount(); }
+
+			/**
+			 * Calls @p func with each index in [0, count) and the sink for that index.
+			 * Blocks until all calls have completed. Sinks from the previous call are cleared.
+			 * @param func Called as `func(int32 index, Sink& sink)`. May be called from multiple threads at once.
+			 * @see flush
+			 */
+			template<class Func>
+			void assemble(int32 count, Func&& func) {
+				prepare(count);
+				workers.run(count, [&](int32 index){ func(index, sinks[index]); });
+			}
+
+			/**
+			 * Queues the datagrams from the last call to assemble on @p sock in index order.
+			 * @param sock The UDPSocket or NetworkThread to queue datagrams on.
+			 */
+			void flush(auto& sock) {
+				for (int32 i = 0; i < sinkCount; ++i) {
+					const auto& sink = sinks[i];
+					const byte* curr = sink.data.data();
+					for (const auto& dgram : sink.datagrams) {
+						sock.queue(curr, dgram.size, dgram.address);
+						curr += dgram.size;
+					}
+				}
+			}
+
+		private:
+			/**
+			 * Clears the sinks from the last call and makes sure there are at least @p count.
+			 */
+			void prepare(int32 count);
+	};
+}
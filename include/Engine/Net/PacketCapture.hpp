@@ -0,0 +1,108 @@
+#pragma once
+
+// STD
+#include <fstream>
+#include <span>
+#include <string>
+#include <vector>
+
+// Engine
+#include <Engine/Engine.hpp>
+#include <Engine/Clock.hpp>
+#include <Engine/Net/IPv4Address.hpp>
+
+
+namespace Engine::Net {
+	/**
+	 * Writes received datagrams to a file so a session can be replayed later. @see PacketReplay
+	 *
+	 * Datagrams are grouped into frames. A frame is usually everything received
+	 * in a single network update which allows the session to be replayed with
+	 * the same update boundaries it was captured with.
+	 *
+	 * Format, all values are in native byte order:
+	 * - 4 byte magic "ENPC", 4 byte version, 8 byte seed.
+	 * - Records until the end of the file:
+	 *   - 1 byte kind. @see PacketCapture::Kind
+	 *   - 8 byte time in nanoseconds since the start of the capture.
+	 *   - If a datagram: 4 byte address, 2 byte port, 2 byte size, then the data.
+	 */
+	class PacketCapture {
+		public:
+			enum class Kind : uint8 {
+				Frame,
+				Datagram,
+			};
+
+			constexpr static char magic[4] = {'E', 'N', 'P', 'C'};
+			constexpr static uint32 version = 1;
+
+		private:
+			std::ofstream file;
+			Engine::Clock::TimePoint start;
+
+		public:
+			/**
+			 * @param path The file to write.
+			 * @param seed Arbitrary user data stored with the capture. Usually used to seed any random state that needs to match on replay.
+			 */
+			PacketCapture(const std::string& path, uint64 seed);
+
+			ENGINE_INLINE bool isOpen() const noexcept { return file.is_open() && file.good(); }
+
+			/**
+			 * Starts a new frame. The time of the first frame is the start of the capture.
+			 */
+			void frame(Engine::Clock::TimePoint time);
+
+			/**
+			 * Writes a datagram to the current frame.
+			 */
+			void datagram(Engine::Clock::TimePoint time, const IPv4Address& addr, std::span<const byte> data);
+	};
+
+	/**
+	 * Reads datagrams written by PacketCapture one frame at a time.
+	 */
+	class PacketReplay {
+		public:
+			class Entry {
+				public:
+					/** The time since the start of the capture. */
+					Engine::Clock::Duration time;
+					IPv4Address address;
+					std::span<const byte> data;
+			};
+
+		private:
+			std::ifstream file;
+			uint64 seed = 0;
+			bool inFrame = false;
+
+			std::vector<Entry> entries;
+			std::vector<byte> data;
+
+			int64 frameCount = 0;
+			int64 datagramCount = 0;
+
+		public:
+			PacketReplay(const std::string& path);
+
+			ENGINE_INLINE bool isOpen() const noexcept { return file.is_open(); }
+			ENGINE_INLINE uint64 getSeed() const noexcept { return seed; }
+			ENGINE_INLINE int64 getFrameCount() const noexcept { return frameCount; }
+			ENGINE_INLINE int64 getDatagramCount() const noexcept { return datagramCount; }
+
+			/**
+			 * Reads the next frame. @see getFrame
+			 * @return False once the end of the capture has been reached or if the capture is malformed.
+			 */
+			bool next();
+
+			/**
+			 * The datagrams in the frame read by the last call to next.
+			 * Invalidated by the next call to next.
+			 */
+			ENGINE_INLINE std::span<const Entry> getFrame() const noexcept { return entries; }
+	};
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+// STD
+#include <span>
+#include <vector>
+
+// Engine
+#include <Engine/Engine.hpp>
+
+
+namespace Engine::Net {
+	/**
+	 * A small LZ77 style codec for packet bodies with an optional static dictionary.
+	 *
+	 * The dictionary is treated as data immediately preceding every payload so
+	 * matches can reference it. Since packets are small and mostly made of the
+	 * same message layouts, a dictionary trained on captured traffic gives much
+	 * better compression than the payload alone. Both ends of a connection
+	 * must use the same dictionary. @see getId
+	 *
+	 * Format, repeated until the end of the input:
+	 * - 1 byte token. High nibble is the literal length, low nibble is the match length minus minMatch.
+	 * - Literal length continuation bytes if the high nibble is 15. Each 255 byte means to read another.
+	 * - The literals.
+	 * - If not at the end of the input:
+	 *   - 2 byte little endian match offset.
+	 *   - Match length continuation bytes if the low nibble is 15.
+	 */
+	class PacketCodec {
+		public:
+			constexpr static int32 minMatch = 4;
+			constexpr static int32 maxDictionarySize = 1 << 15;
+
+		private:
+			constexpr static uint32 version = 1;
+
+			std::vector<byte> dict;
+
+			/** The last position of each hash in the dictionary. -1 if none. */
+			std::vector<int32> dictTable;
+
+			uint32 id = 0;
+
+		public:
+			/**
+			 * @param dictionary The dictionary to use. Truncated to the last maxDictionarySize bytes.
+			 */
+			PacketCodec(std::span<const byte> dictionary = {});
+
+			/**
+			 * Identifies the format and dictionary used by this codec.
+			 * Codecs with the same id are compatible.
+			 */
+			ENGINE_INLINE uint32 getId() const noexcept { return id; }
+
+			ENGINE_INLINE std::span<const byte> getDictionary() const noexcept { return dict; }
+
+			/**
+			 * Compresses @p src into @p dst.
+			 * @return The size of the compressed data or zero if it does not fit in @p dst.
+			 */
+			int32 compress(std::span<const byte> src, std::span<byte> dst) const noexcept;
+
+			/**
+			 * Decompresses @p src into @p dst.
+			 * @return The size of the decompressed data or -1 if @p src is malformed or does not fit in @p dst.
+			 */
+			int32 decompress(std::span<const byte> src, std::span<byte> dst) const noexcept;
+
+			/**
+			 * Builds a dictionary from sample payloads.
+			 * Picks the segments containing the most frequently repeated byte sequences across all samples.
+			 * Intended to be run offline on captured traffic.
+			 * @param samples The sample payloads. Usually uncompressed packet bodies.
+			 * @param size The maximum size of the dictionary.
+			 */
+			static std::vector<byte> train(std::span<const std::vector<byte>> samples, int32 size);
+	};
+}
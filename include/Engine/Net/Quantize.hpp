@@ -0,0 +1,174 @@
+#pragma once
+
+// STD
+#include <bit>
+
+// GLM
+#include <glm/vec2.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+// Engine
+#include <Engine/Engine.hpp>
+#include <Engine/Net/BufferWriter.hpp>
+
+
+// Quantized values are bit packed. Call writeFlushBits/readFlushBits before mixing them with
+// normal byte writes/reads.
+namespace Engine::Net {
+	/**
+	 * A float in the range [min, max] where adjacent representable values are no more than
+	 * `precision` apart. Values outside the range are clamped. @see contains
+	 */
+	struct QuantizedFloat {
+		float32 min;
+		float32 max;
+		float32 precision;
+
+		/**
+		 * The number of bits needed to represent this value.
+		 */
+		constexpr int32 bits() const noexcept {
+			const float64 exact = (static_cast<float64>(max) - min) / precision;
+			auto steps = static_cast<uint64>(exact);
+			if (steps < exact) { ++steps; }
+			return std::bit_width(steps);
+		}
+
+		constexpr uint32 maxQuantized() const noexcept {
+			return static_cast<uint32>((uint64{1} << bits()) - 1);
+		}
+
+		/**
+		 * Checks if @p value can be quantized without being clamped.
+		 */
+		constexpr bool contains(float32 value) const noexcept {
+			return min <= value && value <= max;
+		}
+
+		uint32 quantize(float32 value) const noexcept {
+			const float64 norm = (std::clamp(value, min, max) - static_cast<float64>(min)) / (static_cast<float64>(max) - min);
+			return static_cast<uint32>(norm * maxQuantized() + 0.5);
+		}
+
+		float32 dequantize(uint32 value) const noexcept {
+			return static_cast<float32>(min + (static_cast<float64>(max) - min) * (static_cast<float64>(value) / maxQuantized()));
+		}
+	};
+
+	/**
+	 * An integer in the range [min, max]. Values outside the range are clamped.
+	 */
+	struct QuantizedInt {
+		int32 min;
+		int32 max;
+
+		constexpr int32 bits() const noexcept {
+			return std::max(1, static_cast<int32>(std::bit_width(static_cast<uint32>(max - min))));
+		}
+
+		ENGINE_INLINE uint32 quantize(int32 value) const noexcept {
+			return static_cast<uint32>(std::clamp(value, min, max) - min);
+		}
+
+		ENGINE_INLINE int32 dequantize(uint32 value) const noexcept {
+			return std::min(static_cast<int32>(value + min), max);
+		}
+	};
+
+	/**
+	 * A unit quaternion stored using the smallest three method. The largest component is
+	 * dropped and recomputed on read. The remaining components are each stored in `bits` bits.
+	 */
+	struct QuantizedQuat {
+		int32 bits;
+
+		/** The range of the three smallest components of a unit quaternion is [-1/sqrt(2), 1/sqrt(2)]. */
+		constexpr QuantizedFloat component() const noexcept {
+			constexpr float32 range = 0.70710678f;
+
+			// Slightly increase the precision so rounding can't push us over to needing another bit.
+			return {-range, range, 2 * range / ((uint64{1} << bits) - 1) * 1.001f};
+		}
+	};
+
+	template<QuantizedFloat Q, class Writer>
+	ENGINE_INLINE void writeQuantized(Writer& buff, float32 value) {
+		static_assert(Q.min < Q.max && Q.precision > 0, "Invalid quantized float range.");
+		static_assert(0 < Q.bits() && Q.bits() <= 32, "Quantized float requires too many bits. Increase the precision or reduce the range.");
+		buff.template writeBits<Q.bits()>(Q.quantize(value));
+	}
+
+	template<QuantizedFloat Q>
+	ENGINE_INLINE bool readQuantized(BufferReader& buff, float32& value) {
+		uint32 q;
+		if (!buff.readBits<Q.bits()>(&q)) { return false; }
+		value = Q.dequantize(q);
+		return true;
+	}
+
+	template<QuantizedFloat Q, class Writer>
+	ENGINE_INLINE void writeQuantized(Writer& buff, glm::vec2 value) {
+		writeQuantized<Q>(buff, value.x);
+		writeQuantized<Q>(buff, value.y);
+	}
+
+	template<QuantizedFloat Q>
+	ENGINE_INLINE bool readQuantized(BufferReader& buff, glm::vec2& value) {
+		return readQuantized<Q>(buff, value.x) && readQuantized<Q>(buff, value.y);
+	}
+
+	template<QuantizedInt Q, class Writer>
+	ENGINE_INLINE void writeQuantized(Writer& buff, int32 value) {
+		static_assert(Q.min < Q.max, "Invalid quantized int range.");
+		buff.template writeBits<Q.bits()>(Q.quantize(value));
+	}
+
+	template<QuantizedInt Q>
+	ENGINE_INLINE bool readQuantized(BufferReader& buff, int32& value) {
+		uint32 q;
+		if (!buff.readBits<Q.bits()>(&q)) { return false; }
+		value = Q.dequantize(q);
+		return true;
+	}
+
+	template<QuantizedQuat Q, class Writer>
+	void writeQuantized(Writer& buff, const glm::quat& value) {
+		static_assert(0 < Q.bits && Q.bits <= 30, "Invalid quantized quaternion component size.");
+		static_assert(Q.component().bits() == Q.bits);
+		const float32 comps[4] = {value.x, value.y, value.z, value.w};
+
+		int32 largest = 0;
+		for (int32 i = 1; i < 4; ++i) {
+			if (std::abs(comps[i]) > std::abs(comps[largest])) { largest = i; }
+		}
+
+		// q and -q are the same rotation so flip the sign to make the dropped component positive.
+		const float32 sign = comps[largest] < 0 ? -1.0f : 1.0f;
+		buff.template writeBits<2>(static_cast<uint32>(largest));
+		for (int32 i = 0; i < 4; ++i) {
+			if (i == largest) { continue; }
+			writeQuantized<Q.component()>(buff, comps[i] * sign);
+		}
+	}
+
+	template<QuantizedQuat Q>
+	bool readQuantized(BufferReader& buff, glm::quat& value) {
+		uint32 largest;
+		if (!buff.readBits<2>(&largest)) { return false; }
+
+		float32 comps[4];
+		float32 sum = 0;
+		for (uint32 i = 0; i < 4; ++i) {
+			if (i == largest) { continue; }
+			if (!readQuantized<Q.component()>(buff, comps[i])) { return false; }
+			sum += comps[i] * comps[i];
+		}
+
+		comps[largest] = std::sqrt(std::max(0.0f, 1.0f - sum));
+		value.x = comps[0];
+		value.y = comps[1];
+		value.z = comps[2];
+		value.w = comps[3];
+		return true;
+	}
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+// STD
+#include <vector>
+
+// Engine
+#include <Engine/Engine.hpp>
+#include <Engine/Clock.hpp>
+#include <Engine/Net/IPv4Address.hpp>
+
+
+namespace Engine::Net {
+	/**
+	 * Token bucket rate limiting for traffic from many addresses.
+	 *
+	 * Addresses are hashed into a fixed number of buckets so memory use does not
+	 * depend on the number of addresses seen. Addresses that share a bucket share
+	 * a limit. Only the IP is used, all ports on an IP share a bucket. There is
+	 * also a limit for all addresses combined.
+	 *
+	 * Each bucket holds up to one second of tokens.
+	 */
+	class RateLimiter {
+		private:
+			class Bucket {
+				public:
+					float32 tokens = 0;
+					Engine::Clock::TimePoint last = {};
+			};
+
+			std::vector<Bucket> buckets;
+			Bucket total;
+			float32 rate;
+			float32 totalRate;
+			uint64 denied = 0;
+
+		public:
+			/**
+			 * @param bucketCount The number of per address buckets.
+			 * @param rate The number of events per second allowed from each address.
+			 * @param totalRate The number of events per second allowed from all addresses combined.
+			 */
+			RateLimiter(int32 bucketCount, float32 rate, float32 totalRate);
+
+			ENGINE_INLINE void setRates(float32 rate, float32 totalRate) noexcept {
+				this->rate = rate;
+				this->totalRate = totalRate;
+			}
+
+			/** The number of events that have been denied. */
+			ENGINE_INLINE uint64 getDeniedCount() const noexcept { return denied; }
+
+			/**
+			 * Checks if an event from @p addr is allowed and uses a token if it is.
+			 * @param time The time of the event. Should not decrease between calls.
+			 */
+			bool allow(const IPv4Address& addr, Engine::Clock::TimePoint time);
+	};
+}
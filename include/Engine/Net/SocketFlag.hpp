@@ -12,6 +12,7 @@ namespace Engine::Net {
 		None = 0,
 		NonBlocking = 1 << 0,
 		ReuseAddress = 1 << 1,
+		ReusePort = 1 << 2, // Only supported on Linux. Allows multiple sockets to bind to the same port with load balancing.
 	};};
 	using SocketFlag = SocketFlag_::SocketFlag;
 	ENGINE_BUILD_ALL_OPS(SocketFlag);
@@ -13,5 +13,7 @@ namespace Engine::Net {
 		Broadcast,
 		MulticastJoin,
 		MulticastLeave,
+		RecvBufferSize,
+		SendBufferSize,
 	};
 }
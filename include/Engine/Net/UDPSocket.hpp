@@ -1,47 +1,102 @@
 #pragma once
 
+// STD
+#include <span>
+#include <vector>
+
 // Engine
 #include <Engine/Engine.hpp>
+#include <Engine/Clock.hpp>
 #include <Engine/Net/IPv4Address.hpp>
 #include <Engine/Net/SocketOption.hpp>
 #include <Engine/Net/SocketFlag.hpp>
 
-#if ENGINE_CLIENT
-#define ENGINE_UDP_NETWORK_SIM
-#endif
-
 
 namespace Engine::Net {
-	#ifdef ENGINE_UDP_NETWORK_SIM
-		class UDPSimSettings {
-			public:
-				// TODO: really it may be better to use ticks instead of ms. Since it wont be re-checked until next tick the min time is 1/tickrate.
-				Engine::Clock::Duration halfPingAdd = std::chrono::milliseconds{0};
-				float32 jitter = 0.0f;
-				float32 duplicate = 0.0f;
-				float32 loss = 0.0f;
-		};
-
-		class UDPSimState;
-	#endif
+	class LoopbackNetwork;
+
+	/**
+	 * Simulated network conditions applied to a socket's sent and received datagrams.
+	 * The simulation is skipped entirely while all values are zero.
+	 */
+	class UDPSimSettings {
+		public:
+			// TODO: really it may be better to use ticks instead of ms. Since it wont be re-checked until next tick the min time is 1/tickrate.
+			Engine::Clock::Duration halfPingAdd = std::chrono::milliseconds{0};
+			float32 jitter = 0.0f;
+			float32 duplicate = 0.0f;
+			float32 loss = 0.0f;
+	};
+
+	class UDPSimState;
+
+	/**
+	 * A single datagram used with batched socket operations.
+	 */
+	class Datagram {
+		public:
+			/** The datagram data. When receiving this is the buffer to receive into. */
+			void* data;
+
+			/** The size of the data. When receiving this is the buffer size and is set to the received size. */
+			int32 size;
+
+			/** The address sent to or received from. */
+			IPv4Address address;
+	};
 
 	class UDPSocket {
-		#ifdef ENGINE_UDP_NETWORK_SIM
 		private:
 			friend class UDPSimState;
 			UDPSimState* sim = nullptr;
 
 		public:
 			UDPSimSettings& getSimSettings() noexcept;
-			void realSimSend();
-		#endif
 
+			/**
+			 * Sends any datagrams delayed by the network sim that are due.
+			 * Should be called regularly. Does nothing if there are none.
+			 */
+			void realSimSend();
 
 		private:
 			constexpr static uint64 invalid = -1;
 			uint64 handle = invalid;
 			void showError();
 
+			/** Sends or receives one datagram at a time. Used when batching isn't supported. */
+			int32 sendEach(std::span<const Datagram> datagrams);
+			int32 recvEach(std::span<Datagram> datagrams);
+
+			/** If datagrams need to go through the network sim. */
+			bool useSim() const noexcept;
+
+			/**
+			 * Waits until the socket can send or until the timeout expires.
+			 * @return True if the socket can send.
+			 */
+			bool waitWritable(Engine::Clock::Duration timeout);
+
+			/** The total number of queued datagrams that could not be sent. */
+			uint64 sendDropped = 0;
+
+			/** Data for datagrams queued with `queue`. */
+			std::vector<byte> sendQueueData;
+
+			/** Datagrams queued with `queue`. Data pointers are only assigned when flushed. */
+			std::vector<Datagram> sendQueue;
+
+			/** The in-process network used instead of a system socket. @see UDPSocket(LoopbackNetwork&, uint16) */
+			LoopbackNetwork* loopback = nullptr;
+			uint16 loopbackPort = 0;
+
+		public:
+			/** The maximum number of datagrams sent or received per system call. */
+			constexpr static int32 maxBatchSize = 64;
+
+			/** How long to wait for a full send buffer to drain before dropping the remaining datagrams. */
+			constexpr static auto sendWaitTimeout = std::chrono::milliseconds{2};
+
 		public:
 			struct DoNotInitialize {
 				constexpr explicit DoNotInitialize() = default;
@@ -52,6 +107,13 @@ namespace Engine::Net {
 
 			UDPSocket(const uint16 port, const SocketFlag flags = {});
 
+			/**
+			 * Creates a socket that sends and receives through @p network instead of
+			 * the operating system. Socket options and the network sim do not apply.
+			 * @param port The port to bind. Zero to pick an unused port.
+			 */
+			UDPSocket(LoopbackNetwork& network, const uint16 port);
+
 			ENGINE_INLINE UDPSocket(UDPSocket&& other) noexcept {
 				*this = std::move(other);
 			}
@@ -64,10 +126,12 @@ namespace Engine::Net {
 			ENGINE_INLINE friend void swap(UDPSocket& a, UDPSocket& b) noexcept {
 				using std::swap;
 				swap(a.handle, b.handle);
-				
-				#ifdef ENGINE_UDP_NETWORK_SIM
-					swap(a.sim, b.sim);
-				#endif
+				swap(a.sendQueueData, b.sendQueueData);
+				swap(a.sendQueue, b.sendQueue);
+				swap(a.loopback, b.loopback);
+				swap(a.loopbackPort, b.loopbackPort);
+				swap(a.sim, b.sim);
+				swap(a.sendDropped, b.sendDropped);
 			}
 
 			UDPSocket() = delete;
@@ -82,16 +146,56 @@ namespace Engine::Net {
 			int32 send(const void* data, int32 size, const IPv4Address& address);
 			int32 recv(void* data, int32 size, IPv4Address& address);
 
+			/**
+			 * Sends multiple datagrams. Uses a single system call per maxBatchSize datagrams where supported.
+			 * If the send buffer is full this waits up to sendWaitTimeout for it to drain before giving up.
+			 * @return The number of datagrams sent.
+			 */
+			int32 sendBatch(std::span<const Datagram> datagrams);
+
+			/**
+			 * Receives multiple datagrams. Uses a single system call per maxBatchSize datagrams where supported.
+			 * @return The number of datagrams received. The received datagrams are at the start of @p datagrams.
+			 */
+			int32 recvBatch(std::span<Datagram> datagrams);
+
+			/**
+			 * Waits until data is available to receive or until the timeout expires.
+			 * @return True if data is available.
+			 */
+			bool wait(Engine::Clock::Duration timeout);
+
+			/**
+			 * Copies a datagram to be sent on the next flush.
+			 * Automatically flushes once maxBatchSize datagrams are queued.
+			 */
+			void queue(const void* data, int32 size, const IPv4Address& address);
+
+			/**
+			 * Sends all queued datagrams.
+			 * Any that can't be sent are dropped and counted in getSendDropped.
+			 */
+			void flush();
+
+			/**
+			 * Gets the total number of queued datagrams dropped because they could not be sent.
+			 */
+			ENGINE_INLINE uint64 getSendDropped() const noexcept { return sendDropped; }
+
 			IPv4Address getAddress() const;
 
+			ENGINE_INLINE bool isLoopback() const noexcept { return loopback; }
+
 			template<SocketOption Opt, class Value>
 			bool setOption(const Value& value){
 				static_assert(ENGINE_TMP_FALSE(Value), "Invalid SocketOption + Value combination.");
 				return false;
 			}
-
-			template<> bool setOption<SocketOption::Broadcast, bool>(const bool& value);
-			template<> bool setOption<SocketOption::MulticastJoin, IPv4Address>(const IPv4Address& groupAddr);
-			template<> bool setOption<SocketOption::MulticastLeave, IPv4Address>(const IPv4Address& groupAddr);
 	};
+
+	template<> bool UDPSocket::setOption<SocketOption::Broadcast, bool>(const bool& value);
+	template<> bool UDPSocket::setOption<SocketOption::MulticastJoin, IPv4Address>(const IPv4Address& groupAddr);
+	template<> bool UDPSocket::setOption<SocketOption::MulticastLeave, IPv4Address>(const IPv4Address& groupAddr);
+	template<> bool UDPSocket::setOption<SocketOption::RecvBufferSize, int32>(const int32& size);
+	template<> bool UDPSocket::setOption<SocketOption::SendBufferSize, int32>(const int32& size);
 }
@@ -14,7 +14,12 @@ namespace Engine::Net {
 	using SeqNum = uint16;
 	using ConnectionState = uint8;
 
-	using AckBitset = Bitset<64, uint64>;
+	/**
+	 * Acks for the packets received before a packet's next ack.
+	 * Bit N is set if `nextAck - 1 - N` has been received.
+	 * @see Packet::writeAcks
+	 */
+	using AckBitset = Bitset<256, uint64>;
 
 	struct MessageDirection_ {
 		enum MessageDirection : uint8 {
@@ -0,0 +1,72 @@
+#pragma once
+
+// STD
+#include <array>
+#include <atomic>
+
+// Engine
+#include <Engine/Engine.hpp>
+
+
+namespace Engine {
+	/**
+	 * A fixed size lock-free queue for exactly one producer thread and one consumer thread.
+	 * @tparam Size The capacity of the queue. Must be a power of two.
+	 */
+	template<class T, uint32 Size>
+	class SPSCQueue {
+		static_assert(Size > 0 && (Size & (Size - 1)) == 0, "SPSCQueue size must be a power of two.");
+		static_assert(std::is_trivially_copyable_v<T>, "SPSCQueue only supports trivially copyable types.");
+
+		private:
+			constexpr static uint32 mask = Size - 1;
+
+			// Separate cache lines to avoid false sharing between the producer and consumer.
+			/** The next index to read. Only written by the consumer. */
+			alignas(64) std::atomic<uint32> head = 0;
+
+			/** The next index to write. Only written by the producer. */
+			alignas(64) std::atomic<uint32> tail = 0;
+
+			alignas(64) std::array<T, Size> storage;
+
+		public:
+			SPSCQueue() = default;
+			SPSCQueue(const SPSCQueue&) = delete;
+			SPSCQueue& operator=(const SPSCQueue&) = delete;
+
+			/**
+			 * Adds a value to the queue. Producer only.
+			 * @return False if the queue is full.
+			 */
+			bool push(const T& value) noexcept {
+				const auto t = tail.load(std::memory_order_relaxed);
+				if (t - head.load(std::memory_order_acquire) == Size) { return false; }
+				storage[t & mask] = value;
+				tail.store(t + 1, std::memory_order_release);
+				return true;
+			}
+
+			/**
+			 * Removes a value from the queue. Consumer only.
+			 * @return False if the queue is empty.
+			 */
+			bool pop(T& value) noexcept {
+				const auto h = head.load(std::memory_order_relaxed);
+				if (h == tail.load(std::memory_order_acquire)) { return false; }
+				value = storage[h & mask];
+				head.store(h + 1, std::memory_order_release);
+				return true;
+			}
+
+			/**
+			 * The number of values in the queue. Only approximate while the other thread is active.
+			 */
+			ENGINE_INLINE uint32 size() const noexcept {
+				return tail.load(std::memory_order_acquire) - head.load(std::memory_order_acquire);
+			}
+
+			ENGINE_INLINE bool empty() const noexcept { return size() == 0; }
+			ENGINE_INLINE constexpr static uint32 capacity() noexcept { return Size; }
+	};
+}
@@ -84,7 +84,7 @@ namespace Engine {
 			}
 
 			ENGINE_INLINE constexpr bool full() const noexcept {
-				return size() != capacity();
+				return size() == capacity();
 			}
 
 			ENGINE_INLINE constexpr bool space() const noexcept {
@@ -0,0 +1,72 @@
+#pragma once
+
+// STD
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+// Engine
+#include <Engine/Engine.hpp>
+
+
+namespace Engine {
+	/**
+	 * A fixed set of worker threads for running batches of independent jobs.
+	 *
+	 * Jobs are distributed between the worker threads and the calling thread.
+	 * With zero worker threads everything is run on the calling thread.
+	 */
+	class WorkerPool {
+		private:
+			using JobFunc = void(*)(void* context, int32 index);
+
+			std::vector<std::thread> threads;
+
+			// All job state is guarded by this mutex.
+			std::mutex mutex;
+			std::condition_variable jobWait;
+			std::condition_variable doneWait;
+			bool threadsShouldExit = false;
+
+			JobFunc jobFunc = nullptr;
+			void* jobContext = nullptr;
+			int32 jobNext = 0;
+			int32 jobCount = 0;
+			int32 jobRemaining = 0;
+
+		public:
+			/**
+			 * @param threadCount The number of worker threads in addition to the calling thread.
+			 */
+			WorkerPool(int32 threadCount);
+			WorkerPool(const WorkerPool&) = delete;
+			WorkerPool& operator=(const WorkerPool&) = delete;
+			~WorkerPool();
+
+			ENGINE_INLINE int32 getThreadCount() const noexcept { return static_cast<int32>(threads.size()); }
+
+			/**
+			 * Calls @p func with each index in [0, count). Blocks until all calls have completed.
+			 * @param func Called as `func(int32 index)`. May be called from multiple threads at once.
+			 */
+			template<class Func>
+			void run(int32 count, Func&& func) {
+				using F = std::remove_reference_t<Func>;
+				run(count, [](void* context, int32 index){
+					(*static_cast<F*>(context))(index);
+				}, const_cast<void*>(static_cast<const void*>(&func)));
+			}
+
+		private:
+			void run(int32 count, JobFunc func, void* context);
+
+			/**
+			 * Runs jobs until none are left to start. The lock must be held.
+			 */
+			void runJobs(std::unique_lock<std::mutex>& lock);
+
+			void workerThread();
+	};
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+// STD
+#include <array>
+
+// Engine
+#include <Engine/Net/PacketCodec.hpp>
+#include <Engine/Net/UDPSocket.hpp>
+#include <Engine/ECS/ecs.hpp>
+
+// Game
+#include <Game/ConnectionInfo.hpp>
+#include <Game/comps/ActionComponent.hpp>
+
+
+namespace Game {
+	/**
+	 * A headless client used for load testing.
+	 * Completes the connection handshake, sends scripted input and reads, but
+	 * does not apply, all messages from the server.
+	 */
+	class BotClient {
+		public:
+			class MessageStats {
+				public:
+					uint64 count = 0;
+					uint64 bytes = 0;
+			};
+
+			/** How far ahead of the server tick inputs are sent. */
+			constexpr static Engine::ECS::Tick inputLead = 2;
+
+		private:
+			Engine::Net::UDPSocket socket;
+			ConnectionInfo conn;
+			const Engine::Net::PacketCodec& codec;
+
+			/** Per bot offset so bots don't all move in sync. */
+			uint32 scriptSeed;
+
+			Engine::Clock::TimePoint lastRequest = {};
+			std::array<Engine::Net::Packet, Engine::Net::UDPSocket::maxBatchSize> packets = {};
+			std::array<Engine::Net::Datagram, Engine::Net::UDPSocket::maxBatchSize> datagrams = {};
+			std::array<MessageStats, MessageType::_count> stats = {};
+
+		public:
+			/**
+			 * @param socket The socket to use. Usually a loopback socket.
+			 * @param server The address of the server to connect to.
+			 * @param codec The codec to use if the server offers compression.
+			 * @param seed Seed used for the connection key and input script.
+			 */
+			BotClient(Engine::Net::UDPSocket socket, const Engine::Net::IPv4Address& server, const Engine::Net::PacketCodec& codec, uint32 seed);
+			BotClient(const BotClient&) = delete;
+
+			/**
+			 * Receives messages, advances the handshake and sends input for @p tick.
+			 * @param tick The current server tick.
+			 */
+			void update(Engine::ECS::Tick tick);
+
+			ENGINE_INLINE bool isConnected() const noexcept { return conn.getState() == ConnectionState::Connected; }
+			ENGINE_INLINE const auto& getConnection() const noexcept { return conn; }
+			ENGINE_INLINE const auto& getMessageStats() const noexcept { return stats; }
+
+		private:
+			void recv();
+			void handleMessage(const Engine::Net::MessageHeader hdr, Engine::Net::BufferReader& msg);
+			void sendConnectRequest();
+			void sendAction(Engine::ECS::Tick tick);
+
+			/** The scripted input for a tick. */
+			ActionState getScriptedState(Engine::ECS::Tick tick) const;
+	};
+}
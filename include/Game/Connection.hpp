@@ -20,7 +20,10 @@ namespace Game {
 		MessageType::DISCONNECT,
 
 		MessageType::ACTION // TODO: one of these things is not like the others
-	> {};
+	> {
+		// Input is small but latency sensitive.
+		constexpr static Engine::Net::ChannelSchedule schedule = {.weight = 1.0f, .minShare = 0.1f};
+	};
 
 	struct Channel_General_RU : Engine::Net::Channel_ReliableUnordered<
 		MessageType::PLAYER_DATA,
@@ -43,11 +46,21 @@ namespace Game {
 		MessageType::ECS_ENT_DESTROY,
 		MessageType::ECS_COMP_ADD,
 		MessageType::ECS_COMP_ALWAYS,
+		MessageType::ECS_COMP_UPDATE,
 		MessageType::ECS_FLAG,
 		MessageType::ECS_ZONE_INFO
-	> {};
+	> {
+		// Entity updates should never be starved by bulk transfers.
+		constexpr static Engine::Net::ChannelSchedule schedule = {.weight = 3.0f, .minShare = 0.25f};
+	};
 
 	struct Channel_Map_Blob : Engine::Net::Channel_LargeReliableOrdered<
+		Engine::Net::LargeChannelConfig{
+			.maxBlobs = 64,
+			.window = 256,
+			.fragmentSize = 512,
+			.bandwidthPercent = 75,
+		},
 		MessageType::MAP_CHUNK
 	> {};
 
@@ -56,11 +69,9 @@ namespace Game {
 		Channel_General_RU,
 		Channel_ECS,
 
-		// One problem with having this last is that we can never use a full packet
-		// On the other hand we dont want map data to eat 100% bandwidth and cause
-		// jumpy gameplay. Currently the solution is to limit the maximum use of Channel_LargeReliableOrdered.
-		// Doing this we need to make sure we never send more than this maximum EVERY frame (such as ACTION messages)
-		// or else they will never be sent.
-		Channel_Map_Blob 
+		// We dont want map data to eat 100% bandwidth and cause jumpy gameplay
+		// so Channel_Map_Blob has the default (lowest) schedule weight and is
+		// also paced to a percentage of the send bandwidth.
+		Channel_Map_Blob
 	>;
 }
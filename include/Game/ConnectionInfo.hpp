@@ -9,5 +9,8 @@ namespace Game {
 			using Connection::Connection;
 			Engine::ECS::Entity ent{}; // TODO: probably add getter/setter once conversion is done. Makes access cleaner
 			Engine::Clock::TimePoint disconnectAt = {};
+
+			/** This connection's index in the NetworkingSystem connection slots. */
+			uint16 slot = 0;
 	};
 }
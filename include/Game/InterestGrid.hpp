@@ -0,0 +1,155 @@
+#pragma once
+
+// STD
+#include <vector>
+
+// Engine
+#include <Engine/FlatHashMap.hpp>
+#include <Engine/ECS/Entity.hpp>
+
+// Game
+#include <Game/common.hpp>
+
+
+namespace Game {
+	/**
+	 * A uniform spatial hash of entity positions used for network interest
+	 * management. Positions are relative to their zone and entities in different
+	 * zones never interact.
+	 *
+	 * Entities only move between cells when they cross a cell boundary so
+	 * updating a mostly stationary set of entities is cheap.
+	 */
+	class InterestGrid {
+		public:
+			/**
+			 * Size of each cell. Ideally a range query should only touch a handful
+			 * of cells so this should be similar to the neighbor ranges.
+			 */
+			constexpr static WorldUnit cellSize = 8;
+
+		private:
+			class Cell {
+				public:
+					ZoneId zoneId;
+					glm::ivec2 pos;
+					ENGINE_INLINE bool operator==(const Cell&) const noexcept = default;
+			};
+
+			class CellHash {
+				public:
+					[[nodiscard]] ENGINE_INLINE uintz operator()(const Cell& cell) const noexcept {
+						uintz result = Engine::hash(cell.pos);
+						Engine::hashCombine(result, cell.zoneId);
+						return result;
+					}
+			};
+
+			class Entry {
+				public:
+					Engine::ECS::Entity ent;
+					WorldVec pos;
+			};
+
+			/** Where an entity is stored. Indexed by entity id. */
+			class Location {
+				public:
+					Engine::ECS::Entity ent = {};
+					Cell cell;
+					uint32 index;
+			};
+
+			Engine::FlatHashMap<Cell, std::vector<Entry>, CellHash> cells;
+			std::vector<Location> locations;
+
+		public:
+			/**
+			 * Inserts or moves an entity.
+			 */
+			void update(Engine::ECS::Entity ent, ZoneId zoneId, WorldVec pos) {
+				if (ent.id >= locations.size()) {
+					locations.resize(ent.id + 1);
+				}
+
+				const Cell cell = {zoneId, toCell(pos)};
+				auto& loc = locations[ent.id];
+
+				if (loc.ent == ent) {
+					if (loc.cell == cell) {
+						cells.find(cell)->second[loc.index].pos = pos;
+						return;
+					}
+
+					erase(loc);
+				} else if (loc.ent) {
+					// Id reused without removing the old entity.
+					erase(loc);
+				}
+
+				auto& entries = cells[cell];
+				loc.ent = ent;
+				loc.cell = cell;
+				loc.index = static_cast<uint32>(entries.size());
+				entries.push_back({ent, pos});
+			}
+
+			/**
+			 * Removes an entity. Does nothing if the entity is not in the grid.
+			 */
+			void remove(Engine::ECS::Entity ent) {
+				if (ent.id >= locations.size()) { return; }
+				auto& loc = locations[ent.id];
+				if (loc.ent != ent) { return; }
+				erase(loc);
+				loc.ent = {};
+			}
+
+			/**
+			 * Calls @p func for every entity in @p zoneId within the square of
+			 * half size @p range centered on @p center.
+			 */
+			void query(ZoneId zoneId, WorldVec center, WorldUnit range, auto&& func) const {
+				const auto min = toCell(center - range);
+				const auto max = toCell(center + range);
+
+				for (Cell cell = {zoneId, min}; cell.pos.y <= max.y; ++cell.pos.y) {
+					for (cell.pos.x = min.x; cell.pos.x <= max.x; ++cell.pos.x) {
+						const auto found = cells.find(cell);
+						if (found == cells.end()) { continue; }
+
+						for (const auto& entry : found->second) {
+							const auto diff = glm::abs(entry.pos - center);
+							if (diff.x <= range && diff.y <= range) {
+								func(entry.ent);
+							}
+						}
+					}
+				}
+			}
+
+			ENGINE_INLINE bool contains(Engine::ECS::Entity ent) const noexcept {
+				return ent.id < locations.size() && locations[ent.id].ent == ent;
+			}
+
+		private:
+			ENGINE_INLINE static glm::ivec2 toCell(WorldVec pos) noexcept {
+				return glm::ivec2{glm::floor(pos / cellSize)};
+			}
+
+			void erase(const Location& loc) {
+				const auto found = cells.find(loc.cell);
+				ENGINE_DEBUG_ASSERT(found != cells.end(), "Missing interest grid cell. This is a bug.");
+
+				auto& entries = found->second;
+				if (loc.index + 1 != entries.size()) {
+					entries[loc.index] = entries.back();
+					locations[entries[loc.index].ent.id].index = loc.index;
+				}
+				entries.pop_back();
+
+				if (entries.empty()) {
+					cells.erase(found);
+				}
+			}
+	};
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+// STD
+#include <array>
+#include <memory>
+#include <vector>
+
+// Engine
+#include <Engine/Clock.hpp>
+#include <Engine/Net/LoopbackNetwork.hpp>
+#include <Engine/Net/PacketCodec.hpp>
+
+// Game
+#include <Game/BotClient.hpp>
+
+
+namespace Game {
+	class World;
+
+	/**
+	 * Runs a number of headless bots against a server over an in-process
+	 * loopback network and periodically logs server tick time, bandwidth per
+	 * player and message counts.
+	 *
+	 * The loopback network must exist before the server's NetworkingSystem is
+	 * created. @see Engine::GlobalConfig::loopback
+	 *
+	 * Only the bots are headless, the server still runs with its window and
+	 * OpenGL context. This is not suitable for running on CI machines without
+	 * a display.
+	 */
+	class LoadTest {
+		public:
+			/** How often stats are logged. */
+			constexpr static auto reportInterval = std::chrono::seconds{5};
+
+		private:
+			Engine::Net::LoopbackNetwork network;
+			const Engine::Net::PacketCodec codec;
+			std::vector<std::unique_ptr<BotClient>> bots;
+			uint32 botCount;
+
+			Engine::Clock::TimePoint lastReport = {};
+			Engine::Clock::Duration tickTimeTotal = {};
+			Engine::Clock::Duration tickTimeMax = {};
+			uint32 tickCount = 0;
+
+			/** Message stats as of the last report. */
+			std::array<BotClient::MessageStats, MessageType::_count> lastStats = {};
+			uint64 lastBytesRecv = 0;
+
+		public:
+			LoadTest(uint32 botCount);
+			LoadTest(const LoadTest&) = delete;
+
+			ENGINE_INLINE auto& getNetwork() noexcept { return network; }
+
+			/**
+			 * Updates all bots. Should be called once per frame after the world has run.
+			 * @param world The server world.
+			 * @param frameTime The time taken to run the world this frame.
+			 */
+			void update(World& world, Engine::Clock::Duration frameTime);
+
+		private:
+			void report();
+	};
+}
@@ -1,14 +1,25 @@
 #pragma once
 
 // STD
+#include <array>
+#include <bit>
+#include <cstring>
 #include <type_traits>
+#include <vector>
+
+#if defined(_M_X64) || defined(__SSE2__)
+	#include <immintrin.h>
+	#define GAME_RLE_SIMD 1
+#else
+	#define GAME_RLE_SIMD 0
+#endif
 
 // GLM
 #include <glm/glm.hpp>
 
 // Game
+#include <Game/common.hpp>
 #include <Game/BlockMeta.hpp>
-#include <Game/systems/PhysicsSystem.hpp>
 
 
 // TODO: Doc
@@ -47,7 +58,62 @@ namespace Game {
 			}
 
 			// TODO: move RLE data to active chunk data instead on MapChunk. we only need it if it is active.
+			/**
+			 * Run length encodes the chunk data.
+			 * Runs of length one are stored as a single BlockId with RLE_COUNT_BIT set,
+			 * all other runs are stored as a RLEPair.
+			 */
 			void toRLE(std::vector<byte>& encoding) const {
+				#if GAME_RLE_SIMD
+					toRLE_SIMD(encoding);
+				#else
+					toRLE_Scalar(encoding);
+				#endif
+			}
+
+			/**
+			 * Decodes run length encoded data produced by toRLE.
+			 * BlockId::None runs are skipped and do not modify the existing data.
+			 * @return True if any block was changed.
+			 */
+			bool fromRLE(const byte* begin, const byte* end) {
+				constexpr auto sz = chunkSize.x * chunkSize.y;
+				bool editMade = false;
+				BlockId* linear = &data[0][0];
+				BlockId* const stop = linear + sz;
+
+				while (begin != end) {
+					BlockId bid;
+					uint16 count = 1;
+					memcpy(&bid, begin, sizeof(bid));
+					begin += sizeof(bid);
+
+					if (bid & RLE_COUNT_BIT) {
+						bid ^= RLE_COUNT_BIT;
+					} else {
+						memcpy(&count, begin, sizeof(count));
+						begin += sizeof(count);
+					}
+
+					ENGINE_DEBUG_ASSERT(count <= stop - linear, "Invalid RLE data. Run extends past the end of the chunk.");
+					BlockId* const runEnd = linear + count;
+
+					if (bid != BlockId::None) {
+						editMade = editMade || (std::find_if(linear, runEnd, [bid](BlockId cur){ return cur != bid; }) != runEnd);
+						std::fill(linear, runEnd, bid);
+					}
+
+					linear = runEnd;
+				}
+
+				return editMade;
+			}
+
+			/**
+			 * Reference implementation of toRLE.
+			 * Used as a fallback when SIMD is unavailable and for validation.
+			 */
+			void toRLE_Scalar(std::vector<byte>& encoding) const {
 				encoding.clear();
 
 				constexpr auto sz = chunkSize.x * chunkSize.y;
@@ -91,38 +157,62 @@ namespace Game {
 				//	ENGINE_LOG2("Compression Ratio: {:4}.{}", ratio.quot, ratio.rem);
 				//}
 			}
-			
-			bool fromRLE(const byte* begin, const byte* end) {
-				bool editMade = false;
-				BlockId* linear = &data[0][0];
-				RLEPair pair;
 
-				int i = 0;
-				while (begin != end) {
-					ENGINE_DEBUG_ASSERT(i < chunkSize.x * chunkSize.y);
-					pair.bid = *reinterpret_cast<const decltype(pair.bid)*>(begin);
-					begin += sizeof(pair.bid);
+		#if GAME_RLE_SIMD
+			/**
+			 * SSE2 implementation of toRLE.
+			 * Finds run boundaries eight blocks at a time by comparing each block to
+			 * its predecessor. The output is byte identical to toRLE_Scalar.
+			 */
+			void toRLE_SIMD(std::vector<byte>& encoding) const {
+				constexpr int32 sz = chunkSize.x * chunkSize.y;
+				constexpr int32 lanes = sizeof(__m128i) / sizeof(BlockId);
+				static_assert(sizeof(BlockId) == 2, "SIMD RLE assumes 16 bit block ids.");
 
-					if (pair.bid & RLE_COUNT_BIT) {
-						pair.bid ^= RLE_COUNT_BIT;
-						pair.count = 1;
+				// Every run is at most two bytes per block: a single is two bytes and a pair is four bytes for two or more blocks.
+				encoding.resize(sz * sizeof(BlockId));
+
+				const BlockId* linear = &data[0][0];
+				byte* out = encoding.data();
+				int32 runStart = 0;
+
+				const auto emit = [&](int32 runEnd) ENGINE_INLINE {
+					const auto count = runEnd - runStart;
+					if (count == 1) {
+						const BlockId bid = linear[runStart] | RLE_COUNT_BIT;
+						memcpy(out, &bid, sizeof(bid));
+						out += sizeof(bid);
 					} else {
-						pair.count = *reinterpret_cast<const decltype(pair.count)*>(begin);
-						begin += sizeof(pair.count);
+						const RLEPair pair = {
+							.bid = linear[runStart],
+							.count = static_cast<uint16>(count),
+						};
+						memcpy(out, &pair, sizeof(pair));
+						out += sizeof(pair);
 					}
+					runStart = runEnd;
+				};
 
-					while (pair.count) {
-						if (pair.bid != BlockId::None) {
-							editMade = editMade || (linear[i] == pair.bid);
-							linear[i] = pair.bid;
-						}
+				int32 i = 1;
+				for (; i + lanes <= sz; i += lanes) {
+					const auto cur = _mm_loadu_si128(reinterpret_cast<const __m128i*>(linear + i));
+					const auto prev = _mm_loadu_si128(reinterpret_cast<const __m128i*>(linear + i - 1));
 
-						++i;
-						--pair.count;
+					// One bit per lane (the low byte's bit) set for each block that starts a new run.
+					uint32 starts = ~static_cast<uint32>(_mm_movemask_epi8(_mm_cmpeq_epi16(cur, prev))) & 0x5555;
+					while (starts) {
+						emit(i + std::countr_zero(starts) / 2);
+						starts &= starts - 1;
 					}
 				}
 
-				return editMade;
+				for (; i < sz; ++i) {
+					if (linear[i] != linear[i - 1]) { emit(i); }
+				}
+
+				emit(sz);
+				encoding.resize(out - encoding.data());
 			}
+		#endif
 	};
 }
@@ -36,6 +36,25 @@ namespace Game {
 			static void read(T& obj, Engine::Net::BufferReader& buff, EngineInstance& engine, World& world, Engine::ECS::Entity ent) {
 				static_assert(!sizeof(T), "NetworkTraits::read must be implemented for type T.");
 			}
+
+			// Replication::UPDATE also requires the following. @see HasNetworkDelta
+			//
+			// Updates are only considered when World::getModifiedStamp changes. Either specialize
+			// Engine::ECS::IsModifiedTracked for the component or call World::markModified after
+			// every change.
+			//
+			// The networked state of a component. Updates are written as the difference from the
+			// last state sent to a connection. Must be trivially copyable, equality comparable and no
+			// larger than NeighborData::maxBaselineSize.
+			//     using Baseline = ...;
+			//
+			//     static Baseline toBaseline(const T& obj, EngineInstance& engine, World& world, Engine::ECS::Entity ent);
+			//
+			// Writes the fields of `curr` that differ from `prev`. If `prev` is null all fields are written.
+			// Engine::Net::Delta implements the encoding for both writeDelta and readDelta.
+			//     static void writeDelta(const Baseline& curr, const Baseline* prev, Engine::Net::StaticBufferWriter& buff);
+			//
+			//     static void readDelta(T& obj, Engine::Net::BufferReader& buff, EngineInstance& engine, World& world, Engine::ECS::Entity ent);
 	};
 
 	template<class T>
@@ -43,6 +62,14 @@ namespace Game {
 		special;
 	};
 
+	/**
+	 * Checks if a component supports delta updates for Replication::UPDATE.
+	 */
+	template<class T>
+	concept HasNetworkDelta = IsNetworkedComponent<T> && requires {
+		typename NetworkTraits<T>::Baseline;
+	};
+
 	template<class F>
 	constexpr static inline bool IsNetworkedFlag = false;
 }
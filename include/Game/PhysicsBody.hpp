@@ -12,13 +12,11 @@ namespace Game {
 	class ZoneInfo {
 		public:
 			ZoneId id = zoneInvalidId;
-
-			// TODO: should probably be a temp DS on the manager.
-			ZoneId group = zoneInvalidId;
 	};
 
 	class PhysicsBody {
 		private:
+			friend class PhysicsSystem;
 			b2Body* body = nullptr;
 
 			// TODO: need to handle networking
@@ -44,6 +42,9 @@ namespace Game {
 			 * Unlike moveZone this does not take the zone offsets into account and does not
 			 * actually change the transform.
 			 *
+			 * If each zone has its own physics world the body stays in its current world until
+			 * PhysicsSystem::updateZoneWorld is called.
+			 *
 			 * @see moveZone
 			 */
 			void setZone(ZoneId zoneId);
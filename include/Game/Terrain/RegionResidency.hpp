@@ -0,0 +1,118 @@
+#pragma once
+
+// Engine
+#include <Engine/Clock.hpp>
+#include <Engine/FlatHashMap.hpp>
+
+// Game
+#include <Game/universal.hpp>
+
+
+namespace Game::Terrain {
+	/**
+	 * Tracks which regions are in use and decides when they should be unloaded.
+	 *
+	 * Regions are kept while in use. Once unused they are unloaded after a timeout, or
+	 * sooner if over budget. Unloads are done oldest first and are rate limited to avoid
+	 * hitches when many regions become unused at once.
+	 */
+	class RegionResidency {
+		public:
+			using TimePoint = Engine::Clock::TimePoint;
+			using Duration = Engine::Clock::Duration;
+
+			class Config {
+				public:
+					/** How long a region must be unused before it is unloaded. */
+					Duration timeout;
+
+					/** How long a region must be unused before it is unloaded when over budget. */
+					Duration minTimeout;
+
+					/** The maximum number of regions to unload per update. */
+					uint32 maxUnloads;
+
+					/** The target maximum number of resident regions. */
+					uint32 budget;
+			};
+
+			class Stats {
+				public:
+					/** The number of tracked regions. */
+					uint32 resident = 0;
+
+					/** The number of regions past their timeout that are still waiting to be unloaded. */
+					uint32 pending = 0;
+
+					/** The number of regions unloaded in the last update. */
+					uint32 unloaded = 0;
+
+					/** The total number of regions unloaded. */
+					uint64 unloadedTotal = 0;
+			};
+
+		private:
+			class Candidate {
+				public:
+					TimePoint lastUsed;
+					UniversalRegionCoord regionCoord;
+			};
+
+			Engine::FlatHashMap<UniversalRegionCoord, TimePoint> lastUsed;
+			std::vector<Candidate> candidates;
+			Stats stats;
+
+		public:
+			/**
+			 * Marks a region as used.
+			 */
+			ENGINE_INLINE void touch(const UniversalRegionCoord regionCoord, const TimePoint now) {
+				lastUsed[regionCoord] = now;
+			}
+
+			/**
+			 * Unloads regions that have been unused for too long.
+			 * @param unload Called with the coordinate of each region that should be unloaded.
+			 */
+			void update(const TimePoint now, const Config& config, auto&& unload) {
+				const auto timeout = now - config.timeout;
+				const auto minTimeout = now - config.minTimeout;
+
+				candidates.clear();
+				for (const auto& [regionCoord, used] : lastUsed) {
+					if (used < minTimeout) {
+						candidates.push_back({used, regionCoord});
+					}
+				}
+
+				// Only the oldest maxUnloads candidates can be unloaded this update.
+				const auto count = std::min<uintz>(config.maxUnloads, candidates.size());
+				std::ranges::partial_sort(candidates, candidates.begin() + count, {}, &Candidate::lastUsed);
+
+				auto resident = static_cast<uint32>(lastUsed.size());
+				stats.unloaded = 0;
+
+				for (uintz i = 0; i < count; ++i) {
+					const auto& candidate = candidates[i];
+					const bool expired = candidate.lastUsed < timeout;
+					const bool overBudget = resident > config.budget;
+
+					// Candidates are sorted oldest first so no later candidates can be unloaded either.
+					if (!expired && !overBudget) { break; }
+
+					unload(candidate.regionCoord);
+					lastUsed.erase(candidate.regionCoord);
+					--resident;
+					++stats.unloaded;
+				}
+
+				stats.resident = resident;
+				stats.unloadedTotal += stats.unloaded;
+				stats.pending = static_cast<uint32>(std::ranges::count_if(candidates.begin() + stats.unloaded, candidates.end(), [&](const Candidate& candidate){
+					return candidate.lastUsed < timeout;
+				}));
+			}
+
+			ENGINE_INLINE const Stats& getStats() const noexcept { return stats; }
+	};
+}
@@ -0,0 +1,444 @@
+#pragma once
+
+// STD
+#include <deque>
+#include <vector>
+
+// Engine
+#include <Engine/FlatHashMap.hpp>
+#include <Engine/ECS/Entity.hpp>
+#include <Engine/Math/math.hpp>
+
+// Game
+#include <Game/common.hpp>
+
+
+namespace Game {
+	/**
+	 * Groups players that need to share a zone. Two players in the same realm
+	 * within zoneMustJoinDist of each other are joined and a group is every
+	 * player connected by joins.
+	 *
+	 * A uniform grid is used as a broad phase so only players in the same or
+	 * adjacent cells are compared.
+	 *
+	 * Grouping is incremental. The joins for a player are only re-evaluated
+	 * once it has moved more than the move threshold from where it was last
+	 * evaluated. Joins merge groups immediately. Removed joins only mark the
+	 * group to be checked for splits later. Both kinds of work are limited by
+	 * a budget per call to process. Once all queued work is processed the
+	 * groups are the same as grouping every player from scratch using the
+	 * positions they were last evaluated at.
+	 *
+	 * Realm changes are always evaluated immediately since players in
+	 * different realms can never share a zone.
+	 */
+	class ZoneClusterer {
+		public:
+			/** Cells are the size of the join distance so joined players are always in the same or adjacent cells. */
+			constexpr static WorldAbsUnit cellSize = zoneMustJoinDist;
+
+			/**
+			 * The distance metric used for joins.
+			 * - Using Euclidean is bad because we need to take a square root.
+			 * - Using squared Euclidean is bad because it greatly limits our world size to sqrt(INT_MAX)
+			 * - Chebyshev or Manhattan should be fine.
+			 *
+			 * Manhattan is used to have less aggressive merges.
+			 */
+			ENGINE_INLINE constexpr static WorldAbsUnit metric(const WorldAbsVec a, const WorldAbsVec b) noexcept {
+				const auto d = a - b;
+				return (d.x < 0 ? -d.x : d.x) + (d.y < 0 ? -d.y : d.y);
+			}
+
+			class Player {
+				public:
+					Engine::ECS::Entity ent = {};
+
+					/** The realm and position the joins for this player were last evaluated at. */
+					RealmId realmId = {};
+					WorldAbsVec pos = {};
+
+					/** The most recent realm and position given to update. */
+					RealmId nextRealmId = {};
+					WorldAbsVec nextPos = {};
+
+					/** The group of this player or -1 if it hasn't been evaluated yet. */
+					int32 group = -1;
+
+					/** The index of this player in its group and cell. */
+					int32 groupIndex = -1;
+					int32 cellIndex = -1;
+
+					/** The players this player is joined with. */
+					std::vector<int32> links;
+
+					/** The last update this player was seen in. @see endUpdate */
+					uint32 seen = 0;
+
+					/** The last split check this player was visited in. @see checkSplit */
+					uint32 visited = 0;
+
+					bool queued = false;
+			};
+
+			class Group {
+				public:
+					std::vector<int32> members;
+					bool queued = false;
+			};
+
+		private:
+			class Cell {
+				public:
+					RealmId realmId;
+					WorldAbsVec pos;
+					ENGINE_INLINE bool operator==(const Cell&) const noexcept = default;
+			};
+
+			class CellHash {
+				public:
+					[[nodiscard]] ENGINE_INLINE uintz operator()(const Cell& cell) const noexcept {
+						uintz result = Engine::hash(cell.pos);
+						Engine::hashCombine(result, cell.realmId);
+						return result;
+					}
+			};
+
+			std::vector<Player> players;
+			std::vector<int32> freePlayers;
+
+			/** The index in players for each entity id or -1. */
+			std::vector<int32> lookup;
+
+			std::vector<Group> groups;
+			std::vector<int32> freeGroups;
+
+			/** Indexes into players for each cell. Only includes evaluated players. */
+			Engine::FlatHashMap<Cell, std::vector<int32>, CellHash> cells;
+
+			/** Players to re-evaluate. May contain stale entries. @see Player::queued */
+			std::deque<int32> moveQueue;
+
+			/** Groups to check for splits. May contain stale entries. @see Group::queued */
+			std::deque<int32> splitQueue;
+
+			/** Scratch space for checkSplit. */
+			std::vector<int32> splitMembers;
+			std::vector<int32> splitStack;
+
+			WorldAbsUnit moveThreshold = 0;
+			uint32 updateCount = 0;
+			uint32 splitCount = 0;
+
+		public:
+			/**
+			 * Sets how far a player needs to move before its joins are re-evaluated.
+			 * Zero re-evaluates any player that moves at all.
+			 */
+			ENGINE_INLINE void setMoveThreshold(WorldAbsUnit threshold) noexcept { moveThreshold = threshold; }
+
+			/**
+			 * Begins a new update. Any player not given to update before the
+			 * matching call to endUpdate is removed.
+			 */
+			ENGINE_INLINE void beginUpdate() noexcept { ++updateCount; }
+
+			/**
+			 * Adds or updates a player.
+			 */
+			void update(Engine::ECS::Entity ent, RealmId realmId, WorldAbsVec pos) {
+				if (ent.id >= lookup.size()) {
+					lookup.resize(ent.id + 1, -1);
+				}
+
+				auto& slot = lookup[ent.id];
+				if (slot != -1 && players[slot].ent != ent) {
+					// Id reused without removing the old entity.
+					remove(slot);
+				}
+
+				if (slot == -1) {
+					slot = createPlayer(ent);
+				}
+
+				const auto i = slot;
+				auto& ply = players[i];
+				ply.seen = updateCount;
+				ply.nextRealmId = realmId;
+				ply.nextPos = pos;
+
+				if (ply.group != -1 && ply.realmId != realmId) {
+					evaluate(i);
+				} else if (!ply.queued && (ply.group == -1 || metric(ply.pos, pos) > moveThreshold)) {
+					ply.queued = true;
+					moveQueue.push_back(i);
+				}
+			}
+
+			/**
+			 * Removes any players not updated since the last call to beginUpdate.
+			 */
+			void endUpdate() {
+				for (int32 i = 0; i < std::ssize(players); ++i) {
+					const auto& ply = players[i];
+					if (ply.ent && ply.seen != updateCount) {
+						remove(i);
+					}
+				}
+			}
+
+			/**
+			 * Processes queued work. Each re-evaluated player costs one unit and
+			 * each split check costs one unit per player in the group.
+			 * @param budget The maximum amount of work to do. Work is not split
+			 *        so a single split check can go over the budget.
+			 */
+			void process(int64 budget) {
+				int64 work = 0;
+
+				// Give moves the first half of the budget so splits can't be starved.
+				const auto processMoves = [&](int64 limit){
+					while (!moveQueue.empty() && work < limit) {
+						const auto i = moveQueue.front();
+						moveQueue.pop_front();
+						if (!players[i].queued) { continue; }
+						evaluate(i);
+						++work;
+					}
+				};
+
+				processMoves(budget / 2);
+
+				while (!splitQueue.empty() && work < budget) {
+					const auto g = splitQueue.front();
+					splitQueue.pop_front();
+					if (!groups[g].queued) { continue; }
+					work += std::ssize(groups[g].members);
+					checkSplit(g);
+				}
+
+				processMoves(budget);
+			}
+
+			/** Checks if there is no queued work. */
+			ENGINE_INLINE bool idle() const noexcept { return moveQueue.empty() && splitQueue.empty(); }
+
+			/**
+			 * All groups. Unused groups have no members.
+			 * Players are not in a group until they have been evaluated.
+			 */
+			ENGINE_INLINE const auto& getGroups() const noexcept { return groups; }
+
+			ENGINE_INLINE const Player& getPlayer(int32 i) const noexcept { return players[i]; }
+
+		private:
+			ENGINE_INLINE static Cell toCell(RealmId realmId, WorldAbsVec pos) noexcept {
+				return {realmId, Engine::Math::divFloor(pos, cellSize).q};
+			}
+
+			int32 createPlayer(Engine::ECS::Entity ent) {
+				int32 i;
+				if (freePlayers.empty()) {
+					i = static_cast<int32>(players.size());
+					players.emplace_back();
+				} else {
+					i = freePlayers.back();
+					freePlayers.pop_back();
+				}
+
+				players[i].ent = ent;
+				return i;
+			}
+
+			int32 createGroup() {
+				if (freeGroups.empty()) {
+					groups.emplace_back();
+					return static_cast<int32>(groups.size() - 1);
+				}
+
+				const auto g = freeGroups.back();
+				freeGroups.pop_back();
+				return g;
+			}
+
+			void freeGroup(int32 g) {
+				auto& group = groups[g];
+				group.members.clear();
+				group.queued = false;
+				freeGroups.push_back(g);
+			}
+
+			void addToGroup(int32 i, int32 g) {
+				auto& members = groups[g].members;
+				players[i].group = g;
+				players[i].groupIndex = static_cast<int32>(members.size());
+				members.push_back(i);
+			}
+
+			void removeFromGroup(int32 i) {
+				auto& ply = players[i];
+				auto& members = groups[ply.group].members;
+				if (ply.groupIndex + 1 != std::ssize(members)) {
+					members[ply.groupIndex] = members.back();
+					players[members[ply.groupIndex]].groupIndex = ply.groupIndex;
+				}
+				members.pop_back();
+
+				if (members.empty()) { freeGroup(ply.group); }
+				ply.group = -1;
+				ply.groupIndex = -1;
+			}
+
+			void queueSplit(int32 g) {
+				auto& group = groups[g];
+				if (group.queued) { return; }
+				group.queued = true;
+				splitQueue.push_back(g);
+			}
+
+			void addToCell(int32 i) {
+				auto& ply = players[i];
+				auto& entries = cells[toCell(ply.realmId, ply.pos)];
+				ply.cellIndex = static_cast<int32>(entries.size());
+				entries.push_back(i);
+			}
+
+			void removeFromCell(int32 i) {
+				auto& ply = players[i];
+				const auto found = cells.find(toCell(ply.realmId, ply.pos));
+				ENGINE_DEBUG_ASSERT(found != cells.end(), "Missing zone clusterer cell. This is a bug.");
+
+				auto& entries = found->second;
+				if (ply.cellIndex + 1 != std::ssize(entries)) {
+					entries[ply.cellIndex] = entries.back();
+					players[entries[ply.cellIndex]].cellIndex = ply.cellIndex;
+				}
+				entries.pop_back();
+
+				if (entries.empty()) { cells.erase(found); }
+				ply.cellIndex = -1;
+			}
+
+			/**
+			 * Removes all joins for a player. The group is checked for splits later.
+			 */
+			void unlink(int32 i) {
+				auto& ply = players[i];
+				if (ply.links.empty()) { return; }
+
+				for (const auto other : ply.links) {
+					auto& links = players[other].links;
+					const auto found = std::ranges::find(links, i);
+					ENGINE_DEBUG_ASSERT(found != links.end(), "Missing zone clusterer link. This is a bug.");
+					*found = links.back();
+					links.pop_back();
+				}
+
+				ply.links.clear();
+				queueSplit(ply.group);
+			}
+
+			void remove(int32 i) {
+				auto& ply = players[i];
+				if (ply.group != -1) {
+					unlink(i);
+					removeFromCell(i);
+					removeFromGroup(i);
+				}
+
+				lookup[ply.ent.id] = -1;
+				ply = {};
+				freePlayers.push_back(i);
+			}
+
+			/**
+			 * Recomputes the joins for a player at its most recent position.
+			 */
+			void evaluate(int32 i) {
+				auto& ply = players[i];
+				ply.queued = false;
+
+				if (ply.group == -1) {
+					ply.realmId = ply.nextRealmId;
+					ply.pos = ply.nextPos;
+					addToGroup(i, createGroup());
+					addToCell(i);
+				} else {
+					unlink(i);
+					const auto oldCell = toCell(ply.realmId, ply.pos);
+					const auto newCell = toCell(ply.nextRealmId, ply.nextPos);
+					if (oldCell != newCell) { removeFromCell(i); }
+					ply.realmId = ply.nextRealmId;
+					ply.pos = ply.nextPos;
+					if (oldCell != newCell) { addToCell(i); }
+				}
+
+				const auto cell = toCell(ply.realmId, ply.pos);
+				for (Cell other = {cell.realmId, {0, cell.pos.y - 1}}; other.pos.y <= cell.pos.y + 1; ++other.pos.y) {
+					for (other.pos.x = cell.pos.x - 1; other.pos.x <= cell.pos.x + 1; ++other.pos.x) {
+						const auto found = cells.find(other);
+						if (found == cells.end()) { continue; }
+
+						for (const auto j : found->second) {
+							if (j == i) { continue; }
+							if (metric(ply.pos, players[j].pos) > zoneMustJoinDist) { continue; }
+							ply.links.push_back(j);
+							players[j].links.push_back(i);
+							merge(ply.group, players[j].group);
+						}
+					}
+				}
+			}
+
+			void merge(int32 a, int32 b) {
+				if (a == b) { return; }
+
+				// Move the smaller group so each player is moved at most log(n) times.
+				if (groups[a].members.size() < groups[b].members.size()) { std::swap(a, b); }
+
+				// Any pending split check still applies to the merged group.
+				if (groups[b].queued) { queueSplit(a); }
+
+				for (const auto i : groups[b].members) {
+					addToGroup(i, a);
+				}
+
+				freeGroup(b);
+			}
+
+			/**
+			 * Splits a group into the players still connected by joins.
+			 */
+			void checkSplit(int32 g) {
+				groups[g].queued = false;
+				++splitCount;
+
+				splitMembers.assign(groups[g].members.begin(), groups[g].members.end());
+				groups[g].members.clear();
+
+				// The first component keeps the existing group.
+				int32 group = g;
+				for (const auto start : splitMembers) {
+					if (players[start].visited == splitCount) { continue; }
+					if (group == -1) { group = createGroup(); }
+
+					players[start].visited = splitCount;
+					splitStack.push_back(start);
+					while (!splitStack.empty()) {
+						const auto i = splitStack.back();
+						splitStack.pop_back();
+						addToGroup(i, group);
+
+						for (const auto j : players[i].links) {
+							if (players[j].visited == splitCount) { continue; }
+							players[j].visited = splitCount;
+							splitStack.push_back(j);
+						}
+					}
+
+					group = -1;
+				}
+			}
+	};
+}
@@ -155,6 +155,14 @@ namespace Game::inline Constants {
 
 	static_assert(zoneMustSplitDist - zoneMustJoinDist > 10, "The zone split distance must be significantly larger than the join distance.");
 
+	/**
+	 * The maximum distance of a position (WorldUnit) from its zone offset. Used to
+	 * bound quantized network positions. Zones are split well before this.
+	 */
+	constexpr inline WorldUnit zonePositionRange = 4096;
+
+	static_assert(zonePositionRange > 2 * zoneMustSplitDist, "The zone position range must comfortably contain any zone.");
+
 	// If this wasn't true then you could theoretically run into instances where neighbor
 	// entities are moved to both zones.
 	static_assert(zoneMustJoinDist > 2*neighborRangePersist, "The zone join distance should be at minimum twice as large as the neighbor persist distance");
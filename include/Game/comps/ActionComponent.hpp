@@ -1,12 +1,18 @@
 #pragma once
 
+// STD
+#include <algorithm>
+#include <bit>
+#include <limits>
+#include <utility>
+
 // Engine
 #include <Engine/ECS/ecs.hpp>
+#include <Engine/Net/BufferWriter.hpp>
 #include <Engine/SequenceBuffer.hpp>
 
 // Game
 #include <Game/Common.hpp>
-#include <Game/Connection.hpp>
 
 
 namespace Game {
@@ -50,17 +56,183 @@ namespace Game {
 			ActionValue buttons[static_cast<int32>(Action::_button_count)];
 			glm::vec2 target;
 
-			void netRead(Engine::Net::BufferReader& msg) {
+			/** The number of consecutive unchanged states that can be encoded as a single run. @see netWriteWindow */
+			constexpr static int32 maxRun = 16;
+
+			void netWrite(auto& msg) const {
+				for (const auto& b : buttons) {
+					netWrite(msg, b);
+				}
+
+				// TODO: compress. we dont need 32 bits here.
+				// TODO: if you compress this make sure to replicate on client to remain in sync
+				msg.template write<32>(std::bit_cast<uint32>(target.x));
+				msg.template write<32>(std::bit_cast<uint32>(target.y));
+			}
+
+			bool netRead(Engine::Net::BufferReader& msg) {
+				bool ok = true;
 				for (auto& b : buttons) {
-					msg.readBits<2>(&b.pressCount);
-					msg.readBits<2>(&b.releaseCount);
-					msg.readBits<1>(&b.latest);
+					ok = ok && netRead(msg, b);
+				}
+
+				uint32 x = 0;
+				uint32 y = 0;
+				ok = ok && msg.readBits<32>(&x) && msg.readBits<32>(&y);
+				target.x = std::bit_cast<float32>(x);
+				target.y = std::bit_cast<float32>(y);
+				return ok;
+			}
+
+			/**
+			 * Writes only the values that differ from @p prev. Each button and
+			 * the target have a single bit flag for if they changed.
+			 */
+			void netWriteDelta(auto& msg, const ActionState& prev) const {
+				for (int32 i = 0; i < std::ssize(buttons); ++i) {
+					const bool changed = !netEqual(buttons[i], prev.buttons[i]);
+					msg.template write<1>(changed);
+					if (changed) { netWrite(msg, buttons[i]); }
+				}
+
+				const bool changed = !netEqual(target, prev.target);
+				msg.template write<1>(changed);
+				if (changed) {
+					msg.template write<32>(std::bit_cast<uint32>(target.x));
+					msg.template write<32>(std::bit_cast<uint32>(target.y));
+				}
+			}
+
+			/**
+			 * Reads the values written by netWriteDelta. Unchanged values are copied from @p prev.
+			 */
+			bool netReadDelta(Engine::Net::BufferReader& msg, const ActionState& prev) {
+				bool ok = true;
+				for (int32 i = 0; i < std::ssize(buttons); ++i) {
+					bool changed = false;
+					ok = ok && msg.readBits<1>(&changed);
+					if (!ok) { break; }
+					if (changed) {
+						ok = netRead(msg, buttons[i]);
+					} else {
+						buttons[i] = prev.buttons[i];
+					}
+				}
+
+				bool changed = false;
+				ok = ok && msg.readBits<1>(&changed);
+				if (ok && changed) {
+					uint32 x = 0;
+					uint32 y = 0;
+					ok = msg.readBits<32>(&x) && msg.readBits<32>(&y);
+					target.x = std::bit_cast<float32>(x);
+					target.y = std::bit_cast<float32>(y);
+				} else {
+					target = prev.target;
+				}
+				return ok;
+			}
+
+			/**
+			 * Checks if two states are networked the same. Only compares the networked values.
+			 */
+			bool netEqual(const ActionState& other) const noexcept {
+				for (int32 i = 0; i < std::ssize(buttons); ++i) {
+					if (!netEqual(buttons[i], other.buttons[i])) { return false; }
+				}
+				return netEqual(target, other.target);
+			}
+
+			/**
+			 * Writes a window of @p count consecutive states, oldest first. The
+			 * first state is written in full and the rest are delta coded against
+			 * the one before them. Runs of unchanged states are run length encoded.
+			 * @param get Called with the age of a state to get that state. The newest state has an age of zero.
+			 */
+			static void netWriteWindow(auto& msg, int32 count, auto&& get) {
+				ENGINE_DEBUG_ASSERT(0 < count && count <= std::numeric_limits<uint8>::max());
+				msg.template write<8>(count);
+
+				const ActionState* prev = &get(count - 1);
+				prev->netWrite(msg);
+
+				for (int32 age = count - 2; age >= 0;) {
+					const ActionState& curr = get(age);
+					if (curr.netEqual(*prev)) {
+						int32 run = 1;
+						while (run < maxRun && age - run >= 0 && get(age - run).netEqual(*prev)) { ++run; }
+						msg.template write<1>(0);
+						msg.template write<4>(run - 1);
+						age -= run;
+					} else {
+						msg.template write<1>(1);
+						curr.netWriteDelta(msg, *prev);
+						prev = &curr;
+						--age;
+					}
 				}
+			}
+
+			/**
+			 * Reads a window written by netWriteWindow.
+			 * @param maxCount The largest window to accept.
+			 * @param func Called with the age and value of each state in the window, oldest first.
+			 * @return False if the window is malformed. Some states may have already been passed to @p func.
+			 */
+			static bool netReadWindow(Engine::Net::BufferReader& msg, int32 maxCount, auto&& func) {
+				int32 count = 0;
+				if (!msg.readBits<8>(&count) || count == 0 || count > maxCount) { return false; }
+
+				ActionState prev = {};
+				if (!prev.netRead(msg)) { return false; }
+				func(count - 1, std::as_const(prev));
+
+				for (int32 age = count - 2; age >= 0;) {
+					bool changed = false;
+					if (!msg.readBits<1>(&changed)) { return false; }
+
+					if (changed) {
+						ActionState curr = {};
+						if (!curr.netReadDelta(msg, prev)) { return false; }
+						prev = curr;
+						func(age--, std::as_const(prev));
+					} else {
+						int32 run = 0;
+						if (!msg.readBits<4>(&run) || run > age) { return false; }
+						for (const auto end = age - run - 1; age > end; --age) { func(age, std::as_const(prev)); }
+					}
+				}
+
+				return true;
+			}
+
+		private:
+			ENGINE_INLINE static void netWrite(auto& msg, const ActionValue& b) {
+				msg.template write<2>(netCount(b.pressCount));
+				msg.template write<2>(netCount(b.releaseCount));
+				msg.template write<1>(b.latest);
+			}
+
+			ENGINE_INLINE static bool netRead(Engine::Net::BufferReader& msg, ActionValue& b) {
+				return msg.readBits<2>(&b.pressCount)
+					&& msg.readBits<2>(&b.releaseCount)
+					&& msg.readBits<1>(&b.latest);
+			}
+
+			/** Counts are only networked with two bits. */
+			ENGINE_INLINE constexpr static uint8 netCount(uint8 count) noexcept {
+				return std::min<uint8>(count, 3);
+			}
+
+			ENGINE_INLINE static bool netEqual(const ActionValue& a, const ActionValue& b) noexcept {
+				return netCount(a.pressCount) == netCount(b.pressCount)
+					&& netCount(a.releaseCount) == netCount(b.releaseCount)
+					&& a.latest == b.latest;
+			}
 
-				const auto x = msg.readBits<32, uint32>();
-				const auto y = msg.readBits<32, uint32>();
-				target.x = reinterpret_cast<const float32&>(x);
-				target.y = reinterpret_cast<const float32&>(y);
+			ENGINE_INLINE static bool netEqual(glm::vec2 a, glm::vec2 b) noexcept {
+				// Compare bits instead of values since that is what is networked.
+				return std::bit_cast<uint64>(a) == std::bit_cast<uint64>(b);
 			}
 	};
 
@@ -38,6 +38,39 @@ namespace Game {
 			};
 			ENGINE_BUILD_ALL_OPS_F(NeighborState, friend);
 
+			/** The largest NetworkTraits::Baseline that can be stored. */
+			constexpr static uintz maxBaselineSize = 64;
+
+			/**
+			 * The last state of a Replication::UPDATE component sent to a connection.
+			 * Updates only include the fields that differ from this.
+			 */
+			class Baseline {
+				public:
+					Engine::ECS::ComponentId cid;
+
+					/** The World::getModifiedStamp of the component when this was stored. */
+					uint64 stamp;
+
+				private:
+					alignas(std::max_align_t) byte data[maxBaselineSize];
+
+				public:
+					template<class B>
+					ENGINE_INLINE const B& as() const noexcept {
+						static_assert(sizeof(B) <= maxBaselineSize, "NetworkTraits::Baseline is too large.");
+						static_assert(std::is_trivially_copyable_v<B>, "NetworkTraits::Baseline must be trivially copyable.");
+						return *reinterpret_cast<const B*>(data);
+					}
+
+					template<class B>
+					ENGINE_INLINE void store(const B& base) noexcept {
+						static_assert(sizeof(B) <= maxBaselineSize, "NetworkTraits::Baseline is too large.");
+						static_assert(std::is_trivially_copyable_v<B>, "NetworkTraits::Baseline must be trivially copyable.");
+						memcpy(data, &base, sizeof(B));
+					}
+			};
+
 			class NeighborData {
 				private:
 					NeighborState state{};
@@ -45,12 +78,63 @@ namespace Game {
 				public:
 					Engine::ECS::ComponentBitset comps{};
 
+					/** Usually only a few components per entity use UPDATE so we don't bother with a map. */
+					std::vector<Baseline> baselines;
+
+					/**
+					 * Accumulated relevance since the last state update was sent. Grows
+					 * faster for closer entities. Neighbors are updated highest first.
+					 */
+					float32 priority = 0;
+
+					/** The number of network updates since the last state update was sent. */
+					int32 updatesSkipped = 0;
+
 				public:
 					ENGINE_INLINE constexpr NeighborData(NeighborState state) : state{state} {}
 					ENGINE_INLINE constexpr NeighborState get() const noexcept { return state; }
 					ENGINE_INLINE constexpr bool test(NeighborState state) const noexcept { return static_cast<bool>(this->state & state); }
 					ENGINE_INLINE constexpr void reset(NeighborState state) noexcept { this->state = state; }
 
+					Baseline* findBaseline(Engine::ECS::ComponentId cid) noexcept {
+						for (auto& base : baselines) {
+							if (base.cid == cid) { return &base; }
+						}
+						return nullptr;
+					}
+
+					ENGINE_INLINE Baseline& addBaseline(Engine::ECS::ComponentId cid) {
+						ENGINE_DEBUG_ASSERT(!findBaseline(cid), "Attempting to add duplicate baseline.");
+						auto& base = baselines.emplace_back();
+						base.cid = cid;
+						return base;
+					}
+
+					/**
+					 * Writes the changes to a Replication::UPDATE component since its baseline and
+					 * then makes the current state the new baseline.
+					 * @param stamp The World::getModifiedStamp of the component. Nothing is written if it matches the baseline.
+					 * @param getCurr Gets the current NetworkTraits::Baseline. Only called if the stamp has changed.
+					 * @param write Called as `write(curr, prev)` if the state has changed. `prev` is null
+					 *        if there is no baseline yet. Returns false if the delta could not be written.
+					 * @return False if @p write failed. The baseline is unchanged so the delta is tried again next time.
+					 */
+					template<class GetCurr, class Write>
+					bool updateBaseline(Engine::ECS::ComponentId cid, uint64 stamp, GetCurr&& getCurr, Write&& write) {
+						auto* base = findBaseline(cid);
+						if (base && base->stamp == stamp) { return true; }
+
+						using B = decltype(getCurr());
+						const B curr = getCurr();
+						const B* prev = base ? &base->as<B>() : nullptr;
+						if ((!prev || !(*prev == curr)) && !write(curr, prev)) { return false; }
+
+						if (!base) { base = &addBaseline(cid); }
+						base->stamp = stamp;
+						base->store(curr);
+						return true;
+					}
+
 					ENGINE_INLINE constexpr void zoneChanged() noexcept {
 						state |= NeighborState::ZoneChanged;
 					}
@@ -3,6 +3,9 @@
 // Box2D
 #include <Box2D/Box2D.h>
 
+// Engine
+#include <Engine/Net/Quantize.hpp>
+
 // Game
 #include <Game/common.hpp>
 #include <Game/NetworkTraits.hpp>
@@ -77,6 +80,16 @@ namespace Engine::ECS {
 namespace Game {
 	template<>
 	class NetworkTraits<PhysicsBodyComponent> {
+		private:
+			/** Positions are relative to the zone offset. @see zonePositionRange */
+			constexpr static Engine::Net::QuantizedFloat positionQuant{-zonePositionRange, zonePositionRange, 1.0f / 1000.0f};
+			constexpr static Engine::Net::QuantizedFloat angleQuant{-b2_pi, b2_pi, 1.0f / 512.0f};
+			constexpr static Engine::Net::QuantizedFloat velocityQuant{-128.0f, 128.0f, 1.0f / 100.0f};
+
+			/** Writes the quantized state, or the exact state if it is outside of the quantized ranges. */
+			static void writeState(const b2Transform& trans, const b2Vec2& vel, Engine::Net::StaticBufferWriter& buff);
+			static bool readState(b2Transform& trans, b2Vec2& vel, Engine::Net::BufferReader& buff);
+
 		public:
 			static Engine::Net::Replication getReplType(const PhysicsBodyComponent& obj) {
 				return (obj.getType() == b2_staticBody) ? Engine::Net::Replication::ONCE : Engine::Net::Replication::ALWAYS;
@@ -89,8 +102,10 @@ namespace Game {
 			static void read(PhysicsBodyComponent& obj, Engine::Net::BufferReader& buff, EngineInstance& engine, World& world, Engine::ECS::Entity ent);
 
 			static void read(Engine::ECS::SnapshotTraits<PhysicsBodyComponent>::Type& obj, Engine::Net::BufferReader& buff) {
-				buff.read<b2Transform>(&obj.trans);
-				buff.read<b2Vec2>(&obj.vel);
+				if (!readState(obj.trans, obj.vel, buff)) {
+					ENGINE_WARN("Unable to read physics state from network.");
+					return;
+				}
 				obj.rollbackOverride = true;
 
 				// ZoneId isnt relevant to snapshots. Will be handled be the
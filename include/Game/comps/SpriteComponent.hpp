@@ -7,8 +7,10 @@
 #include <glloadgen/gl_core_4_5.hpp>
 
 // Engine
+#include <Engine/ECS/ecs.hpp>
 #include <Engine/Gfx/resources.hpp>
 #include <Engine/Gfx/TextureManager.hpp>
+#include <Engine/Net/Delta.hpp>
 
 // Game
 #include <Game/RenderLayer.hpp>
@@ -24,12 +26,31 @@ namespace Game {
 			glm::vec2 scale = {1.0f, 1.0f};
 			RenderLayer layer = RenderLayer::Foreground;
 	};
+}
+
+/** Sprites use Replication::UPDATE so any write needs to be picked up by EntityNetworkingSystem. */
+template<>
+struct Engine::ECS::IsModifiedTracked<Game::SpriteComponent> : std::true_type {};
 
+namespace Game {
 	template<>
 	class NetworkTraits<SpriteComponent> {
+		public:
+			struct Baseline {
+				uint32 texture;
+				glm::vec2 position;
+				glm::vec2 scale;
+				uint8 layer;
+
+				bool operator==(const Baseline&) const = default;
+			};
+
+		private:
+			using Delta = Engine::Net::Delta<&Baseline::texture, &Baseline::position, &Baseline::scale, &Baseline::layer>;
+
 		public:
 			static Engine::Net::Replication getReplType(const SpriteComponent& obj) {
-				return Engine::Net::Replication::ONCE;
+				return Engine::Net::Replication::UPDATE;
 			}
 
 			static void writeInit(const SpriteComponent& obj, Engine::Net::StaticBufferWriter& buff, EngineInstance& engine, World& world, Engine::ECS::Entity ent) {
@@ -76,5 +97,35 @@ namespace Game {
 			}
 
 			static void read(SpriteComponent& obj, Engine::Net::BufferReader& buff, EngineInstance& engine, World& world, Engine::ECS::Entity ent) {}
+
+			static Baseline toBaseline(const SpriteComponent& obj, EngineInstance& engine, World& world, Engine::ECS::Entity ent) {
+				return {
+					.texture = engine.getTextureId(obj.path),
+					.position = obj.position,
+					.scale = obj.scale,
+					.layer = static_cast<uint8>(obj.layer),
+				};
+			}
+
+			static void writeDelta(const Baseline& curr, const Baseline* prev, Engine::Net::StaticBufferWriter& buff) {
+				Delta::write(curr, prev, buff);
+			}
+
+			static void readDelta(SpriteComponent& obj, Engine::Net::BufferReader& buff, EngineInstance& engine, World& world, Engine::ECS::Entity ent) {
+				Baseline delta = {};
+				Delta::Mask fields;
+				if (!Delta::read(delta, fields, buff)) {
+					ENGINE_WARN("Unable to read sprite update from network.");
+					return;
+				}
+
+				if (fields & Delta::bit<&Baseline::texture>()) {
+					obj.texture = engine.getTextureLoader().get2D(engine.getTexturePath(delta.texture));
+				}
+
+				if (fields & Delta::bit<&Baseline::position>()) { obj.position = delta.position; }
+				if (fields & Delta::bit<&Baseline::scale>()) { obj.scale = delta.scale; }
+				if (fields & Delta::bit<&Baseline::layer>()) { obj.layer = static_cast<RenderLayer>(delta.layer); }
+			}
 	};
 }
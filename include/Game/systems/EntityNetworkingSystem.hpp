@@ -1,10 +1,14 @@
 #pragma once
 
+// STD
+#include <span>
+
 // Engine
 #include <Engine/FlatHashMap.hpp>
 
 // Game
 #include <Game/System.hpp>
+#include <Game/InterestGrid.hpp>
 #include <Game/comps/ECSNetworkingComponent.hpp>
 #include <Game/Connection.hpp>
 
@@ -77,22 +81,81 @@ namespace Game {
 
 		#if ENGINE_SERVER
 		private:
+			class PriorityEntry {
+				public:
+					Engine::ECS::Entity ent;
+					float32 priority;
+
+					/** Ignores the bandwidth budget. Used to guarantee a minimum update rate. */
+					bool forced;
+			};
+
+			class SharedState {
+				public:
+					int32 offset;
+					int32 size;
+			};
+
 			std::vector<Engine::ECS::Entity> zoneChanged = {};
+			std::vector<PriorityEntry> priorities = {};
+
+			/**
+			 * Replication::ALWAYS state written during the current network update. The
+			 * state doesn't depend on the receiver so it is only written once no matter
+			 * how many players it is sent to. Keyed by entity and component id. @see getSharedState
+			 */
+			Engine::FlatHashMap<uint64, SharedState> sharedStateLookup;
+			std::vector<byte> sharedStateData;
+
+			/** Positions of all networked entities. Used to find neighbors. */
+			InterestGrid interestGrid;
 			
 		public:
 			void tick();
 			void network(const NetPlySet plys);
 
+			void onComponentRemoved(const Engine::ECS::Entity ent, class PhysicsBodyComponent& comp);
+
 		private:
+			void updateInterestGrid();
 			void updateNeighbors();
 
 			void processAddedNeighbor(Connection& conn, const Engine::ECS::Entity ent, ECSNetworkingComponent::NeighborData& data);
 			void processRemovedNeighbor(Connection& conn, const Engine::ECS::Entity ent, ECSNetworkingComponent::NeighborData& data);
 			void processCurrentNeighbor(Connection& conn, const Engine::ECS::Entity ent, ECSNetworkingComponent::NeighborData& data);
 
+			/**
+			 * Sends the Replication::ALWAYS and Replication::UPDATE component state for a neighbor.
+			 * @param bytes Incremented by the number of bytes written.
+			 * @return False if any message could not be written, such as when the send queue is full.
+			 */
+			[[nodiscard]]
+			bool processNeighborState(Connection& conn, const Engine::ECS::Entity ent, ECSNetworkingComponent::NeighborData& data, int32& bytes);
+
+			/**
+			 * Sends neighbor state in priority order until the connection's entity budget is used.
+			 */
+			void networkNeighborStates(Connection& conn, const Engine::ECS::Entity ply, ECSNetworkingComponent& ecsNetComp);
+
+			/**
+			 * Gets the Replication::ALWAYS state for a component. Only written the first time it is used each network update.
+			 * Invalidated by the next call.
+			 */
+			template<class C>
+			std::span<const byte> getSharedState(const Engine::ECS::Entity ent, const C& comp);
+
 			template<class C>
 			[[nodiscard]]
 			bool networkComponent(const Engine::ECS::Entity ent, Connection& conn) const;
+
+			/**
+			 * Sends the changes to a Replication::UPDATE component since the last state sent to this neighbor.
+			 * @param bytes Incremented by the number of bytes written.
+			 * @return False if the message could not be written.
+			 */
+			template<class C>
+			[[nodiscard]]
+			bool networkComponentUpdate(const Engine::ECS::Entity ent, Connection& conn, ECSNetworkingComponent::NeighborData& data, int32& bytes);
 		#endif // ENGINE_SERVER
 	};
 }
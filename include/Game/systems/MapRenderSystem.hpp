@@ -6,6 +6,7 @@
 // Game
 #include <Game/Common.hpp>
 #include <Game/MapChunk.hpp>
+#include <Game/System.hpp>
 
 
 namespace Game {
@@ -6,6 +6,7 @@
 #include <queue>
 #include <memory>
 #include <atomic>
+#include <span>
 
 // GLM
 #include <glm/vector_relational.hpp>
@@ -28,6 +29,7 @@
 #include <Game/comps/PhysicsBodyComponent.hpp> // TODO: split physicsbody from componennt
 #include <Game/Terrain/TestGenerator.hpp>
 #include <Game/Terrain/Generator.hpp>
+#include <Game/Terrain/RegionResidency.hpp>
 
 
 // TODO: This documentation and comments are likely out of date since the multiplayer and chunk/region/zone reworks.
@@ -126,20 +128,78 @@ namespace Game {
 					ENGINE_CLIENT_ONLY(MapChunk lastWithEdits());
 			};
 
+			class BlockEdit {
+				public:
+					UniversalBlockCoord blockCoord;
+					BlockId bid;
+			};
+
 		private:
 			std::thread threads[ENGINE_DEBUG ? 8 : 2]; // TODO: Some kind of worker thread pooling in EngineInstance?
 
 			/** The info for chunks */
 			Engine::FlatHashMap<UniversalChunkCoord, ActiveChunkData> activeChunks;
 
-			/** Blocks marked to crumble, in order. */
-			Engine::RingBuffer<UniversalBlockCoord> crumbleBlocks;
+			class InactiveChunkData {
+				public:
+					/** The previously active data. The body is kept but deactivated. */
+					ActiveChunkData data;
+
+					/** The chunk version when deactivated. Used to detect changes while inactive. */
+					uintz version;
+
+					/** Approximate memory used by this entry. */
+					uint64 bytes;
+
+					/** Used to match entries in inactiveChunksOrder. */
+					uint64 seq;
+			};
+
+			class InactiveChunkOrder {
+				public:
+					UniversalChunkCoord chunkPos;
+					uint64 seq;
+			};
+
+			/**
+			 * Recently deactivated chunks that can be reactivated without rebuilding.
+			 * @see tn_chunk_cache_size
+			 */
+			Engine::FlatHashMap<UniversalChunkCoord, InactiveChunkData> inactiveChunks;
+
+			/** The order chunks were deactivated, oldest first. Entries are lazily invalidated using seq. */
+			Engine::RingBuffer<InactiveChunkOrder> inactiveChunksOrder;
+
+			/** The total approximate memory used by inactiveChunks. */
+			uint64 inactiveChunksBytes = 0;
+
+			/** The next sequence number for inactiveChunks entries. */
+			uint64 inactiveChunksSeq = 0;
+
+			class CrumbleGroup {
+				public:
+					/** The blocks to crumble, in visit order. */
+					std::vector<UniversalBlockCoord> blocks;
+
+					/** The index of the next block to crumble. */
+					uintz next = 0;
+
+					/** Used for ordering groups. Lower is processed first. */
+					int64 priority = 0;
+			};
+
+			/** Groups of blocks marked to crumble. */
+			std::vector<CrumbleGroup> crumbleGroups;
+
+			/** The total number of blocks remaining in crumbleGroups. */
+			uint32 crumbleBlocksPending = 0;
 
 			/** Blocks marked to crumble, for quick lookup to avoid duplicates. */
 			Engine::FlatHashSet<UniversalBlockCoord> crumbleBlocksCheck;
 
 			class CrumbleBlock {
 				public:
+					intz groupId;
 					int32 visitOrder;
 					UniversalBlockCoord blockCoord;
 			};
@@ -147,6 +207,9 @@ namespace Game {
 			/** Temporary crumble block storage to facilitate sorting. */
 			std::vector<CrumbleBlock> crumbleBlockSorting;
 
+			/** The block position of each player. Used for prioritizing crumble work. */
+			std::vector<UniversalBlockCoord> crumblePlayers;
+
 			/**
 			 * Server side chunk edits. These can be handled much simpler than client side since we
 			 * don't need prediction and network correction.
@@ -159,8 +222,28 @@ namespace Game {
 			/** Which chunks have been updated from client side predicted edits. */
 			ENGINE_CLIENT_ONLY(Engine::FlatHashSet<UniversalChunkCoord> chunksUpdatedFromEdits);
 
-			/** Used for sending full RLE chunk updates */
-			std::vector<byte> rleTemp;
+			class PendingEdit {
+				public:
+					UniversalBlockCoord blockCoord;
+					UniversalChunkCoord chunkCoord;
+					BlockVec chunkIndex;
+					BlockId bid;
+			};
+
+			/** Temporary edit storage for grouping edits by chunk. */
+			std::vector<PendingEdit> pendingEdits;
+
+			/** Temporary edit storage for building edits. */
+			std::vector<BlockEdit> editBuffer;
+
+			/**
+			 * RLE data for full chunk updates. Many players usually need the same
+			 * chunks so each chunk is only encoded once per network update. The
+			 * lookup is an index into freshChunkRLE. The buffers are reused between
+			 * updates to avoid reallocating them.
+			 */
+			Engine::FlatHashMap<UniversalChunkCoord, int32> freshChunkRLELookup;
+			std::vector<std::vector<byte>> freshChunkRLE;
 
 			// TODO: C++20: use atomic_flag since it now has a `test` member function.
 			std::atomic<bool> threadsShouldExit = false;
@@ -172,7 +255,7 @@ namespace Game {
 
 			Terrain::Terrain terrain;
 			ENGINE_SERVER_ONLY(Terrain::TestGenerator testGenerator{terrain, Terrain::TestSeed});
-			Engine::FlatHashMap<UniversalRegionCoord, Engine::Clock::TimePoint> regionLastUsed;
+			Terrain::RegionResidency regionResidency;
 
 		public:
 			MapSystem(SystemArg arg);
@@ -187,9 +270,44 @@ namespace Game {
 
 			void ensurePlayAreaLoaded(Engine::ECS::Entity ply); // TODO: should probably be private
 
+			/**
+			 * Applies a batch of block edits for the current tick.
+			 * Edits are grouped by chunk so that each affected chunk is only looked up and
+			 * edited once. Removed blocks have their neighbors queued for the block
+			 * connectivity check. Later edits to the same block take precedence and an edit
+			 * back to the current terrain value cancels any earlier edit to that block. Neighbors
+			 * queued by a cancelled removal are still checked, which is harmless since the
+			 * block is present again by then.
+			 *
+			 * @warning Does not lock the terrain. That is up to the caller.
+			 * @return The number of blocks changed.
+			 */
+			int32 applyEdits(std::span<const BlockEdit> edits);
+
 			void chunkFromNet(const Engine::Net::MessageHeader& head, Engine::Net::BufferReader& buff);
 
+			class CrumbleStats {
+				public:
+					/** The number of blocks waiting for a connectivity check. */
+					uint32 pendingSearches;
+
+					/** The number of groups waiting to crumble. */
+					uint32 pendingGroups;
+
+					/** The number of blocks waiting to crumble. */
+					uint32 pendingBlocks;
+
+					/** Approximately how far behind crumbling is at the target rate. */
+					float32 secondsBehind;
+			};
+
+			/**
+			 * Gets information about how much crumble work is still pending.
+			 */
+			CrumbleStats getCrumbleStats() const noexcept;
+
 			ENGINE_INLINE const auto& getActiveChunks() const noexcept { return activeChunks; }
+			ENGINE_INLINE const auto& getRegionStats() const noexcept { return regionResidency.getStats(); }
 			ENGINE_INLINE const auto& getTerrain() const noexcept { return terrain; }
 
 		public: // TODO: make proper accessors if we actually end up needing this stuff
@@ -212,24 +330,96 @@ namespace Game {
 			Engine::FlatHashMap<UniversalBlockCoord, GroupVisit> bcLookup; // If we have visted a block yet, and in what order.
 			std::vector<UniversalBlockCoord> bcQueue; // Queue of blocks to check.
 
+			class ConnectivitySeed {
+				public:
+					int64 priority;
+					UniversalBlockCoord blockCoord;
+			};
+
+			/** Blocks waiting for a connectivity check. A min heap on priority while scheduling. */
+			std::vector<ConnectivitySeed> bcPending;
+
+			/** Blocks waiting for a connectivity check, for quick lookup to avoid duplicates. */
+			Engine::FlatHashSet<UniversalBlockCoord> bcPendingCheck;
+
 		private:
 			/**
 			 * @warning Does not lock the terrain. That is up to the caller.
 			 */
 			void makeEdit(BlockId bid, const ActionComponent& actComp, const PhysicsBodyComponent& physComp);
 
-			void checkBlockConnectivity();
+			/**
+			 * Checks the connectivity of the blocks in bcQueue and queues any groups that should crumble.
+			 * @return The number of blocks visited.
+			 */
+			uintz checkBlockConnectivity();
+
+			/**
+			 * Runs pending block connectivity checks, nearest to players first, until the
+			 * per tick search budget is used.
+			 * @see tn_crumble_search_budget
+			 */
+			void scheduleBlockConnectivity();
+
+			/**
+			 * Crumbles pending blocks, nearest groups to players first, up to the per tick budget.
+			 * @see tn_crumble_rate
+			 * @see tn_crumble_max_per_tick
+			 */
+			void scheduleCrumble();
+
+			/**
+			 * Gets the priority of crumble work at the given block. Lower is more important.
+			 */
+			[[nodiscard]] int64 getCrumblePriority(const UniversalBlockCoord blockCoord) const noexcept;
+
+			/**
+			 * Queue a block to be checked in a future block connectivity update.
+			 */
+			void queueConnectivity(const UniversalBlockCoord blockCoord);
 
 			/**
 			 * @warning Does not lock the terrain. That is up to the caller.
 			 */
 			bool setValueAt(const UniversalBlockCoord blockCoord, BlockId bid);
 
+			/**
+			 * Applies edits that are all within a single chunk.
+			 * @param checkConnectivity If the neighbors of removed blocks should be queued for a connectivity check.
+			 * @warning Does not lock the terrain. That is up to the caller.
+			 * @return The number of blocks changed.
+			 */
+			int32 applyChunkEdits(const UniversalChunkCoord chunkCoord, std::span<const PendingEdit> edits, bool checkConnectivity);
+
 			// TODO: recycle old bodies?
 			PhysicsBody createBody(ZoneId zoneId);
 
 			void buildActiveChunkData(ActiveChunkData& data, const UniversalChunkCoord chunkPos);
 
+			/**
+			 * Moves active chunk data into the inactive chunk cache, or destroys it if it can't be cached.
+			 * Any block entities should already have been stored/destroyed.
+			 */
+			void deactivateChunk(const UniversalChunkCoord chunkPos, ActiveChunkData&& data);
+
+			/**
+			 * Attempts to reactivate a cached chunk whose data has not changed since it was deactivated.
+			 * @return The active chunk iterator or `activeChunks.end()` if there was no usable cached chunk.
+			 */
+			decltype(activeChunks)::iterator reactivateChunk(const UniversalChunkCoord chunkPos, const ZoneId zoneId, const WorldAbsVec zoneOffset);
+
+			/**
+			 * Evicts the least recently deactivated chunks until the cache is within the given budget.
+			 */
+			void evictInactiveChunks(uint64 budget);
+
+			/**
+			 * Gets the version of a chunk's block data.
+			 */
+			[[nodiscard]] ENGINE_INLINE static uintz getChunkVersion(const MapChunk& chunk) noexcept {
+				return Engine::hashBytes(&chunk.data, sizeof(chunk.data));
+			}
+
 			// Server only, still declared here for simplicity.
 			void queueGeneration(const Terrain::Request& request);
 
@@ -4,8 +4,14 @@
 #include <pcg_random.hpp>
 
 // Engine
+#include <Engine/Net/HandshakeCookie.hpp>
+#include <Engine/Net/NetworkThread.hpp>
 #include <Engine/Net/UDPSocket.hpp>
 #include <Engine/Net/Connection.hpp>
+#include <Engine/Net/PacketAssembler.hpp>
+#include <Engine/Net/PacketCodec.hpp>
+#include <Engine/Net/PacketCapture.hpp>
+#include <Engine/Net/RateLimiter.hpp>
 #include <Engine/FlatHashMap.hpp>
 #include <Engine/Engine.hpp>
 #include <Engine/ECS/ecs.hpp>
@@ -17,6 +23,37 @@
 
 
 namespace Game {
+	/**
+	 * Fills the remainder of a handshake message with padding. Handshake
+	 * requests are padded to the full packet size so they can't be used for
+	 * amplification.
+	 */
+	void writeMessagePadding(Engine::Net::StaticBufferWriter& msg);
+
+	/**
+	 * Checks that the remainder of a message is the padding written by writeMessagePadding.
+	 */
+	bool verifyMessagePadding(Engine::Net::BufferReader& msg);
+
+	/**
+	 * Creates the packet codec using the dictionary in `net.dict` if it exists.
+	 * Both ends of a connection need the same dictionary to use compression.
+	 * Use the `net_train_dict` command to create one from a packet capture.
+	 * @see trainPacketDictionary
+	 */
+	Engine::Net::PacketCodec loadPacketCodec();
+
+	/**
+	 * Builds a packet dictionary from the bodies of the packets in a capture. @see Engine::Net::PacketCapture
+	 * Captures only contain received packets, so a capture from a client trains on server traffic and vice versa.
+	 * Compressed packets are decompressed with @p codec and skipped if that fails.
+	 * @param capture The capture file to read.
+	 * @param codec The codec that was in use when the capture was made.
+	 * @param size The maximum size of the dictionary.
+	 * @return The dictionary or empty if the capture could not be read.
+	 */
+	std::vector<byte> trainPacketDictionary(const std::string& capture, const Engine::Net::PacketCodec& codec, int32 size);
+
 	using NetworkMessageHandler = void(*)(EngineInstance& engine, ConnectionInfo& from, const Engine::Net::MessageHeader hdr, Engine::Net::BufferReader& msg);
 
 	class NetworkingSystem : public System {
@@ -36,7 +73,9 @@ namespace Game {
 			static constexpr auto timeout = std::chrono::milliseconds{5000}; // TODO: Should be configurable
 			static constexpr auto disconnectingPeriod = std::chrono::milliseconds{500}; // TODO: Should be configurable
 
-			Engine::Net::Packet packet = {};
+			/** Receive buffers. One packet per datagram in a receive batch. */
+			std::array<Engine::Net::Packet, Engine::Net::UDPSocket::maxBatchSize> packets = {};
+			std::array<Engine::Net::Datagram, Engine::Net::UDPSocket::maxBatchSize> datagrams = {};
 			const Engine::Net::IPv4Address group;
 			Engine::Clock::TimePoint now = {};
 
@@ -50,15 +89,62 @@ namespace Game {
 			Engine::Net::UDPSocket discoverServerSocket;
 			#endif
 
+			/** Optional thread that does all IO for the main socket. Must be after `socket` so it is destroyed first. */
+			std::unique_ptr<Engine::Net::NetworkThread> netThread;
+
+			/** A copy of the socket's sim settings that is safe to read while the network thread is running. */
+			Engine::Net::UDPSimSettings simSettings;
+
+			/** Shared by all connections that have negotiated compression. */
+			const Engine::Net::PacketCodec codec;
+
+			/** Optional capture of all received packets. */
+			std::unique_ptr<Engine::Net::PacketCapture> capture;
+
+			/** Optional capture to read packets from instead of the network. Nothing is sent while replaying. */
+			std::unique_ptr<Engine::Net::PacketReplay> replay;
+			Engine::Clock::TimePoint replayStart = {};
+
 			Engine::FlatHashMap<Engine::Net::IPv4Address, std::unique_ptr<ConnectionInfo>> addrToConn;
 			using ConnIt = decltype(addrToConn)::iterator;
+
+			/**
+			 * Connections indexed by the slot id in their local key. Received packets
+			 * are matched to a connection using this instead of addrToConn. Null if
+			 * the slot is unused. @see genKey
+			 */
+			std::vector<ConnectionInfo*> slots;
+			std::vector<uint16> freeSlots;
+
+			#if ENGINE_SERVER
+				/** Cookies for handshakes from addresses without a connection. @see recvHandshake */
+				Engine::Net::HandshakeCookie cookies{0, 0};
+
+				/** Limits handshake traffic from addresses without a connection. */
+				Engine::Net::RateLimiter handshakeLimiter;
+
+				/** Cookie times are relative to the first update so they are the same when replaying a capture. */
+				Engine::Clock::TimePoint handshakeEpoch = {};
+			#endif
+
+			/** Builds the packets for all connections sent in an update. @see sendQueue */
+			Engine::Net::PacketAssembler assembler;
+
+			/** Connections to send this update. */
+			std::vector<ConnectionInfo*> sendQueue;
 			
 			pcg32 rng;
-			uint16 genKey() {
+
+			/**
+			 * Generates a local key for the connection in @p slot. The upper 16 bits
+			 * are the slot id and the lower 16 bits are random. The random bits are
+			 * never zero so zero is never a valid key.
+			 */
+			uint32 genKey(uint16 slot) {
 				uint16 v;
-				while (!(v = rng())) {}
-				return v;
-			} 
+				while (!(v = static_cast<uint16>(rng()))) {}
+				return (uint32{slot} << 16) | v;
+			}
 
 
 		public:	
@@ -76,6 +162,25 @@ namespace Game {
 
 			auto& getSocket() noexcept { return socket; }
 
+			/**
+			 * Applies the network sim cvars to the main socket.
+			 */
+			void updateSimSettings();
+
+			/**
+			 * Changes the network sim settings of the main socket. Always use this
+			 * instead of UDPSocket::getSimSettings since the socket may be owned by
+			 * the network thread.
+			 */
+			void setSimSettings(const Engine::Net::UDPSimSettings& settings);
+
+			/**
+			 * The network sim settings last set with setSimSettings.
+			 */
+			ENGINE_INLINE const Engine::Net::UDPSimSettings& getSimSettings() const noexcept { return simSettings; }
+
+			const auto& getPacketCodec() const noexcept { return codec; }
+
 			void setMessageHandler(MessageType msg, NetworkMessageHandler func) noexcept {
 				if (msg >= MessageType::_count) {
 					ENGINE_WARN("Invalid message type ", msg);
@@ -108,6 +213,20 @@ namespace Game {
 		private:
 			ConnectionInfo& getOrCreateConnection(const Engine::Net::IPv4Address& addr);
 
+			/**
+			 * Finds the connection for a received packet using the slot id in its key.
+			 * @return The connection or null if there is no connection with that key and address.
+			 */
+			ENGINE_INLINE ConnectionInfo* findConnection(uint32 key, const Engine::Net::IPv4Address& addr) const noexcept {
+				const auto slot = key >> 16;
+				if (slot >= slots.size()) { return nullptr; }
+
+				// Check the address so other hosts can't use the connection by guessing its key.
+				auto* conn = slots[slot];
+				if (!conn || conn->getKeyLocal() != key || conn->address() != addr) { return nullptr; }
+				return conn;
+			}
+
 			/**
 			 * Cleanup any ECS state associated with a connection.
 			 */
@@ -120,6 +239,33 @@ namespace Game {
 			void disconnect(ConnectionInfo& conn);
 
 			void recvAndDispatchMessages(Engine::Net::UDPSocket& sock);
+			void replayMessages();
+			void dispatchPacket(const Engine::Net::Packet& packet, int32 sz, const Engine::Net::IPv4Address& addr, Engine::Clock::TimePoint time);
+
+			#if ENGINE_SERVER
+				/**
+				 * Handles packets that don't belong to a connection. Only handshake and
+				 * discovery messages are accepted. No state is kept for the address
+				 * until it has returned a valid cookie.
+				 */
+				void recvHandshake(const Engine::Net::Packet& packet, int32 sz, const Engine::Net::IPv4Address& addr, Engine::Clock::TimePoint time);
+
+				/**
+				 * Creates the connection and player for a completed handshake.
+				 */
+				void acceptConnection(const Engine::Net::IPv4Address& addr, uint32 keyRemote);
+
+				/**
+				 * Sends a single message without a connection.
+				 * @param write Called with the StaticBufferWriter to write the message body to.
+				 */
+				void sendStateless(const Engine::Net::IPv4Address& addr, uint32 key, MessageType type, auto&& write);
+			#endif
+
+			/**
+			 * Writes the packets for all connections in sendQueue and queues them on the socket.
+			 */
+			void sendAll();
 			void dispatchMessage(ConnectionInfo& from, const Engine::Net::MessageHeader hdr, Engine::Net::BufferReader& msg);
 
 			template<MessageType Type>
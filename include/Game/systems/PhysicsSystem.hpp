@@ -1,10 +1,14 @@
 #pragma once
 
+// STD
+#include <memory>
+
 // Box2D
 #include <Box2D/Box2D.h>
 
 // Engine
 #include <Engine/Debug/DebugDrawBox2D.hpp>
+#include <Engine/WorkerPool.hpp>
 
 // Game
 #include <Game/System.hpp>
@@ -27,7 +31,54 @@ namespace Game {
 			using FilterBitset = decltype(b2Filter::categoryBits);
 
 		private:
-			b2World physWorld;
+			/** A contact callback buffered while stepping. */
+			class ContactEvent {
+				public:
+					Engine::ECS::Entity entA;
+					Engine::ECS::Entity entB;
+					bool begin;
+
+					ENGINE_INLINE bool samePair(const ContactEvent& other) const noexcept {
+						return (entA == other.entA && entB == other.entB) || (entA == other.entB && entB == other.entA);
+					}
+			};
+
+			/**
+			 * The physics world for a single zone.
+			 * Contacts are buffered while stepping so listeners are always called from the main thread.
+			 */
+			class ZoneWorld : public b2World {
+				public:
+					std::vector<ContactEvent> contacts;
+					bool buffering = false;
+
+					ZoneWorld(PhysicsSystem& physSys);
+			};
+
+			/**
+			 * The physics worlds by zone id. Zones never interact so each world can be stepped independently.
+			 * If zone worlds are disabled everything is in the first world.
+			 */
+			std::vector<std::unique_ptr<ZoneWorld>> zoneWorlds;
+			const bool useZoneWorlds;
+
+			/** The worlds being stepped this tick, in zone order. */
+			std::vector<ZoneWorld*> stepQueue;
+
+			/**
+			 * The end contact events from bodies moved between worlds since the last step.
+			 * Contacts that begin again in the new world on the next step never ended so neither
+			 * event is dispatched. The rest are dispatched after the step. @see updateZoneWorld
+			 */
+			std::vector<ContactEvent> movedContacts;
+			bool movingBody = false;
+
+			/**
+			 * Steps zone worlds concurrently. Box2D has no shared state between
+			 * worlds apart from its GJK/TOI profiling counters, which our Box2D
+			 * recipe makes thread local. @see conan_recipes/box2d
+			 */
+			Engine::WorkerPool workers;
 			std::vector<PhysicsListener*> listeners;
 
 		public:
@@ -40,8 +91,15 @@ namespace Game {
 			void onComponentAdded(const Engine::ECS::Entity ent, class PhysicsBodyComponent& comp);
 			void onComponentRemoved(const Engine::ECS::Entity ent, class PhysicsBodyComponent& comp);
 
-			// TODO: really should just write accessors for whatever we need this for instead of leaking the entire world.
-			const b2World& getPhysicsWorld() const noexcept { return physWorld; }
+			/**
+			 * Calls @p func with each physics world.
+			 * @param func Called as `func(const b2World& physWorld)`.
+			 */
+			void forEachWorld(auto&& func) const {
+				for (const auto& zoneWorld : zoneWorlds) {
+					if (zoneWorld) { func(static_cast<const b2World&>(*zoneWorld)); }
+				}
+			}
 
 			/**
 			 * Creates a box2d body and associates an entity with it.
@@ -58,6 +116,14 @@ namespace Game {
 			 */
 			void destroyBody(PhysicsBody& body);
 
+			/**
+			 * Moves a body to the physics world for its zone if it isn't already in it.
+			 * Box2D can't move bodies between worlds so the body and its fixtures are recreated.
+			 * Must be called after PhysicsBody::setZone before the next step. Must not be called while stepping.
+			 * @param[in] body The body to move.
+			 */
+			void updateZoneWorld(PhysicsBody& body);
+
 			/**
 			 * Adds a physics listener.
 			 * @param[in] listener The listener.
@@ -146,6 +212,20 @@ namespace Game {
 			}
 
 		private:
+			ZoneWorld& getZoneWorld(ZoneId zoneId);
+
+			/**
+			 * Removes the moved contact matching a begin event.
+			 * @return True if the contact was moved and the event should not be dispatched.
+			 */
+			bool consumeMovedContact(const ContactEvent& event);
+
+			/**
+			 * Calls the listeners for @p event, or buffers it if @p contact is from a world being stepped.
+			 */
+			void onContact(b2Contact* contact, bool begin);
+			void dispatch(const ContactEvent& event);
+
 			// b2ContactListener members
 			virtual void BeginContact(b2Contact* contact) override;
 			virtual void EndContact(b2Contact* contact) override;
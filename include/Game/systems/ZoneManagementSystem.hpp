@@ -6,43 +6,26 @@
 // Game
 #include <Game/System.hpp>
 #include <Game/Zone.hpp>
+#include <Game/ZoneClusterer.hpp>
 
 
 namespace Game {
 	class ZoneManagementSystem final : public System {
 		private:
-			using GroupId = uint32;
-			using Dist = int64;
-			class PlyRel {
-				public:
-					Engine::ECS::Entity ply1 = {};
-					Engine::ECS::Entity ply2 = {};
-					WorldAbsUnit dist = std::numeric_limits<WorldAbsUnit>::max();
-			};
-
-			class GroupPair {
-				public:
-					// The src should always be the larger groupId
-					GroupId src = -1;
-					GroupId dst = -1;
-					WorldAbsVec ideal = {};
-			};
-					
-		private:
-			std::vector<PlyRel> relations;
 			std::vector<ZoneId> reuse;
 			std::vector<Zone> zones;
 
-			// Remaps for groups. These map from a groupId to groupStorageId. This extra
-			// layer of indirection is needed to handle the case where groups are
-			// merged. Its easier to simply update the mapping instead of updating a
-			// groupId on everything that could possible be referencing that groupId.
-			std::vector<GroupId> groupRemaps;
+			/** Groups players that must share a zone. @see tick_Server */
+			ZoneClusterer clusterer;
+
 			std::vector<std::vector<Engine::ECS::Entity>> groupStorage;
 			std::vector<RealmId> groupRealms;
 
-			// Pairs for groups that should be merged.
-			std::vector<GroupPair> merged;
+			/**
+			 * Entities migrated since zones were last merged and split. Their bodies are moved to
+			 * the physics world for their new zone all at once. @see PhysicsSystem::updateZoneWorld
+			 */
+			ENGINE_SERVER_ONLY(std::vector<Engine::ECS::Entity> migrated);
 
 		public:
 			ZoneManagementSystem(SystemArg arg);
@@ -105,7 +88,7 @@ namespace Game {
 			}
 
 		private:
-			void migrateEntity(const ZoneId newZoneId, const WorldVec newPos, PhysicsBodyComponent& physComp);
+			void migrateEntity(const Engine::ECS::Entity ent, const ZoneId newZoneId, const WorldVec newPos, PhysicsBodyComponent& physComp);
 
 			/**
 			 * Provides a central place for activating (or initializing) zones.
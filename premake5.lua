@@ -410,6 +410,12 @@ project("Test")
 		"./test/**",
 	}
 
+	-- The pch includes Game/World.hpp so the tests need a side. The Game code under test
+	-- (zones, interest management, map chunks) is server side.
+	defines {
+		"ENGINE_SIDE=ENGINE_SIDE_SERVER",
+	}
+
 	filter "configurations:Debug*"
 		conan_use("googletest/.*", "debug", "includedirs", includedirs)
 		conan_use("googletest/.*", "debug", "libdirs", libdirs)
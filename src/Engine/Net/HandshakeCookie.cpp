@@ -0,0 +1,57 @@
+// STD
+#include <bit>
+
+// Engine
+#include <Engine/Net/HandshakeCookie.hpp>
+
+
+namespace {
+	using namespace Engine::Types;
+
+	/** SipHash-2-4 of two 64 bit words. */
+	uint64 sipHash(uint64 k0, uint64 k1, const uint64 (&words)[2]) noexcept {
+		uint64 v0 = k0 ^ 0x736f6d6570736575ull;
+		uint64 v1 = k1 ^ 0x646f72616e646f6dull;
+		uint64 v2 = k0 ^ 0x6c7967656e657261ull;
+		uint64 v3 = k1 ^ 0x7465646279746573ull;
+
+		const auto round = [&]{
+			v0 += v1; v1 = std::rotl(v1, 13); v1 ^= v0; v0 = std::rotl(v0, 32);
+			v2 += v3; v3 = std::rotl(v3, 16); v3 ^= v2;
+			v0 += v3; v3 = std::rotl(v3, 21); v3 ^= v0;
+			v2 += v1; v1 = std::rotl(v1, 17); v1 ^= v2; v2 = std::rotl(v2, 32);
+		};
+
+		const auto compress = [&](uint64 m){
+			v3 ^= m;
+			round();
+			round();
+			v0 ^= m;
+		};
+
+		compress(words[0]);
+		compress(words[1]);
+
+		// The final block only has the message length.
+		compress(uint64{sizeof(words)} << 56);
+
+		v2 ^= 0xFF;
+		round();
+		round();
+		round();
+		round();
+		return v0 ^ v1 ^ v2 ^ v3;
+	}
+}
+
+namespace Engine::Net {
+	uint32 HandshakeCookie::make(const IPv4Address& addr, uint32 key, int64 p) const noexcept {
+		const uint64 words[2] = {
+			(uint64{addr.address} << 32) | (uint64{addr.port} << 16),
+			(uint64{key} << 32) ^ static_cast<uint64>(p),
+		};
+
+		const auto hash = sipHash(k0, k1, words);
+		return static_cast<uint32>(hash ^ (hash >> 32));
+	}
+}
@@ -1,5 +1,9 @@
 #if ENGINE_OS_WINDOWS
 	#include <winsock2.h>
+#elif defined(__linux__)
+	#include <arpa/inet.h>
+	#include <netinet/in.h>
+	#include <sys/socket.h>
 #else
 	#error Not yet implemented for this operating system.
 #endif
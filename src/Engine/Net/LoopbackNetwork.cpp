@@ -0,0 +1,88 @@
+// STD
+#include <algorithm>
+#include <cstring>
+
+// Engine
+#include <Engine/Net/LoopbackNetwork.hpp>
+
+
+namespace Engine::Net {
+	auto LoopbackNetwork::find(uint16 port) -> std::shared_ptr<Endpoint> {
+		std::lock_guard lock{mutex};
+		const auto found = endpoints.find(port);
+		return found == endpoints.end() ? nullptr : found->second;
+	}
+
+	uint16 LoopbackNetwork::bind(uint16 port) {
+		std::lock_guard lock{mutex};
+
+		if (port == 0) {
+			// Ephemeral port range. Same as most operating systems.
+			while (endpoints.contains(nextPort)) {
+				nextPort = nextPort == 0xFFFF ? 49152 : nextPort + 1;
+			}
+			port = nextPort;
+		} else if (endpoints.contains(port)) {
+			return 0;
+		}
+
+		endpoints.emplace(port, std::make_shared<Endpoint>());
+		return port;
+	}
+
+	void LoopbackNetwork::unbind(uint16 port) {
+		std::lock_guard lock{mutex};
+		endpoints.erase(port);
+	}
+
+	bool LoopbackNetwork::send(uint16 from, const IPv4Address& to, const void* data, int32 size) {
+		ENGINE_DEBUG_ASSERT(size >= 0);
+
+		const auto endpoint = find(to.port);
+		if (!endpoint || to.address != address(0).address) { return false; }
+
+		{
+			std::lock_guard lock{endpoint->mutex};
+			if (endpoint->queue.size() >= maxQueued) { return false; }
+
+			auto& entry = endpoint->queue.emplace_back();
+			entry.from = address(from);
+
+			if (!endpoint->spare.empty()) {
+				entry.data = std::move(endpoint->spare.back());
+				endpoint->spare.pop_back();
+			}
+
+			const auto* bytes = static_cast<const byte*>(data);
+			entry.data.assign(bytes, bytes + size);
+		}
+
+		endpoint->cond.notify_one();
+		return true;
+	}
+
+	int32 LoopbackNetwork::recv(uint16 port, void* data, int32 size, IPv4Address& from) {
+		const auto endpoint = find(port);
+		if (!endpoint) { return -1; }
+
+		std::lock_guard lock{endpoint->mutex};
+		if (endpoint->queue.empty()) { return -1; }
+
+		auto& entry = endpoint->queue.front();
+		const auto len = std::min(size, static_cast<int32>(entry.data.size()));
+		memcpy(data, entry.data.data(), len);
+		from = entry.from;
+
+		endpoint->spare.push_back(std::move(entry.data));
+		endpoint->queue.pop_front();
+		return len;
+	}
+
+	bool LoopbackNetwork::wait(uint16 port, Engine::Clock::Duration timeout) {
+		const auto endpoint = find(port);
+		if (!endpoint) { return false; }
+
+		std::unique_lock lock{endpoint->mutex};
+		return endpoint->cond.wait_for(lock, timeout, [&]{ return !endpoint->queue.empty(); });
+	}
+}
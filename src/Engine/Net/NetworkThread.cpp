@@ -0,0 +1,122 @@
+// Engine
+#include <Engine/Net/NetworkThread.hpp>
+
+
+namespace Engine::Net {
+	NetworkThread::NetworkThread(UDPSocket& socket)
+		: socket{socket}
+		, recvPool{std::make_unique<RecvPacket[]>(poolSize)}
+		, sendPool{std::make_unique<SendPacket[]>(poolSize)} {
+
+		for (uint32 i = 0; i < poolSize; ++i) {
+			recvFree.push(i);
+			sendFree.push(i);
+		}
+
+		thread = std::thread{&NetworkThread::run, this};
+	}
+
+	NetworkThread::~NetworkThread() {
+		running.store(false, std::memory_order_relaxed);
+		thread.join();
+	}
+
+	void NetworkThread::queue(const void* data, int32 size, const IPv4Address& address) {
+		uint32 i;
+		if (!sendFree.pop(i)) {
+			++stats.sendDropped;
+			return;
+		}
+
+		auto& buff = sendPool[i];
+		ENGINE_DEBUG_ASSERT(static_cast<uintz>(size) <= sizeof(buff.packet), "Attempting to send a packet larger than the maximum packet size.");
+		memcpy(&buff.packet, data, size);
+		buff.size = size;
+		buff.address = address;
+		sendReady.push(i);
+	}
+
+	void NetworkThread::setSimSettings(const UDPSimSettings& settings) {
+		std::scoped_lock lock{simMutex};
+		simPending = settings;
+		simChanged.store(true, std::memory_order_release);
+	}
+
+	void NetworkThread::run() {
+		constexpr auto maxBatch = UDPSocket::maxBatchSize;
+		std::array<Datagram, maxBatch> datagrams;
+		std::array<uint32, maxBatch> sendIds;
+		std::array<uint32, maxBatch> recvIds;
+		int32 recvIdCount = 0;
+
+		while (running.load(std::memory_order_relaxed)) {
+			bool active = false;
+
+			if (simChanged.load(std::memory_order_acquire)) {
+				std::scoped_lock lock{simMutex};
+				socket.getSimSettings() = simPending;
+				simChanged.store(false, std::memory_order_relaxed);
+			}
+
+			// Receive until the socket is empty or the pool is exhausted. If the pool is
+			// exhausted packets will wait in the socket buffer until some are released.
+			while (true) {
+				while (recvIdCount < maxBatch && recvFree.pop(recvIds[recvIdCount])) { ++recvIdCount; }
+				if (recvIdCount == 0) { break; }
+
+				for (int32 i = 0; i < recvIdCount; ++i) {
+					auto& buff = recvPool[recvIds[i]];
+					datagrams[i] = {.data = &buff.packet, .size = sizeof(buff.packet)};
+				}
+
+				const auto count = socket.recvBatch({datagrams.data(), static_cast<uintz>(recvIdCount)});
+				const auto now = Engine::Clock::now();
+
+				for (int32 i = 0; i < count; ++i) {
+					auto& buff = recvPool[recvIds[i]];
+					buff.size = datagrams[i].size;
+					buff.address = datagrams[i].address;
+					buff.time = now;
+					recvReady.push(recvIds[i]);
+				}
+
+				// Keep any unused ids for the next batch.
+				std::copy(recvIds.begin() + count, recvIds.begin() + recvIdCount, recvIds.begin());
+				recvIdCount -= count;
+				active |= count > 0;
+
+				// A partial batch means there is nothing left to read.
+				if (recvIdCount > 0) { break; }
+			}
+
+			// Send everything that has been queued.
+			while (true) {
+				int32 count = 0;
+				while (count < maxBatch && sendReady.pop(sendIds[count])) {
+					auto& buff = sendPool[sendIds[count]];
+					datagrams[count] = {.data = &buff.packet, .size = buff.size, .address = buff.address};
+					++count;
+				}
+
+				if (count == 0) { break; }
+				const auto sent = socket.sendBatch({datagrams.data(), static_cast<uintz>(count)});
+				if (sent < count) {
+					ENGINE_WARN2("Dropped {} of {} outgoing datagrams. Unable to send.", count - sent, count);
+				}
+
+				for (int32 i = 0; i < count; ++i) {
+					sendFree.push(sendIds[i]);
+				}
+
+				active = true;
+			}
+
+			socket.realSimSend();
+
+			// Sends are only checked between waits so this also bounds the added send latency.
+			if (!active) {
+				socket.wait(std::chrono::milliseconds{1});
+			}
+		}
+	}
+}
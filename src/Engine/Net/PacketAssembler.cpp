@@ -0,0 +1,25 @@
+// Engine
+#include <Engine/Net/PacketAssembler.hpp>
+
+
+namespace Engine::Net {
+	void PacketAssembler::Sink::queue(const void* data, int32 size, const IPv4Address& address) {
+		const auto* bytes = static_cast<const byte*>(data);
+		this->data.insert(this->data.end(), bytes, bytes + size);
+		datagrams.push_back({
+			.data = nullptr,
+			.size = size,
+			.address = address,
+		});
+	}
+
+	void PacketAssembler::prepare(int32 count) {
+		// No jobs are running so it is safe to touch the sinks.
+		if (std::ssize(sinks) < count) { sinks.resize(count); }
+		sinkCount = count;
+		for (int32 i = 0; i < count; ++i) {
+			sinks[i].data.clear();
+			sinks[i].datagrams.clear();
+		}
+	}
+}
@@ -0,0 +1,128 @@
+// STD
+#include <cstring>
+
+// Engine
+#include <Engine/Net/PacketCapture.hpp>
+
+
+namespace {
+	using namespace Engine::Types;
+
+	template<class T>
+	ENGINE_INLINE void write(std::ofstream& file, const T& value) {
+		file.write(reinterpret_cast<const char*>(&value), sizeof(value));
+	}
+
+	template<class T>
+	ENGINE_INLINE bool read(std::ifstream& file, T& value) {
+		return static_cast<bool>(file.read(reinterpret_cast<char*>(&value), sizeof(value)));
+	}
+}
+
+namespace Engine::Net {
+	PacketCapture::PacketCapture(const std::string& path, uint64 seed)
+		: file{path, std::ios::binary | std::ios::out | std::ios::trunc} {
+
+		if (!file) {
+			ENGINE_WARN2("Unable to open packet capture file: {}", path);
+			return;
+		}
+
+		file.write(magic, sizeof(magic));
+		write(file, version);
+		write(file, seed);
+	}
+
+	void PacketCapture::frame(Engine::Clock::TimePoint time) {
+		if (start == Engine::Clock::TimePoint{}) { start = time; }
+		write(file, Kind::Frame);
+		write(file, static_cast<int64>(std::chrono::duration_cast<std::chrono::nanoseconds>(time - start).count()));
+	}
+
+	void PacketCapture::datagram(Engine::Clock::TimePoint time, const IPv4Address& addr, std::span<const byte> data) {
+		ENGINE_DEBUG_ASSERT(start != Engine::Clock::TimePoint{}, "Datagrams must be part of a frame.");
+		ENGINE_DEBUG_ASSERT(data.size() <= 0xFFFF);
+		write(file, Kind::Datagram);
+		write(file, static_cast<int64>(std::chrono::duration_cast<std::chrono::nanoseconds>(time - start).count()));
+		write(file, addr.address);
+		write(file, addr.port);
+		write(file, static_cast<uint16>(data.size()));
+		file.write(reinterpret_cast<const char*>(data.data()), data.size());
+	}
+
+	PacketReplay::PacketReplay(const std::string& path)
+		: file{path, std::ios::binary | std::ios::in} {
+
+		if (!file) {
+			ENGINE_WARN2("Unable to open packet capture file: {}", path);
+			return;
+		}
+
+		char fileMagic[sizeof(PacketCapture::magic)] = {};
+		uint32 fileVersion = 0;
+		file.read(fileMagic, sizeof(fileMagic));
+		read(file, fileVersion);
+		read(file, seed);
+
+		if (!file || memcmp(fileMagic, PacketCapture::magic, sizeof(fileMagic)) || fileVersion != PacketCapture::version) {
+			ENGINE_WARN2("Invalid packet capture file: {}", path);
+			file.close();
+		}
+	}
+
+	bool PacketReplay::next() {
+		entries.clear();
+		data.clear();
+
+		if (!file.is_open()) { return false; }
+
+		PacketCapture::Kind kind;
+		int64 ns;
+
+		// The frame marker for this frame was already read by the previous call.
+		if (!inFrame) {
+			if (!read(file, kind) || kind != PacketCapture::Kind::Frame || !read(file, ns)) {
+				file.close();
+				return false;
+			}
+			inFrame = true;
+		}
+
+		while (true) {
+			if (!read(file, kind)) {
+				// End of file. This is the last frame.
+				file.close();
+				break;
+			}
+
+			if (!read(file, ns)) { file.close(); return false; }
+			if (kind == PacketCapture::Kind::Frame) { break; }
+			if (kind != PacketCapture::Kind::Datagram) { file.close(); return false; }
+
+			IPv4Address addr;
+			uint16 size;
+			if (!read(file, addr.address) || !read(file, addr.port) || !read(file, size)) { file.close(); return false; }
+
+			const auto offset = data.size();
+			data.resize(offset + size);
+			if (!file.read(reinterpret_cast<char*>(data.data() + offset), size)) { file.close(); return false; }
+
+			// The data pointer is fixed up once the whole frame has been read.
+			entries.push_back({
+				.time = std::chrono::nanoseconds{ns},
+				.address = addr,
+				.data = {static_cast<byte*>(nullptr), size},
+			});
+		}
+
+		auto* curr = data.data();
+		for (auto& entry : entries) {
+			entry.data = {curr, entry.data.size()};
+			curr += entry.data.size();
+		}
+
+		++frameCount;
+		datagramCount += std::ssize(entries);
+		return true;
+	}
+}
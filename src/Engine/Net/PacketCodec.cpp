@@ -0,0 +1,290 @@
+// STD
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <queue>
+
+// Engine
+#include <Engine/FlatHashMap.hpp>
+#include <Engine/Hash.hpp>
+#include <Engine/Net/PacketCodec.hpp>
+
+
+namespace {
+	using namespace Engine::Types;
+
+	/** Hash bits for positions in the payload being compressed. Packets are small so this can be small. */
+	constexpr int32 inputHashBits = 10;
+
+	/** Hash bits for positions in the dictionary. */
+	constexpr int32 dictHashBits = 14;
+
+	template<class T>
+	ENGINE_INLINE T readUnaligned(const byte* data) noexcept {
+		T value;
+		memcpy(&value, data, sizeof(value));
+		return value;
+	}
+
+	template<int32 Bits>
+	ENGINE_INLINE uint32 hash4(const byte* data) noexcept {
+		return (readUnaligned<uint32>(data) * 2654435761u) >> (32 - Bits);
+	}
+
+	class Writer {
+		public:
+			byte* curr;
+			byte* const last;
+			bool ok = true;
+
+		public:
+			void write(byte value) noexcept {
+				if (curr == last) { ok = false; return; }
+				*curr++ = value;
+			}
+
+			void write(const byte* data, int32 size) noexcept {
+				if (last - curr < size) { ok = false; return; }
+				memcpy(curr, data, size);
+				curr += size;
+			}
+
+			void writeLength(int32 len) noexcept {
+				for (; len >= 255; len -= 255) { write(255); }
+				write(static_cast<byte>(len));
+			}
+	};
+}
+
+namespace Engine::Net {
+	PacketCodec::PacketCodec(std::span<const byte> dictionary) {
+		if (std::ssize(dictionary) > maxDictionarySize) {
+			dictionary = dictionary.last(maxDictionarySize);
+		}
+
+		dict.assign(dictionary.begin(), dictionary.end());
+
+		if (!dict.empty()) {
+			// Later positions overwrite earlier ones so we prefer closer matches.
+			dictTable.resize(1 << dictHashBits, -1);
+			for (int32 i = 0; i + minMatch <= std::ssize(dict); ++i) {
+				dictTable[hash4<dictHashBits>(dict.data() + i)] = i;
+			}
+		}
+
+		auto seed = hashBytes(dict.data(), dict.size());
+		hashCombine(seed, version);
+		id = static_cast<uint32>(seed ^ (seed >> 32));
+		if (id == 0) { id = 1; }
+	}
+
+	int32 PacketCodec::compress(std::span<const byte> src, std::span<byte> dst) const noexcept {
+		const auto n = static_cast<int32>(src.size());
+		const auto dictSize = static_cast<int32>(dict.size());
+		Writer out{dst.data(), dst.data() + dst.size()};
+
+		std::array<int32, 1 << inputHashBits> table;
+		table.fill(-1);
+
+		// Positions are in the virtual buffer of dict + src.
+		const auto at = [&](int32 v) ENGINE_INLINE_REL { return v < dictSize ? dict[v] : src[v - dictSize]; };
+		const auto matchLength = [&](int32 v, int32 i) ENGINE_INLINE_REL {
+			int32 len = 0;
+			while (i + len < n && at(v + len) == src[i + len]) { ++len; }
+			return len;
+		};
+
+		const auto writeSequence = [&](int32 anchor, int32 lit, int32 offset, int32 len) ENGINE_INLINE_REL {
+			const auto extra = len ? len - minMatch : 0;
+			out.write(static_cast<byte>((std::min(lit, 15) << 4) | std::min(extra, 15)));
+			if (lit >= 15) { out.writeLength(lit - 15); }
+			out.write(src.data() + anchor, lit);
+
+			if (len) {
+				out.write(static_cast<byte>(offset & 0xFF));
+				out.write(static_cast<byte>(offset >> 8));
+				if (extra >= 15) { out.writeLength(extra - 15); }
+			}
+		};
+
+		int32 anchor = 0;
+		int32 i = 0;
+		while (i + minMatch <= n && out.ok) {
+			const auto h = hash4<inputHashBits>(src.data() + i);
+			int32 bestLen = 0;
+			int32 bestPos = 0;
+
+			if (const auto c = table[h]; c >= 0) {
+				bestLen = matchLength(dictSize + c, i);
+				bestPos = dictSize + c;
+			}
+
+			if (!dictTable.empty()) {
+				if (const auto c = dictTable[hash4<dictHashBits>(src.data() + i)]; c >= 0) {
+					if (const auto len = matchLength(c, i); len > bestLen) {
+						bestLen = len;
+						bestPos = c;
+					}
+				}
+			}
+
+			table[h] = i;
+
+			const auto offset = dictSize + i - bestPos;
+			if (bestLen < minMatch || offset > 0xFFFF) {
+				++i;
+				continue;
+			}
+
+			writeSequence(anchor, i - anchor, offset, bestLen);
+
+			// Index the matched positions so later data can reference them.
+			const auto end = i + bestLen;
+			for (++i; i < end && i + minMatch <= n; ++i) {
+				table[hash4<inputHashBits>(src.data() + i)] = i;
+			}
+
+			i = end;
+			anchor = end;
+		}
+
+		if (anchor < n) {
+			writeSequence(anchor, n - anchor, 0, 0);
+		}
+
+		return out.ok ? static_cast<int32>(out.curr - dst.data()) : 0;
+	}
+
+	int32 PacketCodec::decompress(std::span<const byte> src, std::span<byte> dst) const noexcept {
+		const auto dictSize = static_cast<int32>(dict.size());
+		const auto cap = static_cast<int32>(dst.size());
+		const byte* curr = src.data();
+		const byte* const last = src.data() + src.size();
+		byte* const out = dst.data();
+		int32 pos = 0;
+
+		const auto readLength = [&](int32& len) ENGINE_INLINE_REL {
+			byte b;
+			do {
+				if (curr == last || len > cap) { return false; }
+				b = *curr++;
+				len += b;
+			} while (b == 255);
+			return true;
+		};
+
+		while (curr < last) {
+			const auto token = *curr++;
+
+			int32 lit = token >> 4;
+			if (lit == 15 && !readLength(lit)) { return -1; }
+			if (lit > last - curr || lit > cap - pos) { return -1; }
+
+			memcpy(out + pos, curr, lit);
+			curr += lit;
+			pos += lit;
+
+			if (curr == last) { break; }
+			if (last - curr < 2) { return -1; }
+
+			const int32 offset = curr[0] | (curr[1] << 8);
+			curr += 2;
+
+			int32 len = (token & 15) + minMatch;
+			if ((token & 15) == 15 && !readLength(len)) { return -1; }
+			if (offset == 0 || offset > pos + dictSize || len > cap - pos) { return -1; }
+
+			// Byte at a time since the match may overlap itself or start in the dictionary.
+			for (int32 from = pos - offset, end = pos + len; pos < end; ++from, ++pos) {
+				out[pos] = from < 0 ? dict[dictSize + from] : out[from];
+			}
+		}
+
+		return pos;
+	}
+
+	std::vector<byte> PacketCodec::train(std::span<const std::vector<byte>> samples, int32 size) {
+		// Similar to the COVER algorithm used by zstd. Score fixed size segments
+		// of the samples by how common the sequences in them are and greedily
+		// pick the best segments. Once a sequence has been picked it no longer
+		// contributes to the score of other segments.
+		constexpr int32 gram = 8;
+		constexpr int32 segment = 64;
+		size = std::clamp(size, 0, maxDictionarySize);
+
+		Engine::FlatHashMap<uint64, int32> counts;
+		for (const auto& sample : samples) {
+			for (int32 i = 0; i + gram <= std::ssize(sample); ++i) {
+				++counts[readUnaligned<uint64>(sample.data() + i)];
+			}
+		}
+
+		class Candidate {
+			public:
+				int64 score;
+				int32 sample;
+				int32 pos;
+				bool operator<(const Candidate& other) const noexcept { return score < other.score; }
+		};
+
+		const auto score = [&](const Candidate& cand) {
+			const auto& sample = samples[cand.sample];
+			const auto end = std::min<int32>(cand.pos + segment, static_cast<int32>(sample.size()));
+			int64 total = 0;
+			for (int32 i = cand.pos; i + gram <= end; ++i) {
+				// Sequences seen only once are not worth including.
+				if (const auto c = counts[readUnaligned<uint64>(sample.data() + i)]; c > 1) {
+					total += c;
+				}
+			}
+			return total;
+		};
+
+		std::priority_queue<Candidate> queue;
+		for (int32 s = 0; s < std::ssize(samples); ++s) {
+			for (int32 i = 0; i + gram <= std::ssize(samples[s]); i += segment / 2) {
+				Candidate cand{0, s, i};
+				cand.score = score(cand);
+				if (cand.score > 0) { queue.push(cand); }
+			}
+		}
+
+		std::vector<Candidate> picked;
+		int32 total = 0;
+		while (!queue.empty() && total < size) {
+			auto cand = queue.top();
+			queue.pop();
+
+			// Scores only decrease as segments are picked so lazily updating them is enough.
+			if (const auto s = score(cand); s != cand.score) {
+				cand.score = s;
+				if (s > 0) { queue.push(cand); }
+				continue;
+			}
+
+			const auto& sample = samples[cand.sample];
+			const auto end = std::min<int32>(cand.pos + segment, static_cast<int32>(sample.size()));
+			for (int32 i = cand.pos; i + gram <= end; ++i) {
+				counts[readUnaligned<uint64>(sample.data() + i)] = 0;
+			}
+
+			total += end - cand.pos;
+			picked.push_back(cand);
+		}
+
+		// The best segments go at the end since they are the last to be truncated.
+		std::vector<byte> result;
+		result.reserve(total);
+		for (auto it = picked.rbegin(); it != picked.rend(); ++it) {
+			const auto& sample = samples[it->sample];
+			const auto end = std::min<int32>(it->pos + segment, static_cast<int32>(sample.size()));
+			result.insert(result.end(), sample.begin() + it->pos, sample.begin() + end);
+		}
+
+		if (std::ssize(result) > size) {
+			result.erase(result.begin(), result.end() - size);
+		}
+
+		return result;
+	}
+}
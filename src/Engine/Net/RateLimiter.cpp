@@ -0,0 +1,50 @@
+// STD
+#include <algorithm>
+
+// Engine
+#include <Engine/Hash.hpp>
+#include <Engine/Net/RateLimiter.hpp>
+
+
+namespace {
+	using namespace Engine::Types;
+
+	/**
+	 * Adds the tokens accumulated since the bucket was last used.
+	 * Unused buckets have a default time so they start full.
+	 */
+	void refill(auto& bucket, float32 rate, Engine::Clock::TimePoint time) {
+		const auto max = std::max(rate, 1.0f);
+		if (bucket.last == Engine::Clock::TimePoint{}) {
+			bucket.tokens = max;
+		} else {
+			bucket.tokens = std::min(bucket.tokens + Engine::Clock::Seconds{time - bucket.last}.count() * rate, max);
+		}
+		bucket.last = time;
+	}
+}
+
+namespace Engine::Net {
+	RateLimiter::RateLimiter(int32 bucketCount, float32 rate, float32 totalRate)
+		: buckets(bucketCount)
+		, rate{rate}
+		, totalRate{totalRate} {
+		ENGINE_DEBUG_ASSERT(bucketCount > 0);
+	}
+
+	bool RateLimiter::allow(const IPv4Address& addr, Engine::Clock::TimePoint time) {
+		// Keyed on the IP alone so a source can't get a new bucket by changing ports.
+		auto& bucket = buckets[Engine::hash(addr.address) % buckets.size()];
+		refill(bucket, rate, time);
+		refill(total, totalRate, time);
+
+		if (bucket.tokens < 1 || total.tokens < 1) {
+			++denied;
+			return false;
+		}
+
+		bucket.tokens -= 1;
+		total.tokens -= 1;
+		return true;
+	}
+}
@@ -2,23 +2,40 @@
 	#include <WinSock2.h>
 	#include <Ws2tcpip.h>
 	#include <Engine/Win32/Win32.hpp>
+#elif defined(__linux__)
+	#include <sys/socket.h>
+	#include <netinet/in.h>
+	#include <poll.h>
+	#include <unistd.h>
+	#include <cerrno>
+	#include <cstring>
 #else
 	#error Not yet implemented for this operating system.
 #endif
 
+// STD
+#include <algorithm>
+#include <cstring>
+#include <random>
+
+// PCG
+#include <pcg_random.hpp>
+
 // Engine
 #include <Engine/Net/UDPSocket.hpp>
+#include <Engine/Net/LoopbackNetwork.hpp>
 
 
-#ifdef ENGINE_UDP_NETWORK_SIM
-#include <queue>
-#include <random>
-#include <pcg_random.hpp>
-#include <Engine/Clock.hpp>
-#endif
+namespace {
+	#ifdef ENGINE_OS_WINDOWS
+		using SockLen = int;
+	#else
+		using SockLen = socklen_t;
+		ENGINE_INLINE int closesocket(int handle) { return close(handle); }
+	#endif
+}
 
 
-#ifdef ENGINE_UDP_NETWORK_SIM
 namespace Engine::Net {
 	class UDPSimState {
 		private:
@@ -35,18 +52,47 @@ namespace Engine::Net {
 				Engine::Clock::TimePoint time;
 				IPv4Address addr;
 				std::vector<byte> data;
-				bool operator>(const PacketData& other) const { return time > other.time; }
 			};
 
-			using Queue = std::priority_queue<
-				PacketData,
-				std::vector<PacketData>,
-				std::greater<PacketData>
-			>;
-			Queue sendBuffer;
-			Queue recvBuffer;
+			/** Orders the earliest packet first. For use with std::push_heap/pop_heap. */
+			constexpr static auto later = [](const PacketData& a, const PacketData& b) noexcept { return a.time > b.time; };
+
+			// These are heaps instead of std::priority_queue so buffers can be moved out and reused.
+			std::vector<PacketData> sendBuffer;
+			std::vector<PacketData> recvBuffer;
+
+			/** Previously used buffers so we don't allocate for every packet. */
+			std::vector<std::vector<byte>> spare;
+
+			std::vector<byte> acquire(const void* data, const int32 size) {
+				std::vector<byte> buff;
+				if (!spare.empty()) {
+					buff = std::move(spare.back());
+					spare.pop_back();
+				}
+
+				buff.assign(static_cast<const byte*>(data), static_cast<const byte*>(data) + size);
+				return buff;
+			}
+
+			void push(std::vector<PacketData>& heap, PacketData pkt) {
+				heap.push_back(std::move(pkt));
+				std::push_heap(heap.begin(), heap.end(), later);
+			}
+
+			/** Removes the earliest packet. Its buffer should be released once done with. */
+			PacketData pop(std::vector<PacketData>& heap) {
+				std::pop_heap(heap.begin(), heap.end(), later);
+				auto pkt = std::move(heap.back());
+				heap.pop_back();
+				return pkt;
+			}
+
+			void release(std::vector<byte> buff) {
+				spare.push_back(std::move(buff));
+			}
 
-			void simPacket(Queue& buff, const IPv4Address& addr, const void* data, const int32 size) {
+			void simPacket(std::vector<PacketData>& buff, const IPv4Address& addr, const void* data, const int32 size) {
 				if (random() < settings.loss) { return; }
 
 				// Ping var is total variance so between ping +- pingVar/2
@@ -56,21 +102,23 @@ namespace Engine::Net {
 					settings.halfPingAdd * (settings.jitter * 0.5f * r)
 				);
 
-				const auto now = Engine::Clock::now();
-				auto pkt = PacketData{
-					.time = now + settings.halfPingAdd + var,
-					.addr = addr,
-					.data = {static_cast<const byte*>(data), static_cast<const byte*>(data) + size},
-				};
-
+				const auto time = Engine::Clock::now() + settings.halfPingAdd + var;
 				if (random() < settings.duplicate) {
-					buff.push(pkt);
+					push(buff, {.time = time, .addr = addr, .data = acquire(data, size)});
 				}
 
-				buff.push(std::move(pkt));
+				push(buff, {.time = time, .addr = addr, .data = acquire(data, size)});
 			}
 
 		public:
+			/** If there are any simulated conditions. */
+			ENGINE_INLINE bool isActive() const noexcept {
+				return settings.halfPingAdd > Engine::Clock::Duration{} || settings.duplicate > 0 || settings.loss > 0;
+			}
+
+			/** If there are received packets still waiting to be delivered. */
+			ENGINE_INLINE bool hasRecvPending() const noexcept { return !recvBuffer.empty(); }
+
 			ENGINE_INLINE auto simSend(const IPv4Address& addr, const void* data, const int32 size) {
 				simPacket(sendBuffer, addr, data, size);
 				return size;
@@ -81,36 +129,32 @@ namespace Engine::Net {
 			}
 
 			void realSend(UDPSocket& socket) {
-				while (sendBuffer.size()) {
-					const auto& top = sendBuffer.top();
-					if (top.time > Engine::Clock::now()) { return; }
-					const auto saddr = top.addr.as<sockaddr_in>();
+				const auto now = Engine::Clock::now();
+				while (!sendBuffer.empty() && sendBuffer.front().time <= now) {
+					auto pkt = pop(sendBuffer);
+					const auto saddr = pkt.addr.as<sockaddr_in>();
 					sendto(
-						socket.handle, reinterpret_cast<const char*>(top.data.data()), static_cast<int>(top.data.size()), 0,
+						socket.handle, reinterpret_cast<const char*>(pkt.data.data()), static_cast<int>(pkt.data.size()), 0,
 						reinterpret_cast<const sockaddr*>(&saddr), sizeof(saddr)
 					);
-					sendBuffer.pop();
+					release(std::move(pkt.data));
 				}
 			}
 
 			int32 realRecv(void* data, int32 size, IPv4Address& address) {
-				if (!recvBuffer.empty()) {
-					const auto& top = recvBuffer.top();
-					if (top.time <= Engine::Clock::now()) {
-						const auto len = std::min(static_cast<int32>(top.data.size()), size);
-						memcpy(data, top.data.data(), len);
-						address = top.addr;
-						recvBuffer.pop();
-						return len;
-					}
-				}
-				return -1;
+				if (recvBuffer.empty() || recvBuffer.front().time > Engine::Clock::now()) { return -1; }
+
+				auto pkt = pop(recvBuffer);
+				const auto len = std::min(static_cast<int32>(pkt.data.size()), size);
+				memcpy(data, pkt.data.data(), len);
+				address = pkt.addr;
+				release(std::move(pkt.data));
+				return len;
 			}
 
 			auto& getSettings() noexcept { return settings; }
 	};
 }
-#endif
 
 namespace Engine::Net {
 	template<>
@@ -134,6 +178,16 @@ namespace Engine::Net {
 		};
 		return 0 == setsockopt(handle, IPPROTO_IP, IP_DROP_MEMBERSHIP, reinterpret_cast<const char*>(&group), sizeof(group));
 	}
+
+	template<>
+	bool UDPSocket::setOption<SocketOption::RecvBufferSize, int32>(const int32& size) {
+		return 0 == setsockopt(handle, SOL_SOCKET, SO_RCVBUF, reinterpret_cast<const char*>(&size), sizeof(size));
+	}
+
+	template<>
+	bool UDPSocket::setOption<SocketOption::SendBufferSize, int32>(const int32& size) {
+		return 0 == setsockopt(handle, SOL_SOCKET, SO_SNDBUF, reinterpret_cast<const char*>(&size), sizeof(size));
+	}
 }
 
 
@@ -141,30 +195,38 @@ namespace Engine::Net {
 	UDPSocket::UDPSocket(const uint16 port, const SocketFlag flags) {
 		init(flags);
 		bind(port);
+		sim = new UDPSimState();
+	}
 
-		#ifdef ENGINE_UDP_NETWORK_SIM
+	UDPSocket::UDPSocket(LoopbackNetwork& network, const uint16 port)
+		: loopback{&network}
+		, loopbackPort{network.bind(port)} {
+		if (!loopbackPort) {
+			ENGINE_WARN2("Loopback port {} is already in use.", port);
+		}
+
+		// Unused but keeps getSimSettings valid.
 		sim = new UDPSimState();
-		#endif
 	}
 
 	UDPSocket::~UDPSocket() {
+		if (loopback && loopbackPort) { loopback->unbind(loopbackPort); }
 		if (handle != invalid) { closesocket(handle); }
-		#ifdef ENGINE_UDP_NETWORK_SIM
 		delete sim;
-		#endif
 	};
 	
-	#ifdef ENGINE_UDP_NETWORK_SIM
 	UDPSimSettings& UDPSocket::getSimSettings() noexcept {
 		return sim->getSettings();
 	}
-	#endif
 	
-	#ifdef ENGINE_UDP_NETWORK_SIM
 	void UDPSocket::realSimSend() {
+		if (loopback || !sim) { return; }
 		return sim->realSend(*this);
 	}
-	#endif
+
+	bool UDPSocket::useSim() const noexcept {
+		return sim && !loopback && (sim->isActive() || sim->hasRecvPending());
+	}
 	
 	void UDPSocket::init(const SocketFlag flags) {
 		ENGINE_DEBUG_ASSERT(handle == invalid, "Only an uninitialized socket can be initialized.");
@@ -173,7 +235,7 @@ namespace Engine::Net {
 		int type = SOCK_DGRAM;
 
 		#ifndef ENGINE_OS_WINDOWS
-		type |= flags & SocketFlags::NonBlocking ? SOCK_NONBLOCK : 0;
+		type |= flags & SocketFlag::NonBlocking ? SOCK_NONBLOCK : 0;
 		#endif
 
 		handle = ::socket(AF_INET, type, IPPROTO_UDP);
@@ -193,6 +255,16 @@ namespace Engine::Net {
 				showError();
 			}
 		}
+
+		if (flags & SocketFlag::ReusePort) {
+			#ifdef SO_REUSEPORT
+			if (int val = 1; setsockopt(handle, SOL_SOCKET, SO_REUSEPORT, reinterpret_cast<const char*>(&val), sizeof(val))) {
+				showError();
+			}
+			#else
+			ENGINE_WARN2("SocketFlag::ReusePort is not supported on this platform.");
+			#endif
+		}
 	}
 
 	void UDPSocket::bind(const uint16 port) {
@@ -205,12 +277,15 @@ namespace Engine::Net {
 	}
 
 	int32 UDPSocket::send(const void* data, int32 size, const IPv4Address& address) {
-		const auto saddr = address.as<sockaddr_storage>();
-		
-		#ifdef ENGINE_UDP_NETWORK_SIM
-			return sim->simSend(saddr, data, size);
-		#endif
+		if (loopback) {
+			return loopback->send(loopbackPort, address, data, size) ? size : -1;
+		}
+
+		if (sim && sim->isActive()) {
+			return sim->simSend(address, data, size);
+		}
 
+		const auto saddr = address.as<sockaddr_storage>();
 		const auto sent = sendto(handle,
 			reinterpret_cast<const char*>(data), size, 0,
 			reinterpret_cast<const sockaddr*>(&saddr), sizeof(saddr)
@@ -224,27 +299,196 @@ namespace Engine::Net {
 	}
 
 	int32 UDPSocket::recv(void* data, int32 size, IPv4Address& address) {
+		if (loopback) {
+			return loopback->recv(loopbackPort, data, size, address);
+		}
+
 		sockaddr_storage from;
-		int fromlen = sizeof(from);
+		SockLen fromlen = sizeof(from);
 		int32 len = recvfrom(handle, static_cast<char*>(data), size, 0, reinterpret_cast<sockaddr*>(&from), &fromlen);
 		address = from;
 
-		#ifdef ENGINE_UDP_NETWORK_SIM
-		{
+		// Keep going through the sim until any delayed packets have been delivered.
+		if (useSim()) {
 			if (len > -1) {
-				sim->simRecv(from, data, len);
+				sim->simRecv(address, data, len);
 			}
 
 			return sim->realRecv(data, size, address);
 		}
-		#endif
 
 		return len;
 	}
 
+	int32 UDPSocket::sendEach(std::span<const Datagram> datagrams) {
+		int32 total = 0;
+		for (const auto& dgram : datagrams) {
+			if (send(dgram.data, dgram.size, dgram.address) == dgram.size) { ++total; }
+		}
+		return total;
+	}
+
+	int32 UDPSocket::recvEach(std::span<Datagram> datagrams) {
+		const auto size = std::min(maxBatchSize, static_cast<int32>(datagrams.size()));
+		int32 total = 0;
+		for (; total < size; ++total) {
+			auto& dgram = datagrams[total];
+			const auto len = recv(dgram.data, dgram.size, dgram.address);
+			if (len < 0) { break; }
+			dgram.size = len;
+		}
+		return total;
+	}
+
+	int32 UDPSocket::sendBatch(std::span<const Datagram> datagrams) {
+		if (loopback || (sim && sim->isActive())) {
+			return sendEach(datagrams);
+		}
+
+		#if !defined(__linux__)
+			return sendEach(datagrams);
+		#else
+			int32 total = 0;
+			mmsghdr msgs[maxBatchSize];
+			iovec iovs[maxBatchSize];
+			sockaddr_in addrs[maxBatchSize];
+
+			while (!datagrams.empty()) {
+				const auto count = std::min(maxBatchSize, static_cast<int32>(datagrams.size()));
+				for (int32 i = 0; i < count; ++i) {
+					const auto& dgram = datagrams[i];
+					addrs[i] = dgram.address.as<sockaddr_in>();
+					iovs[i] = {.iov_base = dgram.data, .iov_len = static_cast<size_t>(dgram.size)};
+					msgs[i] = {};
+					msgs[i].msg_hdr.msg_name = &addrs[i];
+					msgs[i].msg_hdr.msg_namelen = sizeof(addrs[i]);
+					msgs[i].msg_hdr.msg_iov = &iovs[i];
+					msgs[i].msg_hdr.msg_iovlen = 1;
+				}
+
+				const auto sent = sendmmsg(static_cast<int>(handle), msgs, count, 0);
+				if (sent < 0) {
+					if (errno == EAGAIN || errno == EWOULDBLOCK) {
+						if (waitWritable(sendWaitTimeout)) { continue; }
+						break;
+					}
+
+					// Skip the failed datagram so one bad address doesn't block the rest.
+					ENGINE_WARN2("Unable to send datagram to {}: {}", datagrams.front().address, strerror(errno));
+					datagrams = datagrams.subspan(1);
+					continue;
+				}
+
+				total += sent;
+				datagrams = datagrams.subspan(sent);
+			}
+
+			return total;
+		#endif
+	}
+
+	int32 UDPSocket::recvBatch(std::span<Datagram> datagrams) {
+		if (loopback || useSim()) {
+			return recvEach(datagrams);
+		}
+
+		#if !defined(__linux__)
+			return recvEach(datagrams);
+		#else
+			const auto size = std::min(maxBatchSize, static_cast<int32>(datagrams.size()));
+			mmsghdr msgs[maxBatchSize];
+			iovec iovs[maxBatchSize];
+			sockaddr_storage addrs[maxBatchSize];
+
+			for (int32 i = 0; i < size; ++i) {
+				auto& dgram = datagrams[i];
+				iovs[i] = {.iov_base = dgram.data, .iov_len = static_cast<size_t>(dgram.size)};
+				msgs[i] = {};
+				msgs[i].msg_hdr.msg_name = &addrs[i];
+				msgs[i].msg_hdr.msg_namelen = sizeof(addrs[i]);
+				msgs[i].msg_hdr.msg_iov = &iovs[i];
+				msgs[i].msg_hdr.msg_iovlen = 1;
+			}
+
+			// MSG_WAITFORONE matches `recv`: block only for the first datagram on blocking sockets.
+			const auto total = recvmmsg(static_cast<int>(handle), msgs, size, MSG_WAITFORONE, nullptr);
+			if (total < 0) { return 0; }
+
+			for (int32 i = 0; i < total; ++i) {
+				auto& dgram = datagrams[i];
+				dgram.size = static_cast<int32>(msgs[i].msg_len);
+				dgram.address = addrs[i];
+			}
+
+			return total;
+		#endif
+	}
+
+	bool UDPSocket::wait(Engine::Clock::Duration timeout) {
+		if (loopback) {
+			return loopback->wait(loopbackPort, timeout);
+		}
+
+		const auto ms = static_cast<int>(std::chrono::ceil<std::chrono::milliseconds>(timeout).count());
+
+		#ifdef ENGINE_OS_WINDOWS
+			WSAPOLLFD fd = {.fd = handle, .events = POLLRDNORM};
+			return WSAPoll(&fd, 1, ms) > 0;
+		#else
+			pollfd fd = {.fd = static_cast<int>(handle), .events = POLLIN};
+			return poll(&fd, 1, ms) > 0;
+		#endif
+	}
+
+	bool UDPSocket::waitWritable(Engine::Clock::Duration timeout) {
+		const auto ms = static_cast<int>(std::chrono::ceil<std::chrono::milliseconds>(timeout).count());
+
+		#ifdef ENGINE_OS_WINDOWS
+			WSAPOLLFD fd = {.fd = handle, .events = POLLWRNORM};
+			return WSAPoll(&fd, 1, ms) > 0;
+		#else
+			pollfd fd = {.fd = static_cast<int>(handle), .events = POLLOUT};
+			return poll(&fd, 1, ms) > 0;
+		#endif
+	}
+
+	void UDPSocket::queue(const void* data, int32 size, const IPv4Address& address) {
+		const auto* bytes = static_cast<const byte*>(data);
+		sendQueueData.insert(sendQueueData.end(), bytes, bytes + size);
+		sendQueue.push_back({.data = nullptr, .size = size, .address = address});
+
+		if (std::ssize(sendQueue) >= maxBatchSize) {
+			flush();
+		}
+	}
+
+	void UDPSocket::flush() {
+		if (sendQueue.empty()) { return; }
+
+		// Data is stored contiguously in queue order.
+		auto* cur = sendQueueData.data();
+		for (auto& dgram : sendQueue) {
+			dgram.data = cur;
+			cur += dgram.size;
+		}
+
+		const auto sent = sendBatch(sendQueue);
+		if (const auto dropped = std::ssize(sendQueue) - sent; dropped > 0) {
+			sendDropped += dropped;
+			ENGINE_WARN2("Dropped {} of {} queued datagrams. {} dropped total.", dropped, sendQueue.size(), sendDropped);
+		}
+
+		sendQueue.clear();
+		sendQueueData.clear();
+	}
+
 	IPv4Address UDPSocket::getAddress() const {
+		if (loopback) {
+			return LoopbackNetwork::address(loopbackPort);
+		}
+
 		sockaddr_storage addr = {};
-		int len = sizeof(addr);
+		SockLen len = sizeof(addr);
 		getsockname(handle, reinterpret_cast<sockaddr*>(&addr), &len);
 		return addr;
 	}
@@ -254,7 +498,8 @@ namespace Engine::Net {
 		const auto err = WSAGetLastError();
 		ENGINE_ERROR(err, " - ", Win32::getLastErrorMessage());
 		#else
-		#error TODO: impl non windows - check errno
+		const auto err = errno;
+		ENGINE_ERROR(err, " - ", strerror(err));
 		#endif
 	}
 }
@@ -2,6 +2,9 @@
 #if defined(ENGINE_OS_WINDOWS)
 	#include <WinSock2.h>
 	#include <WS2tcpip.h>
+#elif defined(__linux__)
+	#include <netdb.h>
+	#include <sys/socket.h>
 #endif
 
 // STD
@@ -9,19 +12,25 @@
 
 // Engine
 #include <Engine/Net/Net.hpp>
-#include <Engine/Win32/Win32.hpp>
+#if defined(ENGINE_OS_WINDOWS)
+	#include <Engine/Win32/Win32.hpp>
+#endif
 
 
 namespace Engine::Net {
 	bool startup() {
-		WSADATA data;
-		auto err = WSAStartup(MAKEWORD(2,2), &data);
-		if (err) { return false; }
+		#if defined(ENGINE_OS_WINDOWS)
+			WSADATA data;
+			auto err = WSAStartup(MAKEWORD(2,2), &data);
+			if (err) { return false; }
+		#endif
 		return true;
 	}
 
 	bool shutdown() {
-		if (WSACleanup()) { return false; }
+		#if defined(ENGINE_OS_WINDOWS)
+			if (WSACleanup()) { return false; }
+		#endif
 		return true;
 	}
 	
@@ -42,7 +51,11 @@ namespace Engine::Net {
 		std::string serv = matches[3].matched ? matches[3].str() : matches[1].str();
 
 		if (auto err = getaddrinfo(host.data(), serv.data(), &hints, &results); err) {
-			ENGINE_WARN("Address error - ", Engine::Win32::getLastErrorMessage());
+			#if defined(ENGINE_OS_WINDOWS)
+				ENGINE_WARN("Address error - ", Engine::Win32::getLastErrorMessage());
+			#else
+				ENGINE_WARN("Address error - ", gai_strerror(err));
+			#endif
 		} else {
 			for (auto ptr = results; ptr; ptr = results->ai_next) {
 				if (ptr->ai_family != AF_INET) { continue; }
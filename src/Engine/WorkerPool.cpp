@@ -0,0 +1,66 @@
+// Engine
+#include <Engine/WorkerPool.hpp>
+
+
+namespace Engine {
+	WorkerPool::WorkerPool(int32 threadCount) {
+		threads.resize(std::max(threadCount, 0));
+		for (auto& thread : threads) {
+			thread = std::thread{&WorkerPool::workerThread, this};
+		}
+	}
+
+	WorkerPool::~WorkerPool() {
+		{
+			std::lock_guard lock{mutex};
+			threadsShouldExit = true;
+		}
+
+		jobWait.notify_all();
+		for (auto& thread : threads) { thread.join(); }
+	}
+
+	void WorkerPool::run(int32 count, JobFunc func, void* context) {
+		// Not worth waking the workers.
+		if (threads.empty() || count <= 1) {
+			for (int32 i = 0; i < count; ++i) { func(context, i); }
+			return;
+		}
+
+		std::unique_lock lock{mutex};
+		jobFunc = func;
+		jobContext = context;
+		jobNext = 0;
+		jobCount = count;
+		jobRemaining = count;
+		jobWait.notify_all();
+
+		runJobs(lock);
+		doneWait.wait(lock, [&]{ return jobRemaining == 0; });
+	}
+
+	void WorkerPool::runJobs(std::unique_lock<std::mutex>& lock) {
+		while (jobNext < jobCount) {
+			const auto func = jobFunc;
+			const auto context = jobContext;
+			const auto i = jobNext++;
+
+			lock.unlock();
+			func(context, i);
+			lock.lock();
+
+			if (--jobRemaining == 0) {
+				doneWait.notify_one();
+			}
+		}
+	}
+
+	void WorkerPool::workerThread() {
+		std::unique_lock lock{mutex};
+		while (true) {
+			jobWait.wait(lock, [&]{ return threadsShouldExit || jobNext < jobCount; });
+			if (threadsShouldExit) { return; }
+			runJobs(lock);
+		}
+	}
+}
@@ -0,0 +1,171 @@
+// STD
+#include <algorithm>
+#include <cmath>
+
+// PCG
+#include <pcg_random.hpp>
+
+// Engine
+#include <Engine/Noise/noise.hpp>
+
+// Game
+#include <Game/BotClient.hpp>
+#include <Game/systems/NetworkingSystem.hpp>
+
+
+namespace Game {
+	BotClient::BotClient(Engine::Net::UDPSocket socket, const Engine::Net::IPv4Address& server, const Engine::Net::PacketCodec& codec, uint32 seed)
+		: socket{std::move(socket)}
+		, conn{server, Engine::Clock::now()}
+		, codec{codec}
+		, scriptSeed{seed} {
+
+		pcg32 rng{seed};
+		uint32 key;
+		while (!(key = rng())) {}
+
+		conn.setKeyLocal(key);
+		conn.setState(ConnectionState::Connecting);
+	}
+
+	void BotClient::update(Engine::ECS::Tick tick) {
+		recv();
+
+		const auto now = Engine::Clock::now();
+		if (conn.getState() == ConnectionState::Connecting && !conn.getKeyRemote() && now - lastRequest >= std::chrono::seconds{1}) {
+			lastRequest = now;
+			sendConnectRequest();
+		}
+
+		if (conn.getState() == ConnectionState::Connected) {
+			sendAction(tick + inputLead);
+		}
+
+		conn.send(socket);
+		socket.flush();
+	}
+
+	void BotClient::recv() {
+		while (true) {
+			for (uintz i = 0; i < packets.size(); ++i) {
+				datagrams[i] = {.data = &packets[i], .size = sizeof(packets[i])};
+			}
+
+			const auto count = socket.recvBatch(datagrams);
+			for (int32 i = 0; i < count; ++i) {
+				const auto& packet = packets[i];
+				const auto& dgram = datagrams[i];
+
+				if (dgram.address != conn.address()) { continue; }
+				if (packet.getProtocol() != Engine::Net::protocol || packet.getVersion() != Engine::Net::Packet::version) { continue; }
+				if (conn.getState() == ConnectionState::Connected && packet.getKey() != conn.getKeyLocal()) { continue; }
+				if (!conn.recv(packet, dgram.size, Engine::Clock::now())) { continue; }
+
+				while (true) {
+					auto [hdr, msg] = conn.recvNext();
+					if (hdr.type == 0) { break; }
+
+					if (hdr.type < MessageType::_count) {
+						auto& stat = stats[hdr.type];
+						++stat.count;
+						stat.bytes += sizeof(hdr) + hdr.size;
+					}
+
+					handleMessage(hdr, msg);
+				}
+			}
+
+			if (count < std::ssize(datagrams)) { break; }
+		}
+	}
+
+	void BotClient::handleMessage(const Engine::Net::MessageHeader hdr, Engine::Net::BufferReader& msg) {
+		switch (hdr.type) {
+			case MessageType::CONNECT_CHALLENGE: {
+				// Same as the real client. See NetworkingSystem CONNECT_CHALLENGE.
+				uint32 cookie = {};
+				if (!conn.getKeyRemote() && msg.read(&cookie)) {
+					if (auto reply = conn.beginMessage<MessageType::CONNECT_AUTH>()) {
+						reply.write(conn.getKeyLocal());
+						reply.write(cookie);
+						writeMessagePadding(reply.getBufferWriter());
+					}
+				}
+				break;
+			}
+			case MessageType::CONNECT_CONFIRM: {
+				uint32 key = {};
+				if (!msg.read(&key) || !key) { break; }
+				conn.setKeyRemote(key);
+				conn.setState(ConnectionState::Connected);
+				break;
+			}
+			case MessageType::CONFIG_NETWORK: {
+				float32 rate;
+				uint32 codecId;
+				if (!msg.read(&rate) || !msg.read(&codecId)) { break; }
+
+				const auto& cvars = Engine::getGlobalConfig().cvars;
+				if (!std::isfinite(rate)) { rate = cvars.net_packet_rate_min; }
+				conn.setPacketSendRate(std::clamp(rate, cvars.net_packet_rate_min, cvars.net_packet_rate_max));
+
+				// Same as the real client. See NetworkingSystem CONFIG_NETWORK.
+				const bool accept = codecId == codec.getId() && cvars.net_compression;
+				conn.setPacketCodec(accept ? &codec : nullptr);
+				conn.setPacketCompression(accept);
+
+				if (auto reply = conn.beginMessage<MessageType::CONFIG_NETWORK>()) {
+					reply.write(conn.getPacketRecvRate());
+					reply.write(conn.getPacketCodecId());
+				}
+				break;
+			}
+			case MessageType::DISCONNECT: {
+				conn.setState(ConnectionState::Disconnected);
+				conn.setKeyRemote(0);
+				break;
+			}
+		}
+
+		// Everything else (replication, map data, etc.) is only counted.
+		msg.discard();
+	}
+
+	void BotClient::sendConnectRequest() {
+		if (auto msg = conn.beginMessage<MessageType::CONNECT_REQUEST>()) {
+			msg.write(conn.getKeyLocal());
+			writeMessagePadding(msg.getBufferWriter());
+		}
+	}
+
+	void BotClient::sendAction(Engine::ECS::Tick tick) {
+		// Same format as the real client. See ActionSystem::tick.
+		if (auto msg = conn.beginMessage<MessageType::ACTION>()) {
+			msg.write(tick);
+
+			const auto count = static_cast<int32>(Engine::getGlobalConfig().cvars.net_input_redundancy);
+			ActionState window[ActionComponent::maxStates / 2];
+			for (int32 age = 0; age < count; ++age) {
+				window[age] = getScriptedState(tick - age);
+			}
+
+			ActionState::netWriteWindow(msg, count, [&](int32 age) -> const ActionState& { return window[age]; });
+			msg.writeFlushBits();
+		}
+	}
+
+	ActionState BotClient::getScriptedState(Engine::ECS::Tick tick) const {
+		// Walk in a random direction, changing every couple of seconds.
+		constexpr Engine::ECS::Tick period = 2 * tickrate;
+		const auto phase = (tick + scriptSeed) / period;
+		const auto dir = static_cast<int32>(Engine::Noise::lcg(scriptSeed ^ phase) % 4);
+		const bool first = (tick + scriptSeed) % period == 0;
+
+		ActionState state = {};
+		auto& btn = state.buttons[static_cast<int32>(Action::MoveUp) + dir];
+		btn.latest = true;
+		btn.pressCount = first;
+		state.target = {dir & 1 ? 1.0f : -1.0f, dir & 2 ? 1.0f : -1.0f};
+		return state;
+	}
+}
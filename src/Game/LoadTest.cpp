@@ -0,0 +1,89 @@
+// Game
+#include <Game/LoadTest.hpp>
+#include <Game/World.hpp>
+#include <Game/systems/NetworkingSystem.hpp>
+
+
+namespace Game {
+	LoadTest::LoadTest(uint32 botCount)
+		: codec{loadPacketCodec()}
+		, botCount{botCount} {
+	}
+
+	void LoadTest::update(World& world, Engine::Clock::Duration frameTime) {
+		const auto server = world.getSystem<NetworkingSystem>().getSocket().getAddress();
+
+		// Ramp up slowly so we don't flood the server with handshakes on the first tick.
+		constexpr uint32 spawnPerUpdate = 8;
+		for (uint32 i = 0; i < spawnPerUpdate && bots.size() < botCount; ++i) {
+			const auto seed = static_cast<uint32>(bots.size() + 1);
+			bots.push_back(std::make_unique<BotClient>(
+				Engine::Net::UDPSocket{network, 0},
+				server,
+				codec,
+				seed
+			));
+		}
+
+		for (auto& bot : bots) {
+			bot->update(world.getTick());
+		}
+
+		tickTimeTotal += frameTime;
+		tickTimeMax = std::max(tickTimeMax, frameTime);
+		++tickCount;
+
+		const auto now = Engine::Clock::now();
+		if (lastReport == Engine::Clock::TimePoint{}) {
+			lastReport = now;
+		} else if (now - lastReport >= reportInterval) {
+			report();
+			lastReport = now;
+		}
+	}
+
+	void LoadTest::report() {
+		const auto elapsed = Engine::Clock::Seconds{reportInterval}.count();
+
+		uint32 connected = 0;
+		uint64 bytesRecv = 0;
+		std::array<BotClient::MessageStats, MessageType::_count> totals = {};
+		for (const auto& bot : bots) {
+			connected += bot->isConnected();
+			bytesRecv += bot->getConnection().getTotalBytesRecv();
+
+			const auto& stats = bot->getMessageStats();
+			for (int32 i = 0; i < MessageType::_count; ++i) {
+				totals[i].count += stats[i].count;
+				totals[i].bytes += stats[i].bytes;
+			}
+		}
+
+		const auto plys = std::max(connected, 1u);
+		ENGINE_LOG2("Load test: {}/{} bots connected, tick avg {:.3f}ms, max {:.3f}ms, {:.0f} bytes/s per player",
+			connected,
+			botCount,
+			Engine::Clock::Milliseconds{tickTimeTotal}.count() / std::max(tickCount, 1u),
+			Engine::Clock::Milliseconds{tickTimeMax}.count(),
+			static_cast<float64>(bytesRecv - lastBytesRecv) / elapsed / plys
+		);
+
+		for (int32 i = 0; i < MessageType::_count; ++i) {
+			const auto count = totals[i].count - lastStats[i].count;
+			if (!count) { continue; }
+
+			const auto bytes = totals[i].bytes - lastStats[i].bytes;
+			ENGINE_LOG2("    {:<20} {:>8.1f} msg/s per player {:>10.0f} bytes/s per player",
+				getMessageMetaInfo(static_cast<MessageType>(i)).name,
+				static_cast<float64>(count) / elapsed / plys,
+				static_cast<float64>(bytes) / elapsed / plys
+			);
+		}
+
+		lastStats = totals;
+		lastBytesRecv = bytesRecv;
+		tickTimeTotal = {};
+		tickTimeMax = {};
+		tickCount = 0;
+	}
+}
@@ -1,5 +1,5 @@
 // Engine
-#include <Engine/Net/UDPSocket.hpp> // Required for ENGINE_UDP_NETWORK_SIM - probably move to premake config.
+#include <Engine/Net/UDPSocket.hpp>
 
 // Game
 #include <Game/UI/NetCondPane.hpp>
@@ -11,59 +11,62 @@ namespace Game::UI {
 		getContent()->setLayout(new EUI::DirectionalLayout{EUI::Direction::Vertical, EUI::Align::Start, EUI::Align::Stretch, ctx->getTheme().sizes.pad1});
 		setTitle("Network Conditions");
 				
-		#ifndef ENGINE_UDP_NETWORK_SIM
-			auto label = ctx->createPanel<EUI::Label>(getContent());
-			label->autoText("Network simulation disabled.");
-		#else
-			addSlider("Half Ping Add").setLimits(0, 500).setValue(0).bind(
-				[](EUI::Slider& s){
-					auto& world = s.getContext()->getUserdata<EngineInstance>()->getWorld();
-					auto& settings = world.getSystem<NetworkingSystem>().getSocket().getSimSettings();
-					s.setValue(static_cast<float64>(std::chrono::duration_cast<std::chrono::milliseconds>(settings.halfPingAdd).count()));
-				},
-				[](EUI::Slider& s){
-					auto& world = s.getContext()->getUserdata<EngineInstance>()->getWorld();
-					auto& settings = world.getSystem<NetworkingSystem>().getSocket().getSimSettings();
-					settings.halfPingAdd = std::chrono::milliseconds{static_cast<int64>(s.getValue())};
-				}
-			);
-			addSlider("Jitter").setLimits(0, 1).setValue(0).bind(
-				[](EUI::Slider& s){
-					auto& world = s.getContext()->getUserdata<EngineInstance>()->getWorld();
-					auto& settings = world.getSystem<NetworkingSystem>().getSocket().getSimSettings();
-					s.setValue(settings.jitter);
-				},
-				[](EUI::Slider& s){
-					auto& world = s.getContext()->getUserdata<EngineInstance>()->getWorld();
-					auto& settings = world.getSystem<NetworkingSystem>().getSocket().getSimSettings();
-					settings.jitter = static_cast<float32>(s.getValue());
-				}
-			);
-			addSlider("Duplicate Chance").setLimits(0, 1).setValue(0).bind(
-				[](EUI::Slider& s){
-					auto& world = s.getContext()->getUserdata<EngineInstance>()->getWorld();
-					auto& settings = world.getSystem<NetworkingSystem>().getSocket().getSimSettings();
-					s.setValue(settings.duplicate);
-				},
-				[](EUI::Slider& s){
-					auto& world = s.getContext()->getUserdata<EngineInstance>()->getWorld();
-					auto& settings = world.getSystem<NetworkingSystem>().getSocket().getSimSettings();
-					settings.duplicate = static_cast<float32>(s.getValue());
-				}
-			);
-			addSlider("Loss").setLimits(0, 1).setValue(0).bind(
-				[](EUI::Slider& s){
-					auto& world = s.getContext()->getUserdata<EngineInstance>()->getWorld();
-					auto& settings = world.getSystem<NetworkingSystem>().getSocket().getSimSettings();
-					s.setValue(settings.loss);
-				},
-				[](EUI::Slider& s){
-					auto& world = s.getContext()->getUserdata<EngineInstance>()->getWorld();
-					auto& settings = world.getSystem<NetworkingSystem>().getSocket().getSimSettings();
-					settings.loss = static_cast<float32>(s.getValue());
-				}
-			);
-		#endif
+		addSlider("Half Ping Add").setLimits(0, 500).setValue(0).bind(
+			[](EUI::Slider& s){
+				auto& world = s.getContext()->getUserdata<EngineInstance>()->getWorld();
+				const auto& settings = world.getSystem<NetworkingSystem>().getSimSettings();
+				s.setValue(static_cast<float64>(std::chrono::duration_cast<std::chrono::milliseconds>(settings.halfPingAdd).count()));
+			},
+			[](EUI::Slider& s){
+				auto& world = s.getContext()->getUserdata<EngineInstance>()->getWorld();
+				auto& netSys = world.getSystem<NetworkingSystem>();
+				auto settings = netSys.getSimSettings();
+				settings.halfPingAdd = std::chrono::milliseconds{static_cast<int64>(s.getValue())};
+				netSys.setSimSettings(settings);
+			}
+		);
+		addSlider("Jitter").setLimits(0, 1).setValue(0).bind(
+			[](EUI::Slider& s){
+				auto& world = s.getContext()->getUserdata<EngineInstance>()->getWorld();
+				const auto& settings = world.getSystem<NetworkingSystem>().getSimSettings();
+				s.setValue(settings.jitter);
+			},
+			[](EUI::Slider& s){
+				auto& world = s.getContext()->getUserdata<EngineInstance>()->getWorld();
+				auto& netSys = world.getSystem<NetworkingSystem>();
+				auto settings = netSys.getSimSettings();
+				settings.jitter = static_cast<float32>(s.getValue());
+				netSys.setSimSettings(settings);
+			}
+		);
+		addSlider("Duplicate Chance").setLimits(0, 1).setValue(0).bind(
+			[](EUI::Slider& s){
+				auto& world = s.getContext()->getUserdata<EngineInstance>()->getWorld();
+				const auto& settings = world.getSystem<NetworkingSystem>().getSimSettings();
+				s.setValue(settings.duplicate);
+			},
+			[](EUI::Slider& s){
+				auto& world = s.getContext()->getUserdata<EngineInstance>()->getWorld();
+				auto& netSys = world.getSystem<NetworkingSystem>();
+				auto settings = netSys.getSimSettings();
+				settings.duplicate = static_cast<float32>(s.getValue());
+				netSys.setSimSettings(settings);
+			}
+		);
+		addSlider("Loss").setLimits(0, 1).setValue(0).bind(
+			[](EUI::Slider& s){
+				auto& world = s.getContext()->getUserdata<EngineInstance>()->getWorld();
+				const auto& settings = world.getSystem<NetworkingSystem>().getSimSettings();
+				s.setValue(settings.loss);
+			},
+			[](EUI::Slider& s){
+				auto& world = s.getContext()->getUserdata<EngineInstance>()->getWorld();
+				auto& netSys = world.getSystem<NetworkingSystem>();
+				auto settings = netSys.getSimSettings();
+				settings.loss = static_cast<float32>(s.getValue());
+				netSys.setSimSettings(settings);
+			}
+		);
 	}
 
 	EUI::Slider& NetCondPane::addSlider(std::string_view txt) {
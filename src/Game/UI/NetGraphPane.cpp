@@ -94,6 +94,7 @@ namespace {
 								auto v = static_cast<float32>(s.getValue());
 								conn->setPacketRecvRate(v);
 								msg.write(v);
+								msg.write(conn->getPacketCodecId());
 								return;
 							}
 							ENGINE_DEBUG_ONLY(conn->_debug_AllowMessages = false);
@@ -23,9 +23,57 @@ namespace Game {
 		snap = true;
 	}
 
+	void NetworkTraits<PhysicsBodyComponent>::writeState(const b2Transform& trans, const b2Vec2& vel, Engine::Net::StaticBufferWriter& buff) {
+		using Engine::Net::writeQuantized;
+
+		// Zones split well before positions leave the range and bodies shouldn't get this fast,
+		// but if they do send the exact state instead of teleporting the body to the clamped one.
+		const bool exact = !positionQuant.contains(trans.p.x) || !positionQuant.contains(trans.p.y)
+			|| !velocityQuant.contains(vel.x) || !velocityQuant.contains(vel.y);
+
+		buff.writeBits<1>(exact);
+		if (exact) {
+			ENGINE_WARN2("Physics state is outside of the quantized range, sending it unquantized. Position = ({}, {}), Velocity = ({}, {})", trans.p.x, trans.p.y, vel.x, vel.y);
+			buff.writeFlushBits();
+			buff.write(trans.p);
+			buff.write(trans.q.GetAngle());
+			buff.write(vel);
+			return;
+		}
+
+		writeQuantized<positionQuant>(buff, trans.p.x);
+		writeQuantized<positionQuant>(buff, trans.p.y);
+		writeQuantized<angleQuant>(buff, trans.q.GetAngle());
+		writeQuantized<velocityQuant>(buff, vel.x);
+		writeQuantized<velocityQuant>(buff, vel.y);
+		buff.writeFlushBits();
+	}
+
+	bool NetworkTraits<PhysicsBodyComponent>::readState(b2Transform& trans, b2Vec2& vel, Engine::Net::BufferReader& buff) {
+		using Engine::Net::readQuantized;
+		float32 angle;
+
+		bool exact;
+		if (!buff.readBits<1>(&exact)) { return false; }
+		if (exact) {
+			buff.readFlushBits();
+			if (!buff.read(&trans.p) || !buff.read(&angle) || !buff.read(&vel)) { return false; }
+			trans.q.Set(angle);
+			return true;
+		}
+
+		const bool success = readQuantized<positionQuant>(buff, trans.p.x)
+			&& readQuantized<positionQuant>(buff, trans.p.y)
+			&& readQuantized<angleQuant>(buff, angle)
+			&& readQuantized<velocityQuant>(buff, vel.x)
+			&& readQuantized<velocityQuant>(buff, vel.y);
+		buff.readFlushBits();
+		trans.q.Set(angle);
+		return success;
+	}
+
 	void NetworkTraits<PhysicsBodyComponent>::write(const PhysicsBodyComponent& obj, Engine::Net::StaticBufferWriter& buff, EngineInstance& engine, World& world, Engine::ECS::Entity ent) {
-		buff.write<b2Transform>(obj.getTransform());
-		buff.write<b2Vec2>(obj.getVelocity());
+		writeState(obj.getTransform(), obj.getVelocity(), buff);
 		buff.write<ZoneId>(obj.getZoneId());
 	}
 
@@ -81,10 +129,11 @@ namespace Game {
 
 	void NetworkTraits<PhysicsBodyComponent>::read(PhysicsBodyComponent& body, Engine::Net::BufferReader& buff, EngineInstance& engine, World& world, Engine::ECS::Entity ent) {
 		b2Transform trans;
-		buff.read<b2Transform>(&trans);
-
 		b2Vec2 vel;
-		buff.read<b2Vec2>(&vel);
+		if (!readState(trans, vel, buff)) {
+			ENGINE_WARN("Unable to read physics state from network.");
+			return;
+		}
 
 		ZoneId zoneId;
 		buff.read<ZoneId>(&zoneId);
@@ -1,4 +1,8 @@
+// STD
+#include <fstream>
+
 // Game
+#include <Game/systems/NetworkingSystem.hpp>
 #include <Game/systems/PhysicsSystem.hpp>
 #include <Game/systems/MapSystem.hpp>
 #include <Game/systems/UISystem.hpp>
@@ -156,6 +160,34 @@ namespace {
 			engine.getWorld().getSystem<UISystem>().getTerrainPreview()->generator().setCacheTimeout(current);
 		};
 	}
+
+	template<>
+	ENGINE_INLINE auto makeOnChanged<&CVars::net_sim_half_ping>(Game::EngineInstance& engine, Engine::Window& window) noexcept {
+		return [&](const auto& prev, const auto& current) {
+			engine.getWorld().getSystem<NetworkingSystem>().updateSimSettings();
+		};
+	}
+
+	template<>
+	ENGINE_INLINE auto makeOnChanged<&CVars::net_sim_jitter>(Game::EngineInstance& engine, Engine::Window& window) noexcept {
+		return [&](const auto& prev, const auto& current) {
+			engine.getWorld().getSystem<NetworkingSystem>().updateSimSettings();
+		};
+	}
+
+	template<>
+	ENGINE_INLINE auto makeOnChanged<&CVars::net_sim_duplicate>(Game::EngineInstance& engine, Engine::Window& window) noexcept {
+		return [&](const auto& prev, const auto& current) {
+			engine.getWorld().getSystem<NetworkingSystem>().updateSimSettings();
+		};
+	}
+
+	template<>
+	ENGINE_INLINE auto makeOnChanged<&CVars::net_sim_loss>(Game::EngineInstance& engine, Engine::Window& window) noexcept {
+		return [&](const auto& prev, const auto& current) {
+			engine.getWorld().getSystem<NetworkingSystem>().updateSimSettings();
+		};
+	}
 }
 
 void setupCommands(Game::EngineInstance& engine, Engine::Window& window) {
@@ -166,18 +198,52 @@ void setupCommands(Game::EngineInstance& engine, Engine::Window& window) {
 
 	cm.registerCommand("phys_counts", [&engine](auto&){
 		const auto& physSys = engine.getWorld().getSystem<PhysicsSystem>();
-		const auto& physWorld = physSys.getPhysicsWorld();
 
+		uint64 worldCount = 0;
 		uint64 bodyCount = 0;
 		uint64 fixtureCount = 0;
-		for (auto* body = physWorld.GetBodyList(); body; body=body->GetNext()) {
-			++bodyCount;
-			for (auto* fixture = body->GetFixtureList(); fixture; fixture = fixture->GetNext()) {
-				++fixtureCount;
+		physSys.forEachWorld([&](const b2World& physWorld){
+			++worldCount;
+			for (auto* body = physWorld.GetBodyList(); body; body=body->GetNext()) {
+				++bodyCount;
+				for (auto* fixture = body->GetFixtureList(); fixture; fixture = fixture->GetNext()) {
+					++fixtureCount;
+				}
 			}
+		});
+
+		ENGINE_CONSOLE("Worlds: {}  Bodies: {}  Fixtures: {}", worldCount, bodyCount, fixtureCount);
+	});
+
+	cm.registerCommand("net_train_dict", [&engine](Engine::CommandManager& manager){
+		const auto& args = manager.args();
+		if (args.size() < 2) {
+			ENGINE_CONSOLE("Usage: net_train_dict <capture> [size={}] [output=net.dict]", Engine::Net::PacketCodec::maxDictionarySize);
+			return;
+		}
+
+		int32 size = Engine::Net::PacketCodec::maxDictionarySize;
+		if (args.size() > 2 && !Engine::fromString(args[2], size)) {
+			ENGINE_WARN2("Invalid dictionary size \"{}\"", args[2]);
+			return;
+		}
+
+		const auto& codec = engine.getWorld().getSystem<NetworkingSystem>().getPacketCodec();
+		const auto dict = trainPacketDictionary(args[1], codec, size);
+		if (dict.empty()) {
+			ENGINE_WARN2("Unable to build a packet dictionary from {}", args[1]);
+			return;
+		}
+
+		const auto path = args.size() > 3 ? args[3] : "net.dict";
+		std::ofstream file{path, std::ios::binary};
+		file.write(reinterpret_cast<const char*>(dict.data()), dict.size());
+		if (!file) {
+			ENGINE_WARN2("Unable to write packet dictionary to {}", path);
+			return;
 		}
 
-		ENGINE_CONSOLE("Bodies: {}  Fixtures: {}", bodyCount, fixtureCount);
+		ENGINE_CONSOLE("Wrote {} byte packet dictionary to {}. Restart both ends to use it.", dict.size(), path);
 	});
 
 	cm.registerCommand("zone_view", [&engine](auto&){
@@ -39,24 +39,25 @@ namespace {
 		const auto minTick = recvTick + 1;
 		const auto maxTick = recvTick + actComp.states.capacity() - 1 - 1; // Keep last input so we can duplicate if we need to
 
-		for (auto t = tick + 1 - (actComp.states.capacity() / 4); t <= tick; ++t) {
-			ActionState s = {};
-			s.netRead(msg);
-
-			if (t < minTick || t > maxTick) { continue; }
+		// The client sends a redundant window of its most recent inputs. Any
+		// inputs we missed due to loss are filled in from the window before
+		// we have to fall back to duplicating the previous input in ActionSystem::tick.
+		const auto ok = ActionState::netReadWindow(msg, ActionComponent::maxStates / 2, [&](int32 age, const ActionState& s){
+			const auto t = tick - age;
+			if (t < minTick || t > maxTick) { return; }
 			if (!actComp.states.contains(t)) {
-				if (t != tick) {
-					//ENGINE_INFO("Oh boy. Back filled tick: ", t, " ", tick);
-				} else {
-					//ENGINE_WARN("Oh boy.", t);
-				}
-
-				s.recvTick = recvTick;
-				actComp.states.insert(t) = s;
+				auto& state = actComp.states.insert(t);
+				state = s;
+				state.recvTick = recvTick;
 			}
-		}
+		});
 		msg.readFlushBits();
 
+		if (!ok) {
+			ENGINE_WARN("Invalid action window from ", from.address());
+			return msg.discard();
+		}
+
 		{
 			// TODO: why do we do this? isnt this always `tick - recvTick`?
 			const float32 off = tick < recvTick ? -static_cast<float32>(recvTick - tick) : static_cast<float32>(tick - recvTick);
@@ -253,29 +254,18 @@ namespace Game {
 			ENGINE_DEBUG_ONLY(conn._debug_AllowMessages = true);
 
 			if constexpr (ENGINE_CLIENT) {
-				// Hey! are you wondering why the client sends so much data again?
-				// Well let me save you some time. This code sends about
-				// 12288 bytes per second assuming 64 tick and 64 action history states (sending 1/4 of that).
-				// If we want to do better we need to compress this or send fewer states.
-				// Check trello for more complete explanation. See: O3oJLMde
-
+				// Each message includes a window of our most recent inputs so the
+				// server can fill in any it missed due to loss. Inputs usually don't
+				// change much between ticks so the window is delta and run length
+				// encoded. See ActionState::netWriteWindow. Check trello for more
+				// complete explanation. See: O3oJLMde
 				if (auto msg = conn.beginMessage<MessageType::ACTION>()) {
 					msg.write(currTick);
 
-					// TODO: how many to send?
-					for (auto t = currTick + 1 - (actComp.states.capacity() / 4); t <= currTick; ++t) {
-						const auto& s = actComp.states.get(t);
-						for (auto b : s.buttons) {
-							msg.write<2>(b.pressCount);
-							msg.write<2>(b.releaseCount);
-							msg.write<1>(b.latest);
-						}
-
-						// TODO: compress. we dont need 32 bits here.
-						// TODO: if you compress this make sure to replicate on client to remain in sync
-						msg.write<32>(reinterpret_cast<const uint32&>(s.target.x));
-						msg.write<32>(reinterpret_cast<const uint32&>(s.target.y));
-					}
+					const auto count = static_cast<int32>(Engine::getGlobalConfig().cvars.net_input_redundancy);
+					ActionState::netWriteWindow(msg, count, [&](int32 age) -> const ActionState& {
+						return actComp.states.get(currTick - age);
+					});
 
 					msg.writeFlushBits();
 				}
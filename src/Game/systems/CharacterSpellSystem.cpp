@@ -106,6 +106,7 @@ namespace Game {
 
 		if (event.zoneId != physComp.getZoneId()) {
 			physComp.setZone(event.zoneId);
+			world.getSystem<PhysicsSystem>().updateZoneWorld(physComp);
 		}
 
 		physComp.snap = true;
@@ -1,4 +1,5 @@
 // STD
+#include <algorithm>
 #include <chrono>
 
 // Engine
@@ -178,6 +179,41 @@ namespace {
 		});
 	}
 
+	void recv_ECS_COMP_UPDATE(EngineInstance& engine, ConnectionInfo& from, const MessageHeader head, BufferReader& msg) {
+		Engine::ECS::Entity remote;
+		if (!msg.read(&remote)) { return; }
+
+		Engine::ECS::ComponentId cid;
+		if (!msg.read(&cid)) { return; }
+
+		auto& world = engine.getWorld();
+		auto& entNetSystem = world.getSystem<Game::EntityNetworkingSystem>();
+		auto local = entNetSystem.getEntityMapping(remote);
+
+		if (!local) {
+			ENGINE_WARN("Attempting to update uncreated local entity.");
+			return;
+		}
+
+		if (!world.isAlive(local)) {
+			ENGINE_WARN("Attempting to update dead entitiy ", local);
+			return;
+		}
+
+		if (!world.hasComponent(local, cid)) {
+			ENGINE_WARN(local, " does not have component ", cid);
+			return;
+		}
+
+		world.callWithComponent(cid, [&]<class C>{
+			if constexpr (HasNetworkDelta<C>) {
+				NetworkTraits<C>::readDelta(world.getComponent<C>(local), msg, engine, world, local);
+			} else if constexpr (ENGINE_DEBUG) {
+				ENGINE_WARN("Attemping to update component without delta support");
+			}
+		});
+	}
+
 	void recv_ECS_FLAG(EngineInstance& engine, ConnectionInfo& from, const MessageHeader head, BufferReader& msg) {
 		Engine::ECS::Entity remote;
 		if (!msg.read(&remote)) { return; }
@@ -309,6 +345,7 @@ namespace Game {
 		netSys.setMessageHandler(MessageType::ECS_ENT_DESTROY, recv_ECS_ENT_DESTROY);
 		netSys.setMessageHandler(MessageType::ECS_COMP_ADD, recv_ECS_COMP_ADD);
 		netSys.setMessageHandler(MessageType::ECS_COMP_ALWAYS, recv_ECS_COMP_ALWAYS);
+		netSys.setMessageHandler(MessageType::ECS_COMP_UPDATE, recv_ECS_COMP_UPDATE);
 		netSys.setMessageHandler(MessageType::ECS_FLAG, recv_ECS_FLAG);
 		netSys.setMessageHandler(MessageType::PLAYER_DATA, recv_PLAYER_DATA);
 		netSys.setMessageHandler(MessageType::ECS_ZONE_INFO, recv_ECS_ZONE_INFO);
@@ -328,15 +365,41 @@ namespace Game {
 		// the neighbor of two or more players. We can not move this to
 		// EntityNetworkingSystem::network or we will be breaking that.
 		//
-		// We also must do this every tick or else the neighbors may be
-		// inconsistent with the physics if there is a very fast moving entity
-		// or an entity is teleported.
+		// Neighbors are only updated once per network interval. Players are
+		// spread across the updates in that interval (see
+		// NetworkingSystem::update) so a player may be networked with neighbors
+		// that are up to one interval old. That is fine for position since the
+		// gap between the add and persist ranges is much larger than any entity
+		// moves in an interval. Entities that are destroyed in the meantime are
+		// removed from the neighbors in onComponentRemoved.
+		constexpr auto interval = tickrate / netrate;
+		static_assert(interval > 0);
+		if (world.getTick() % interval != 0) { return; }
+
+		updateInterestGrid();
 		updateNeighbors();
 	}
+
+	void EntityNetworkingSystem::onComponentRemoved(const Engine::ECS::Entity ent, PhysicsBodyComponent& comp) {
+		interestGrid.remove(ent);
+
+		// The neighbors may not be updated again before the next network.
+		// Remove it now so nothing tries to read the components of a dead
+		// entity and the remote is told to destroy it.
+		for (const auto ply : world.getFilter<PlayerFilter>()) {
+			auto& ecsNetComp = world.getComponent<ECSNetworkingComponent>(ply);
+			if (ecsNetComp.neighbors.contains(ent)) {
+				ecsNetComp.neighbors.get(ent).removed();
+			}
+		}
+	}
 	
 	void EntityNetworkingSystem::network(const NetPlySet plys) {
 		static_assert(ENGINE_SERVER, "This code is server side only.");
 
+		sharedStateLookup.clear();
+		sharedStateData.clear();
+
 		for (auto& [ply, netComp] : plys) {
 			auto& ecsNetComp = world.getComponent<ECSNetworkingComponent>(ply);
 			auto& conn = netComp.get();
@@ -373,8 +436,6 @@ namespace Game {
 				msg.write(physComp.getZoneId());
 			}
 
-			// TODO: prioritize entities?
-
 			// Order is important here since some failed writes change neighbor states
 			zoneChanged.clear();
 			for (auto& [ent, data] : ecsNetComp.neighbors) {
@@ -396,6 +457,8 @@ namespace Game {
 				}
 			}
 
+			networkNeighborStates(conn, ply, ecsNetComp);
+
 			if (!zoneChanged.empty() || ecsNetComp.plyZoneChanged) {
 				if (auto msg = conn.beginMessage<MessageType::ECS_ZONE_INFO>()) {
 					const auto& zoneSys = world.getSystem<ZoneManagementSystem>();
@@ -429,9 +492,29 @@ namespace Game {
 		}
 	}
 
+	template<class C>
+	std::span<const byte> EntityNetworkingSystem::getSharedState(const Entity ent, const C& comp) {
+		const auto key = (uint64{ent.id} << 32) | (uint64{ent.gen} << 16) | world.getComponentId<C>();
+		const auto [found, inserted] = sharedStateLookup.try_emplace(key);
+
+		if (inserted) {
+			byte buff[sizeof(Engine::Net::Packet::body)];
+			Engine::Net::StaticBufferWriter writer{buff};
+			NetworkTraits<C>::write(comp, writer, engine, world, ent);
+
+			found->second = {
+				.offset = static_cast<int32>(sharedStateData.size()),
+				.size = static_cast<int32>(writer.size()),
+			};
+			sharedStateData.insert(sharedStateData.end(), writer.begin(), writer.end());
+		}
+
+		return {sharedStateData.data() + found->second.offset, static_cast<uintz>(found->second.size)};
+	}
+
 	template<class C>
 	bool EntityNetworkingSystem::networkComponent(const Entity ent, Connection& conn) const {
-		auto& comp = world.getComponent<C>(ent);
+		const auto& comp = std::as_const(world).getComponent<C>(ent);
 		if (NetworkTraits<C>::getReplType(comp) == Engine::Net::Replication::NONE) { return true; }
 
 		if (auto msg = conn.beginMessage<MessageType::ECS_COMP_ADD>()) {
@@ -445,6 +528,30 @@ namespace Game {
 		return false;
 	}
 
+	template<class C>
+	bool EntityNetworkingSystem::networkComponentUpdate(const Entity ent, Connection& conn, ECSNetworkingComponent::NeighborData& data, int32& bytes) {
+		using Traits = NetworkTraits<C>;
+		using Baseline = typename Traits::Baseline;
+		constexpr auto cid = world.getComponentId<C>();
+
+		// ECS_COMP_UPDATE is reliable and ordered so the client will have applied
+		// every previous update before this one. That makes the last state we
+		// sent a valid baseline without waiting for an ack.
+		return data.updateBaseline(cid, world.getModifiedStamp<C>(ent),
+			[&]{ return Traits::toBaseline(std::as_const(world).getComponent<C>(ent), engine, world, ent); },
+			[&](const Baseline& curr, const Baseline* prev){
+				auto msg = conn.beginMessage<MessageType::ECS_COMP_UPDATE>();
+				if (!msg) { return false; } // Try again next network.
+
+				msg.write(ent);
+				msg.write(cid);
+				Traits::writeDelta(curr, prev, msg.getBufferWriter());
+				bytes += static_cast<int32>(msg.getBufferWriter().size());
+				return true;
+			}
+		);
+	}
+
 	void EntityNetworkingSystem::processAddedNeighbor(Connection& conn, const Engine::ECS::Entity ent, ECSNetworkingComponent::NeighborData& data) {
 		if (auto msg = conn.beginMessage<MessageType::ECS_ENT_CREATE>()) {
 			data.reset(NeighborState::Current);
@@ -475,7 +582,7 @@ namespace Game {
 			if constexpr (IsNetworkedComponent<C>) {
 				if (!world.hasComponent<C>(ent)) { return; }
 
-				const auto& comp = world.getComponent<C>(ent);
+				const auto& comp = std::as_const(world).getComponent<C>(ent);
 				const auto repl = NetworkTraits<C>::getReplType(comp);
 				if (repl == Engine::Net::Replication::NONE) { return; }
 
@@ -483,24 +590,20 @@ namespace Game {
 				if (diff < 0) { // Component Added
 					if (networkComponent<C>(ent, conn)) {
 						data.comps.set(cid);
+
+						// The initial state is our first baseline.
+						if constexpr (HasNetworkDelta<C>) {
+							if (repl == Engine::Net::Replication::UPDATE) {
+								auto& base = data.addBaseline(cid);
+								base.stamp = world.getModifiedStamp<C>(ent);
+								base.store(NetworkTraits<C>::toBaseline(comp, engine, world, ent));
+							}
+						}
 					} else {
 						ENGINE_WARN("Unable network component add. UPDATE");
 					}
 				} else if (diff > 0) { // Component Removed
 					// TODO: comp removed
-				} else if (repl == Engine::Net::Replication::ALWAYS) {
-					if (auto msg = conn.beginMessage<MessageType::ECS_COMP_ALWAYS>()) {
-						msg.write(ent);
-						msg.write(cid);
-						if (Engine::ECS::IsSnapshotRelevant<C>) {
-							msg.write(world.getTick());
-						}
-
-						NetworkTraits<C>::write(comp, msg.getBufferWriter(), engine, world, ent);
-					}
-				} else if (repl == Engine::Net::Replication::UPDATE) {
-					ENGINE_DEBUG_ASSERT("TODO: Update replication is not yet implemented");
-					// TODO: impl
 				}
 			}
 		});
@@ -524,13 +627,121 @@ namespace Game {
 		}
 	}
 	
-	void EntityNetworkingSystem::updateNeighbors() {
-		auto& physSys = world.getSystem<PhysicsSystem>();
-		auto& physWorld = physSys.getPhysicsWorld();
+	bool EntityNetworkingSystem::processNeighborState(Connection& conn, const Engine::ECS::Entity ent, ECSNetworkingComponent::NeighborData& data, int32& bytes) {
+		bool complete = true;
 
+		Engine::Meta::ForEachIn<CompsSet>::call([&]<class C>{
+			constexpr auto cid = world.getComponentId<C>();
+			if constexpr (IsNetworkedComponent<C>) {
+				// Components that haven't been added on the remote yet are handled by processCurrentNeighbor.
+				if (!data.comps.test(cid) || !world.hasComponent<C>(ent)) { return; }
+
+				const auto& comp = std::as_const(world).getComponent<C>(ent);
+				const auto repl = NetworkTraits<C>::getReplType(comp);
+
+				if (repl == Engine::Net::Replication::ALWAYS) {
+					if (auto msg = conn.beginMessage<MessageType::ECS_COMP_ALWAYS>()) {
+						msg.write(ent);
+						msg.write(cid);
+						if (Engine::ECS::IsSnapshotRelevant<C>) {
+							msg.write(world.getTick());
+						}
+
+						if (const auto state = getSharedState(ent, comp); !state.empty()) {
+							msg.write(state.data(), state.size());
+						}
+
+						bytes += static_cast<int32>(msg.getBufferWriter().size());
+					} else {
+						complete = false;
+					}
+				} else if (repl == Engine::Net::Replication::UPDATE) {
+					if constexpr (HasNetworkDelta<C>) {
+						static_assert(!Engine::ECS::IsSnapshotRelevant<C>, "Update replication of snapshot components is not supported. Use Replication::ALWAYS.");
+						complete = networkComponentUpdate<C>(ent, conn, data, bytes) && complete;
+					} else {
+						ENGINE_DEBUG_ASSERT(false, "Update replication requires NetworkTraits delta support. See HasNetworkDelta.");
+					}
+				}
+			}
+		});
+
+		return complete;
+	}
+
+	void EntityNetworkingSystem::networkNeighborStates(Connection& conn, const Engine::ECS::Entity ply, ECSNetworkingComponent& ecsNetComp) {
+		const auto& cvars = Engine::getGlobalConfig().cvars;
+
+		// The bytes available for this network update. Anything over budget
+		// would just sit in the reliable queue and delay everything behind it.
+		const auto budget = static_cast<int32>(
+			conn.getPacketSendRate() * sizeof(Engine::Net::Packet::body) / netrate * cvars.net_entity_budget / 100
+		);
+
+		// Entities that haven't been sent in this many updates are sent regardless of the budget.
+		const auto maxSkipped = std::max(1, static_cast<int32>(netrate / cvars.net_entity_min_rate));
+
+		const auto plyPos = world.getComponent<PhysicsBodyComponent>(ply).getPosition();
+		priorities.clear();
+
+		for (auto& [ent, data] : ecsNetComp.neighbors) {
+			if (!data.test(NeighborState::Current)) { continue; }
+
+			// The entity may have been destroyed or lost its body since neighbors
+			// were last updated. Treat it the same as leaving range so the remote
+			// gets an ECS_ENT_DESTROY on the next network.
+			if (!world.isAlive(ent) || !world.hasComponent<PhysicsBodyComponent>(ent)) {
+				data.removed();
+				continue;
+			}
+
+			// Closer entities accumulate priority faster. Everything within the
+			// add range has the same relevance.
+			const auto dist = (world.getComponent<PhysicsBodyComponent>(ent).getPosition() - plyPos).Length();
+			data.priority += neighborRangeAdd / std::max(dist, neighborRangeAdd);
+			++data.updatesSkipped;
+
+			priorities.push_back({
+				.ent = ent,
+				.priority = data.priority,
+				.forced = data.updatesSkipped >= maxSkipped,
+			});
+		}
+
+		std::ranges::sort(priorities, [](const PriorityEntry& a, const PriorityEntry& b){
+			if (a.forced != b.forced) { return a.forced; }
+			return a.priority > b.priority;
+		});
+
+		int32 used = 0;
+		for (const auto& entry : priorities) {
+			if (used >= budget && !entry.forced) { break; }
+
+			// Only reset once the state has actually been sent. If the send queue is
+			// full this and the remaining entities keep their priority for next time.
+			auto& data = ecsNetComp.neighbors.get(entry.ent);
+			if (!processNeighborState(conn, entry.ent, data, used)) { break; }
+			data.priority = 0;
+			data.updatesSkipped = 0;
+		}
+	}
+
+	void EntityNetworkingSystem::updateInterestGrid() {
+		// Entities that haven't crossed a cell boundary only update their
+		// stored position. Removals are handled in onComponentRemoved.
+		for (const auto ent : world.getFilter<NetworkedFlag, PhysicsBodyComponent>()) {
+			const auto& physComp = world.getComponent<PhysicsBodyComponent>(ent);
+			const auto& pos = physComp.getPosition();
+			interestGrid.update(ent, physComp.getZoneId(), {pos.x, pos.y});
+		}
+	}
+
+	void EntityNetworkingSystem::updateNeighbors() {
 		for (const auto ply : world.getFilter<PlayerFilter>()) {
 			auto& ecsNetComp = world.getComponent<ECSNetworkingComponent>(ply);
 			const auto& physComp = world.getComponent<PhysicsBodyComponent>(ply);
+			const auto zoneId = physComp.getZoneId();
+			const auto& pos = physComp.getPosition();
 
 			// Flag everything as might be removed. Current and added neighbors
 			// will get overwritten in the persist and add queries.
@@ -538,63 +749,20 @@ namespace Game {
 				data.maybeRemoved();
 			}
 
-			// Create a b2 query object the filters entities to only those relevant the the player.
-			const auto createQuery = []<class Func>(ZoneId plyZoneId, World& world, Func&& func){
-				struct ZoneQuery : b2QueryCallback {
-					Func func;
-					ZoneId plyZoneId = 0;
-					World& world;
-
-					ZoneQuery(ZoneId plyZoneId, World& world, Func&& func)
-						: func{std::move(func)}, plyZoneId{plyZoneId}, world{world} {
-					}
-
-					virtual bool ReportFixture(b2Fixture* fixture) override {
-						const Entity ent = Game::PhysicsSystem::toEntity(fixture);
-						if (world.hasComponent<NetworkedFlag>(ent)) {
-							const auto& entPhysComp = world.getComponent<PhysicsBodyComponent>(ent);
-							if (entPhysComp.getZoneId() == plyZoneId) {
-								func(*this, ent);
-							}
-						}
-						return true;
-					}
-				} query{plyZoneId, world, std::move(func)};
-				return query;
-			};
-
 			// Persist any items that are already neighbors in a larger area to
 			// avoid rapid add/remove near edge/border if the player is moving
 			// around in the same small area a lot.
-			auto queryPersist = createQuery(physComp.getZoneId(), world,
-				[&ecsNetComp](const auto& self, Entity ent){
-					if (ecsNetComp.neighbors.contains(ent)) {
-						auto& data = ecsNetComp.neighbors.get(ent);
-						data.current();
-					}
+			interestGrid.query(zoneId, {pos.x, pos.y}, neighborRangePersist, [&](Entity ent){
+				if (ecsNetComp.neighbors.contains(ent)) {
+					ecsNetComp.neighbors.get(ent).current();
 				}
-			);
+			});
 
 			// Only add new items in a smaller radius.
-			auto queryAdd = createQuery(physComp.getZoneId(), world,
-				[ply, &ecsNetComp](const auto& self, Entity ent){
-					if (!ecsNetComp.neighbors.contains(ent) && ent != ply) {
-						ecsNetComp.neighbors.add(ent, NeighborState::Added);
-					}
+			interestGrid.query(zoneId, {pos.x, pos.y}, neighborRangeAdd, [&](Entity ent){
+				if (!ecsNetComp.neighbors.contains(ent) && ent != ply) {
+					ecsNetComp.neighbors.add(ent, NeighborState::Added);
 				}
-			);
-
-			// TODO: maybe these should be cvars?
-			const auto& pos = physComp.getPosition();
-
-			physWorld.QueryAABB(&queryPersist, b2AABB{
-				{pos.x - neighborRangePersist, pos.y - neighborRangePersist},
-				{pos.x + neighborRangePersist, pos.y + neighborRangePersist},
-			});
-
-			physWorld.QueryAABB(&queryAdd, b2AABB{
-				{pos.x - neighborRangeAdd, pos.y - neighborRangeAdd},
-				{pos.x + neighborRangeAdd, pos.y + neighborRangeAdd},
 			});
 
 			// Mark anything was wasn't persisted or added for removal.
@@ -264,29 +264,18 @@ namespace Game {
 		// player edits will have not been applied yet. It could theoretically also be done at the
 		// end of a tick, which would then be applied next tick, but we introduced a restriction
 		// that all edits must be applied on the tick where they are made.
-		checkBlockConnectivity();
-
 		{
-			// Include a percentage factor so we never fall to far behind if a lot of breaking is happening.
-			constexpr static uint32 crumblesPerSec = 20*64;
-			constexpr static auto crumblesPerTick = crumblesPerSec / tickrate;
-			auto crumbles = std::max(crumblesPerTick, static_cast<uint32>(crumbleBlocks.size() * 0.1));
-
-			if (ENGINE_DEBUG && (crumbles > crumblesPerTick)) {
-				ENGINE_LOG2("Terrain crumbling catchup: {}", crumbles - crumblesPerTick);
+			const auto& zoneSys = world.getSystem<ZoneManagementSystem>();
+			crumblePlayers.clear();
+			for (auto& ply : world.getFilter<PlayerFilter>()) {
+				const auto& physComp = world.getComponent<PhysicsBodyComponent>(ply);
+				const auto& zone = zoneSys.getZone(physComp.getZoneId());
+				const auto plyPos = Engine::Glue::as<glm::vec2>(physComp.getPosition());
+				crumblePlayers.push_back({zone.realmId, worldToBlock(plyPos, zone.offset)});
 			}
 
-			while (crumbles && !crumbleBlocks.empty()) {
-				const auto blockCoord = crumbleBlocks.front();
-				crumbleBlocks.pop();
-				crumbleBlocksCheck.erase(blockCoord);
-
-				// We need to check if the block was actually cleared because the block could have
-				// been manually removed before it crumbled.
-				if (setValueAt(blockCoord, BlockId::Air)) {
-					--crumbles;
-				}
-			}
+			scheduleBlockConnectivity();
+			scheduleCrumble();
 		}
 
 		for (auto& ply : world.getFilter<PlayerFilter>()) {
@@ -523,7 +512,7 @@ namespace Game {
 				}
 
 				zoneSys.removeRef(it->second.body.getZoneId());
-				world.getSystem<PhysicsSystem>().destroyBody(it->second.body);
+				deactivateChunk(it->first, std::move(it->second));
 				it = activeChunks.erase(it);
 			} else {
 				++it;
@@ -532,24 +521,36 @@ namespace Game {
 		
 		// Unload regions.
 		{
-			// It is safe to cache end here since end is not invalidated by erase.
-			const auto end = regionLastUsed.end();
-			for (auto it = regionLastUsed.begin(); it != end;) {
-				// TODO: Before this update we also checked if the region was loading. Is
-				//       this nessesary? This would only be an issue if the region takes
-				//       longer to load than the timeout I think? It is probably safe to
-				//       remove. If this turns into an issue the simpler solution would be
-				//       to update the regionLastUsed instead of introducing a region wide
-				//       loading flag to track.
-				//       if (it->second->lastUsed < timeout && !it->second->loading()) {
-				if (it->second < timeout) {
-					ENGINE_LOG2("Unloading region: {} {} ", it->first.realmId, it->first.pos);
-					terrain.eraseRegion(it->first);
-					it = regionLastUsed.erase(it);
-				} else {
-					++it;
+			// TODO: Before this update we also checked if the region was loading. Is
+			//       this nessesary? This would only be an issue if the region takes
+			//       longer to load than the timeout I think? It is probably safe to
+			//       remove. If this turns into an issue the simpler solution would be
+			//       to touch the region in regionResidency instead of introducing a region wide
+			//       loading flag to track.
+
+			// Active chunks can outlive the region timeout, especially when over budget, and need their
+			// region loaded to store their block entities when unloaded. Keep those regions in use.
+			// Cached inactive chunks don't need this since they are validated when reactivated.
+			const auto now = world.getTickTime();
+			for (const auto& [chunkPos, activeData] : activeChunks) {
+				const auto regionCoord = chunkPos.toRegion();
+				if (terrain.isRegionLoaded(regionCoord)) {
+					regionResidency.touch(regionCoord, now);
 				}
 			}
+
+			const auto& cvars = Engine::getGlobalConfig().cvars;
+			const Terrain::RegionResidency::Config config = {
+				.timeout = cvars.tn_region_unload_timeout,
+				.minTimeout = std::min<Engine::Clock::Duration>(std::chrono::seconds{1}, cvars.tn_region_unload_timeout),
+				.maxUnloads = cvars.tn_region_unload_rate,
+				.budget = static_cast<uint32>(uint64{cvars.tn_region_budget} * 1024 * 1024 / sizeof(Terrain::Region)),
+			};
+
+			regionResidency.update(now, config, [&](const UniversalRegionCoord regionCoord){
+				ENGINE_LOG2("Unloading region: {} {} ", regionCoord.realmId, regionCoord.pos);
+				terrain.eraseRegion(regionCoord);
+			});
 		}
 	}
 
@@ -558,6 +559,7 @@ namespace Game {
 
 		const auto terrainLock = terrain.lock(); // TODO: reevaluate/narrow scope if possible.
 		const auto tick = world.getTick();
+		freshChunkRLELookup.clear();
 
 		// Send chunk updates to clients.
 		for (const auto& [ent, netComp] : plys) {
@@ -594,10 +596,15 @@ namespace Game {
 					// TODO (4E5R8u55): This isn't correct. Zero can be a valid tick if they wrap.
 					if (meta.last == 0) { // Fresh chunk
 						if (terrain.isChunkLoaded(chunkPos)) {
-							const auto& chunk = terrain.getChunk(chunkPos);
-							rleTemp.clear();
-							chunk.toRLE(rleTemp);
-							rle = &rleTemp;
+							const auto [cached, inserted] = freshChunkRLELookup.try_emplace(chunkPos, static_cast<int32>(freshChunkRLELookup.size()));
+							if (cached->second >= std::ssize(freshChunkRLE)) {
+								freshChunkRLE.emplace_back();
+							}
+
+							rle = &freshChunkRLE[cached->second];
+							if (inserted) {
+								terrain.getChunk(chunkPos).toRLE(*rle);
+							}
 							//ENGINE_INFO2("Send chunk (fresh): {} {}", tick, chunkPos);
 						}
 					} else if (activeData.rle.empty()) {
@@ -632,7 +639,7 @@ namespace Game {
 						msg.write(rle->data(), rle->size() * sizeof(rle->front()));
 					} else {
 						// This warning gets hit quite a bit depending on the clients
-						// network recv rate and MAX_BLOBS. So its annoying to leave enabled because
+						// network recv rate and Channel_Map_Blob's maxBlobs. So its annoying to leave enabled because
 						// it clutters the logs.
 						// 
 						//ENGINE_WARN2("Unable to begin MAP_CHUNK message.");
@@ -652,6 +659,7 @@ namespace Game {
 		// TODO: Double chekc all are still used after transition to new terrain.
 		const auto tick = world.getTick();
 		auto& zoneSys = world.getSystem<ZoneManagementSystem>();
+		auto& physSys = world.getSystem<PhysicsSystem>();
 		const auto& physComp = world.getComponent<PhysicsBodyComponent>(ply);
 		const auto plyPos = Engine::Glue::as<glm::vec2>(physComp.getPosition());
 		const auto plyZoneId = physComp.getZoneId();
@@ -699,10 +707,6 @@ namespace Game {
 					continue;
 				}
 
-				// Update region usage.
-				const auto regionCoord = chunkPos.toRegion();
-				regionLastUsed[regionCoord] = world.getTickTime();
-
 				#if ENGINE_SERVER
 				{
 					// TODO: Do we really care if its already tracked? Shouldn't
@@ -724,9 +728,13 @@ namespace Game {
 				if (activeChunkIt == activeChunks.end()) {
 					if (isBufferChunk) { continue; }
 
-					// TODO (QmIupKgJ): we really should probably have a cache of inactive chunks that we can reuse instead of constant destroy/create.
+					// Reuse a recently deactivated chunk if possible to avoid rebuilding the render and physics data.
 					zoneSys.addRef(plyZoneId);
-					activeChunkIt = activeChunks.try_emplace(chunkPos, createBody(plyZoneId)).first;
+					activeChunkIt = reactivateChunk(chunkPos, plyZoneId, plyZone.offset);
+					const bool reused = activeChunkIt != activeChunks.end();
+					if (!reused) {
+						activeChunkIt = activeChunks.try_emplace(chunkPos, createBody(plyZoneId)).first;
+					}
 					ENGINE_DEBUG_ASSERT(activeChunkIt->second.body.valid());
 					//ENGINE_INFO2("Make active {}, {}", chunkPos, plyZoneId);
 
@@ -751,7 +759,9 @@ namespace Game {
 					}
 
 					//ENGINE_LOG2("Activating chunk: {} ({})", chunkPos, (activeChunkIt->second.updated == tick) ? "fresh" : "stale");
-					activeChunkIt->second.updated = tick;
+					if (!reused) {
+						activeChunkIt->second.updated = tick;
+					}
 				} else if (!isBufferChunk) {
 					// Only move the non-buffer chunks to avoid any stutter when moving
 					// between zones. The buffer chunks will be moved later if the player
@@ -779,6 +789,7 @@ namespace Game {
 						const auto pos = blockToWorld(chunkToBlock(chunkPos.pos), plyZone.offset);
 						body.setPosition({pos.x, pos.y});
 						body.setZone(plyZoneId);
+						physSys.updateZoneWorld(body);
 
 						// Client side this is handled through the entity networking system.
 						if constexpr (ENGINE_SERVER) {
@@ -789,6 +800,7 @@ namespace Game {
 								if (entPhysComp.getZoneId() != plyZoneId) {
 									const auto oldZoneOffset = zoneSys.getZone(entPhysComp.getZoneId()).offset;
 									entPhysComp.moveZone(oldZoneOffset, plyZoneId, plyZone.offset);
+									physSys.updateZoneWorld(entPhysComp);
 								}
 							}
 						}
@@ -800,6 +812,24 @@ namespace Game {
 			}
 		}
 
+		// Update region usage. Regions are kept for some distance beyond the buffer area so
+		// that moving back and forth near a region edge doesn't cause repeated load/unload.
+		{
+			const auto keepChunks = static_cast<ChunkUnit>(Engine::getGlobalConfig().cvars.tn_region_keep_distance);
+			const auto now = world.getTickTime();
+			const UniversalChunkArea keepArea = {
+				.realmId = plyZone.realmId,
+				.min = minBuffChunk - keepChunks,
+				.max = maxBuffChunk + keepChunks + ChunkUnit{1},
+			};
+
+			keepArea.toRegionArea().forEach([&](const UniversalRegionCoord regionCoord) ENGINE_INLINE {
+				if (terrain.isRegionLoaded(regionCoord)) {
+					regionResidency.touch(regionCoord, now);
+				}
+			});
+		}
+
 		#if ENGINE_SERVER
 		if (reqGen) {
 			queueGeneration({
@@ -832,27 +862,9 @@ namespace Game {
 			}
 		}
 
-		ENGINE_DEBUG_ASSERT(bcGroupSizes.empty(), "Expected empty block connectivity groups.");
-		ENGINE_DEBUG_ASSERT(bcLookup.empty(), "Expected empty block connectivity lookup.");
-		ENGINE_DEBUG_ASSERT(bcQueue.empty(), "Expected empty block connectivity queue.");
-
-		const auto queue = [&](const UniversalBlockCoord blockCoord) ENGINE_INLINE_REL {
-			// Configure block connectivity.
-			if (!bcLookup.contains(blockCoord)) {
-				bcQueue.push_back(blockCoord);
-				bcLookup[blockCoord].id = bcGroupSizes.size();
-				bcGroupSizes.push_back(1);
-			}
-		};
-			
 		// This appears to be the fastest way to draw a circle based on: https://stackoverflow.com/a/59211338
 		// Have _not_ done first hand benchmarks with terrain/edit integration.
-		//
-		// Drawing the circle in two monotonically increasing halfs makes edge detection easy since
-		// we can use the previous columns min/maxY to check for edges.
-		const auto drawHalf = [&](const auto& initial, const auto& condition, const auto& expression, const auto& offset) ENGINE_INLINE_REL {
-			auto prevMaxY = std::numeric_limits<BlockUnit>::min();
-			auto prevMinY = std::numeric_limits<BlockUnit>::max();
+		const auto drawHalf = [&](const auto& initial, const auto& condition, const auto& expression) ENGINE_INLINE_REL {
 			for (auto x = initial; condition(x, 0); x = expression(x, 1)) {
 				static_assert(std::is_integral_v<decltype(x)>);
 				static_assert(std::is_integral_v<decltype(radius)>);
@@ -865,47 +877,158 @@ namespace Game {
 				const auto minY = targetBlockPos.y - halfHeight;
 				const auto maxY = targetBlockPos.y + halfHeight;
 				for (auto pointY = minY; pointY <= maxY; ++pointY) {
-					// Only check block connectivity if a change will be made.
-					if (!setValueAt({zone.realmId, {pointX, pointY}}, bid)) { continue; }
+					editBuffer.push_back({.blockCoord = {zone.realmId, {pointX, pointY}}, .bid = bid});
+				}
+			}
+		};
 
-					// Only check block connectivity if we are removing blocks.
-					if (bid != BlockId::Air) { continue; }
+		drawHalf(-radius, std::less_equal{}, std::plus{}); // Left half.
+		drawHalf(radius, std::greater{}, std::minus{}); // Right half.
 
-					// Diagonals shouldn't be needed since fixing a number crumble block
-					// connectivity bugs. Keeping for reference and debugging in the future since
-					// this code isn't the easiest to wrap your head around.
+		applyEdits(editBuffer);
+		editBuffer.clear();
+	}
 
-					// Check for block connectivity around the edges of the circle.
-					if ((pointY > prevMaxY) || (pointY < prevMinY)) {
-						// Fill vertical edges. Left/Right.
-						queue({.realmId = zone.realmId, .pos = {offset(pointX, 1), pointY}});
-					}
-					
-					if (pointY == maxY) {
-						// Fill horizontal edge. Top.
-						queue({.realmId = zone.realmId, .pos = {pointX, pointY + 1}});
-						
-						// Fill in diagonals.
-						//queue({.realmId = zone.realmId, .pos = {offset(pointX, 1), pointY + 1}});
-					} else if (pointY == minY) {
-						// Fill horizontal edge. Bottom.
-						queue({.realmId = zone.realmId, .pos = {pointX, pointY - 1}});
-
-						// Fill in diagonals.
-						//queue({.realmId = zone.realmId, .pos = {offset(pointX, 1), pointY - 1}});
-					}
-				}
+	int32 MapSystem::applyEdits(std::span<const BlockEdit> edits) {
+		ENGINE_DEBUG_ASSERT(pendingEdits.empty(), "Unexpected pending edits.");
+
+		for (const auto& edit : edits) {
+			const auto chunkCoord = edit.blockCoord.toChunk();
+			pendingEdits.push_back({
+				.blockCoord = edit.blockCoord,
+				.chunkCoord = chunkCoord,
+				.chunkIndex = edit.blockCoord.toChunkIndex(chunkCoord),
+				.bid = edit.bid,
+			});
+		}
+
+		// Stable so that the order of edits within a chunk is preserved.
+		std::ranges::stable_sort(pendingEdits, {}, [](const PendingEdit& edit) ENGINE_INLINE {
+			return std::tuple{edit.chunkCoord.realmId, edit.chunkCoord.pos.x, edit.chunkCoord.pos.y};
+		});
+
+		int32 changed = 0;
+		const auto end = pendingEdits.cend();
+		for (auto first = pendingEdits.cbegin(); first != end;) {
+			const auto chunkCoord = first->chunkCoord;
+			const auto last = std::find_if(first, end, [&](const PendingEdit& edit){ return edit.chunkCoord != chunkCoord; });
+			changed += applyChunkEdits(chunkCoord, {first, last}, true);
+			first = last;
+		}
+
+		pendingEdits.clear();
+		return changed;
+	}
+
+	void MapSystem::queueConnectivity(const UniversalBlockCoord blockCoord) {
+		if (bcPendingCheck.insert(blockCoord).second) {
+			bcPending.push_back({.priority = 0, .blockCoord = blockCoord});
+		}
+	}
+
+	int64 MapSystem::getCrumblePriority(const UniversalBlockCoord blockCoord) const noexcept {
+		auto best = std::numeric_limits<int64>::max();
+		for (const auto& ply : crumblePlayers) {
+			if (ply.realmId != blockCoord.realmId) { continue; }
+			const auto diff = blockCoord.pos - ply.pos;
+			best = std::min(best, diff.x * diff.x + diff.y * diff.y);
+		}
+		return best;
+	}
+
+	void MapSystem::scheduleBlockConnectivity() {
+		// Checks are done in small batches since each batch has overhead proportional to the number of
+		// groups being merged. This also keeps the budget overshoot small.
+		constexpr static uintz batchSize = 64;
+		const uintz budget = Engine::getGlobalConfig().cvars.tn_crumble_search_budget;
+
+		if (bcPending.empty()) { return; }
+
+		// Players move so priorities have to be updated each tick, but only the seeds within the budget
+		// need to be ordered. Heapify and pop the nearest as needed instead of sorting everything.
+		for (auto& seed : bcPending) {
+			seed.priority = getCrumblePriority(seed.blockCoord);
+		}
+		std::ranges::make_heap(bcPending, std::ranges::greater{}, &ConnectivitySeed::priority);
 
-				prevMaxY = maxY;
-				prevMinY = minY;
+		uintz visited = 0;
+		while (!bcPending.empty() && visited < budget) {
+			ENGINE_DEBUG_ASSERT(bcGroupSizes.empty(), "Expected empty block connectivity groups.");
+			ENGINE_DEBUG_ASSERT(bcLookup.empty(), "Expected empty block connectivity lookup.");
+			ENGINE_DEBUG_ASSERT(bcQueue.empty(), "Expected empty block connectivity queue.");
+
+			for (uintz i = 0; i < batchSize && !bcPending.empty(); ++i) {
+				std::ranges::pop_heap(bcPending, std::ranges::greater{}, &ConnectivitySeed::priority);
+				const auto blockCoord = bcPending.back().blockCoord;
+				bcPending.pop_back();
+				bcPendingCheck.erase(blockCoord);
+
+				// The area may have been unloaded while waiting.
+				if (!terrain.isChunkLoaded(blockCoord.toChunk())) { continue; }
+
+				bcQueue.push_back(blockCoord);
+				bcLookup[blockCoord].id = bcGroupSizes.size();
+				bcGroupSizes.push_back(1);
 			}
-		};
 
-		drawHalf(-radius, std::less_equal{}, std::plus{}, std::minus{}); // Left half.
-		drawHalf(radius, std::greater{}, std::minus{}, std::plus{}); // Right half.
+			visited += checkBlockConnectivity();
+		}
+	}
+
+	void MapSystem::scheduleCrumble() {
+		const auto& cvars = Engine::getGlobalConfig().cvars;
+		const uint32 crumblesPerTick = std::max(1u, cvars.tn_crumble_rate / tickrate);
+
+		// Include a percentage factor so we never fall to far behind if a lot of breaking is happening.
+		auto crumbles = std::max(crumblesPerTick, static_cast<uint32>(crumbleBlocksPending * 0.1));
+		crumbles = std::min(crumbles, std::max(crumblesPerTick, cvars.tn_crumble_max_per_tick));
+
+		if (ENGINE_DEBUG && (crumbles > crumblesPerTick)) {
+			ENGINE_LOG2("Terrain crumbling catchup: {} ({} pending)", crumbles - crumblesPerTick, crumbleBlocksPending);
+		}
+
+		if (crumbleGroups.empty()) { return; }
+
+		// Crumble the groups nearest to players first. Groups are crumbled in visit order for visual effect.
+		for (auto& group : crumbleGroups) {
+			group.priority = getCrumblePriority(group.blocks[group.next]);
+		}
+		std::ranges::sort(crumbleGroups, {}, &CrumbleGroup::priority);
+
+		for (auto& group : crumbleGroups) {
+			while (crumbles && group.next < group.blocks.size()) {
+				const auto blockCoord = group.blocks[group.next];
+				++group.next;
+				--crumbleBlocksPending;
+				crumbleBlocksCheck.erase(blockCoord);
+
+				// The area may have been unloaded while waiting.
+				if (!terrain.isChunkLoaded(blockCoord.toChunk())) { continue; }
+
+				// We need to check if the block was actually cleared because the block could have
+				// been manually removed before it crumbled.
+				if (setValueAt(blockCoord, BlockId::Air)) {
+					--crumbles;
+				}
+			}
+
+			if (!crumbles) { break; }
+		}
+
+		std::erase_if(crumbleGroups, [](const CrumbleGroup& group){ return group.next == group.blocks.size(); });
+	}
+
+	auto MapSystem::getCrumbleStats() const noexcept -> CrumbleStats {
+		const auto rate = Engine::getGlobalConfig().cvars.tn_crumble_rate;
+		return {
+			.pendingSearches = static_cast<uint32>(bcPending.size()),
+			.pendingGroups = static_cast<uint32>(crumbleGroups.size()),
+			.pendingBlocks = crumbleBlocksPending,
+			.secondsBehind = static_cast<float32>(crumbleBlocksPending) / rate,
+		};
 	}
 	
-	void MapSystem::checkBlockConnectivity() {
+	uintz MapSystem::checkBlockConnectivity() {
 		//
 		//
 		//
@@ -1054,7 +1177,7 @@ namespace Game {
 
 			if (bcGroupSizes[group.id] <= crumbleThreshold) {
 				if (!crumbleBlocksCheck.contains(blockCoord)) {
-					crumbleBlockSorting.push_back({.visitOrder = group.visitOrder, .blockCoord = blockCoord});
+					crumbleBlockSorting.push_back({.groupId = group.id, .visitOrder = group.visitOrder, .blockCoord = blockCoord});
 				}
 			}
 
@@ -1067,77 +1190,141 @@ namespace Game {
 			}
 		}
 
-		// Maintain visit order for visual effect.
-		std::ranges::sort(crumbleBlockSorting, {}, &CrumbleBlock::visitOrder);
+		// Maintain visit order within each group for visual effect.
+		std::ranges::sort(crumbleBlockSorting, [](const CrumbleBlock& a, const CrumbleBlock& b) ENGINE_INLINE {
+			return std::tie(a.groupId, a.visitOrder) < std::tie(b.groupId, b.visitOrder);
+		});
 
-		// Append crumble blocks.
-		for (const auto& [_, blockCoord] : crumbleBlockSorting) {
-			crumbleBlocks.push(blockCoord);
+		// Append crumble groups.
+		for (intz lastGroupId = bcInvalidGroup; const auto& [groupId, _, blockCoord] : crumbleBlockSorting) {
+			if (groupId != lastGroupId) {
+				crumbleGroups.emplace_back();
+				lastGroupId = groupId;
+			}
+
+			crumbleGroups.back().blocks.push_back(blockCoord);
 			crumbleBlocksCheck.insert(blockCoord);
 		}
+		crumbleBlocksPending += static_cast<uint32>(crumbleBlockSorting.size());
 
 		// Clear temporary buffers.
+		const auto visited = bcQueue.size();
 		bcGroupSizes.clear();
 		bcLookup.clear();
 		bcQueue.clear();
 		crumbleBlockSorting.clear();
+		return visited;
 	}
 
 	bool MapSystem::setValueAt(const UniversalBlockCoord blockCoord, BlockId bid) {
 		const auto chunkCoord = blockCoord.toChunk();
-		const auto chunkIndex = blockCoord.toChunkIndex(chunkCoord);
+		const PendingEdit edit = {
+			.blockCoord = blockCoord,
+			.chunkCoord = chunkCoord,
+			.chunkIndex = blockCoord.toChunkIndex(chunkCoord),
+			.bid = bid,
+		};
+
+		return applyChunkEdits(chunkCoord, {&edit, 1}, false) != 0;
+	}
+
+	int32 MapSystem::applyChunkEdits(const UniversalChunkCoord chunkCoord, std::span<const PendingEdit> edits, bool checkConnectivity) {
+		int32 changed = 0;
+
+		const auto onChange = [&](const PendingEdit& edit) ENGINE_INLINE_REL {
+			++changed;
+
+			// Only check block connectivity if we are removing blocks.
+			if (!checkConnectivity || edit.bid != BlockId::Air) { return; }
+
+			// Neighbors that are also removed are skipped by checkBlockConnectivity.
+			queueConnectivity(edit.blockCoord + BlockVec{-1, 0});
+			queueConnectivity(edit.blockCoord + BlockVec{+1, 0});
+			queueConnectivity(edit.blockCoord + BlockVec{0, +1});
+			queueConnectivity(edit.blockCoord + BlockVec{0, -1});
+		};
 
 		#if ENGINE_CLIENT
 			auto found = activeChunks.find(chunkCoord);
 			if (found == activeChunks.end()) [[unlikely]] {
 				ENGINE_WARN2("Attempting to edit an unloaded chunk: {}", chunkCoord);
+				return 0;
 			}
 
-			auto& edits = found->second.edits;
+			const auto tick = world.getTick();
+			auto& chunkEdits = found->second.edits;
 			auto const& chunk = terrain.getChunk(chunkCoord);
-			auto const& inChunk = chunk.data[chunkIndex.x][chunkIndex.y] == bid;
-
-			// This could be greatly simplified if we didn't care about inserting empty edits, but we do
-			// care since the number of edits has significant performance implications during a mis-prediction.
-			if (inChunk) {
-				if (!edits.empty() && edits.back().tick == world.getTick()) {
-					// Remove from edit if it has already been inserted by another edit. This could
-					// theoretically happen if there are three edits in one tick: BlockA > BlockB >
-					// BlockA.
-					if (edits.back().chunk.data[chunkIndex.x][chunkIndex.y] != BlockId::None) {
-						// TODO: We could also use chunksUpdatedFromEdits to keep track of the
-						// number of non-empty blocks per edit per tick and remove edits entirely.
-						// Not worth it right now as that should be a very rare situation.
-						edits.back().chunk.data[chunkIndex.x][chunkIndex.y] = BlockId::None;
-						return true;
+			bool editAdded = false;
+
+			for (const auto& edit : edits) {
+				const auto idx = edit.chunkIndex;
+				auto const& inChunk = chunk.data[idx.x][idx.y] == edit.bid;
+
+				// This could be greatly simplified if we didn't care about inserting empty edits, but we do
+				// care since the number of edits has significant performance implications during a mis-prediction.
+				if (inChunk) {
+					if (!chunkEdits.empty() && chunkEdits.back().tick == tick) {
+						// Remove from edit if it has already been inserted by another edit. This could
+						// theoretically happen if there are three edits in one tick: BlockA > BlockB >
+						// BlockA.
+						auto& pending = chunkEdits.back().chunk.data[idx.x][idx.y];
+						if (pending != BlockId::None) {
+							// TODO: We could also use chunksUpdatedFromEdits to keep track of the
+							// number of non-empty blocks per edit per tick and remove edits entirely.
+							// Not worth it right now as that should be a very rare situation.
+							pending = BlockId::None;
+							onChange(edit);
+						}
+					}
+				} else {
+					if (chunkEdits.empty() || chunkEdits.back().tick != tick) {
+						chunkEdits.push({.tick = tick});
 					}
-				}
-
-				// Nothing to edit.
-				return false;
-			} else {
-				if (edits.empty() || edits.back().tick != world.getTick()) {
-					edits.push({.tick = world.getTick()});
-				}
 
-				if (edits.back().chunk.data[chunkIndex.x][chunkIndex.y] != bid) {
-					edits.back().chunk.data[chunkIndex.x][chunkIndex.y] = bid;
-					chunksUpdatedFromEdits.emplace(chunkCoord);
-					return true;
+					auto& pending = chunkEdits.back().chunk.data[idx.x][idx.y];
+					if (pending != edit.bid) {
+						pending = edit.bid;
+						editAdded = true;
+						onChange(edit);
+					}
 				}
+			}
 
-				// Nothing to edit.
-				return false;
+			if (editAdded) {
+				chunksUpdatedFromEdits.emplace(chunkCoord);
 			}
 		#else
-			if (terrain.getChunk(chunkCoord).data[chunkIndex.x][chunkIndex.y] != bid) {
-				auto& edit = serverChunkEdits[chunkCoord];
-				edit.data[chunkIndex.x][chunkIndex.y] = bid;
-				return true;
-			} else {
-				return false;
+			auto const& chunk = terrain.getChunk(chunkCoord);
+			MapChunk* chunkEdit = nullptr;
+
+			for (const auto& edit : edits) {
+				const auto idx = edit.chunkIndex;
+				if (chunk.data[idx.x][idx.y] == edit.bid) {
+					// Undo any earlier edit to this block this tick: BlockA > BlockB > BlockA.
+					if (!chunkEdit) {
+						const auto found = serverChunkEdits.find(chunkCoord);
+						if (found == serverChunkEdits.end()) { continue; }
+						chunkEdit = &found->second;
+					}
+
+					auto& pending = chunkEdit->data[idx.x][idx.y];
+					if (pending != BlockId::None) {
+						pending = BlockId::None;
+						onChange(edit);
+					}
+				} else {
+					if (!chunkEdit) { chunkEdit = &serverChunkEdits[chunkCoord]; }
+
+					auto& pending = chunkEdit->data[idx.x][idx.y];
+					if (pending != edit.bid) {
+						pending = edit.bid;
+						onChange(edit);
+					}
+				}
 			}
 		#endif
+
+		return changed;
 	}
 	
 	// TODO: Thread this. Not sure how nice box2d will play with it. If it doesn't when we
@@ -1274,6 +1461,104 @@ namespace Game {
 		}
 	}
 	
+	void MapSystem::deactivateChunk(const UniversalChunkCoord chunkPos, ActiveChunkData&& data) {
+		auto& physSys = world.getSystem<PhysicsSystem>();
+		const uint64 budget = uint64{Engine::getGlobalConfig().cvars.tn_chunk_cache_size} * 1024 * 1024;
+
+		// Chunks with pending predicted edits can't be reused since their data will be reset.
+		bool cacheable = budget > 0 && terrain.isChunkLoaded(chunkPos);
+		ENGINE_CLIENT_ONLY(cacheable = cacheable && data.edits.empty());
+
+		if (!cacheable) {
+			physSys.destroyBody(data.body);
+			return;
+		}
+
+		// Removes the fixtures from the broad-phase without destroying them.
+		data.body.setActive(false);
+		data.blockEntities.clear();
+
+		uint64 bytes = sizeof(InactiveChunkData) + data.vbuff.size() + data.ebuff.size() + data.rle.capacity();
+		for (auto* fixture = data.body.getFixtureList(); fixture; fixture = fixture->GetNext()) {
+			bytes += sizeof(b2Fixture) + sizeof(b2PolygonShape);
+		}
+
+		const auto seq = inactiveChunksSeq++;
+		const auto [it, inserted] = inactiveChunks.try_emplace(chunkPos, InactiveChunkData{
+			.data = std::move(data),
+			.version = getChunkVersion(terrain.getChunk(chunkPos)),
+			.bytes = bytes,
+			.seq = seq,
+		});
+
+		// Shouldn't be possible since a chunk is removed from the cache when it is reactivated.
+		ENGINE_DEBUG_ASSERT(inserted, "Attempting to cache an already cached chunk.");
+
+		inactiveChunksBytes += bytes;
+		inactiveChunksOrder.push({.chunkPos = chunkPos, .seq = seq});
+		evictInactiveChunks(budget);
+	}
+
+	auto MapSystem::reactivateChunk(const UniversalChunkCoord chunkPos, const ZoneId zoneId, const WorldAbsVec zoneOffset) -> decltype(activeChunks)::iterator {
+		const auto found = inactiveChunks.find(chunkPos);
+		if (found == inactiveChunks.end()) { return activeChunks.end(); }
+
+		auto& cached = found->second;
+		inactiveChunksBytes -= cached.bytes;
+
+		// The chunk was modified while inactive. The render and physics data needs to be fully rebuilt.
+		if (!terrain.isChunkLoaded(chunkPos) || cached.version != getChunkVersion(terrain.getChunk(chunkPos))) {
+			world.getSystem<PhysicsSystem>().destroyBody(cached.data.body);
+			inactiveChunks.erase(found);
+			return activeChunks.end();
+		}
+
+		// The zone may have been reused or changed since the chunk was deactivated so always update the position.
+		auto& body = cached.data.body;
+		if (body.getZoneId() != zoneId) {
+			body.setZone(zoneId);
+			world.getSystem<PhysicsSystem>().updateZoneWorld(body);
+		}
+
+		const auto pos = blockToWorld(chunkToBlock(chunkPos.pos), zoneOffset);
+		body.setPosition({pos.x, pos.y});
+		body.setActive(true);
+
+		const auto it = activeChunks.try_emplace(chunkPos, std::move(cached.data)).first;
+		inactiveChunks.erase(found);
+		return it;
+	}
+
+	void MapSystem::evictInactiveChunks(uint64 budget) {
+		auto& physSys = world.getSystem<PhysicsSystem>();
+
+		while (inactiveChunksBytes > budget && !inactiveChunksOrder.empty()) {
+			const auto order = inactiveChunksOrder.front();
+			inactiveChunksOrder.pop();
+
+			// Entries are not removed from the order when reactivated, skip any that are no longer valid.
+			const auto found = inactiveChunks.find(order.chunkPos);
+			if (found == inactiveChunks.end() || found->second.seq != order.seq) { continue; }
+
+			inactiveChunksBytes -= found->second.bytes;
+			physSys.destroyBody(found->second.data.body);
+			inactiveChunks.erase(found);
+		}
+
+		// Avoid unbounded growth of stale entries when chunks are frequently reactivated.
+		if (inactiveChunksOrder.size() > 2 * inactiveChunks.size() + 64) {
+			for (auto count = inactiveChunksOrder.size(); count; --count) {
+				const auto order = inactiveChunksOrder.front();
+				inactiveChunksOrder.pop();
+
+				const auto found = inactiveChunks.find(order.chunkPos);
+				if (found != inactiveChunks.end() && found->second.seq == order.seq) {
+					inactiveChunksOrder.push(order);
+				}
+			}
+		}
+	}
+
 	#if ENGINE_SERVER
 		void MapSystem::queueGeneration(const Terrain::Request& request) {
 			// TODO: Consider a way to do chunks in an outward spiral order so that the
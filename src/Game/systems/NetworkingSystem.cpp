@@ -1,7 +1,10 @@
 // STD
 #include <algorithm>
 #include <concepts>
+#include <cstring>
+#include <filesystem>
 #include <iomanip>
+#include <limits>
 #include <random>
 #include <set>
 
@@ -13,6 +16,8 @@
 #include <Engine/Math/math.hpp>
 #include <Engine/ArrayView.hpp>
 #include <Engine/Noise/noise.hpp>
+#include <Engine/Net/LoopbackNetwork.hpp>
+#include <Engine/Utility/Utility.hpp>
 
 // Game
 #include <Game/systems/EntityNetworkingSystem.hpp>
@@ -38,18 +43,21 @@
 //    - CLIENT: Allocate a client key if not exists.
 //    - CLIENT: Client side transitions to "Connecting"
 // 2. Client > CONNECT_REQUEST > Server.
+//    - SERVER: Rate limit handshakes per address. @see NetworkingSystem::recvHandshake
 //    - SERVER: Verify correct padding included.
-//    - SERVER: Reads client key or aborts if mismatch with an existing key from a previous, non-timed out, connection attempt.
-//    - SERVER: Allocates a server key if this is a new connection.
-//    - SERVER: Server side transitions to "Connecting".
+//    - SERVER: Reads client key.
+//    - SERVER: Does not create a connection or keep any other state.
 // 3. Server > CONNECT_CHALLENGE > Client.
-//    - CLIENT: Reads the server key.
+//    - SERVER: Sends a cookie derived from the client address, client key, and time.
+//    - CLIENT: Reads the cookie.
 // 4. Client > CONNECT_AUTH > Server.
-//    - SERVER: Verify correct server key included.
 //    - SERVER: Verify correct padding included.
+//    - SERVER: Verify the cookie matches the client address and key.
+//    - SERVER: Creates the connection and allocates a server key.
 //    - SERVER: Server side transitions to "Connected".
 //    - SERVER: Adds player entity.
 // 5. Server > CONNECT_CONFIRM, ECS_INIT, CONFIG_NETWORK > Client.
+//    - CLIENT (CONNECT_CONFIRM): Reads the server key.
 //    - These three are all included as a batch (must fit in same packet) and
 //      should be processed sequentially to ensure correct state
 //      transition/world sync/player entity creation.
@@ -57,8 +65,10 @@
 //    - CLIENT (ECS_INIT): Sync client tick with server tick
 //    - CLIENT (ECS_INIT): Add player entity
 //    - CLIENT (CONFIG_NETWORK): Send server desired recv rate
+//    - CLIENT (CONFIG_NETWORK): Accept the offered packet codec if it matches our own.
 // 6. Client > CONFIG_NETWORK > Server
 //    - SERVER: Configure network rate based on client request.
+//    - SERVER: Enable packet compression if the client accepted the codec.
 //
 // The CONNECT_CONFIRM message may seem cosmetic at first, but it is useful to
 // act as a fence for transitioning from the connecting to connected states and
@@ -93,17 +103,27 @@ namespace {
 		PlayerFlag
 	>;
 
-	// With the ack size and tick rate equal there will be 1s before acks are
-	// lost. Increasing the tick rate past this will reduce that size, which is
-	// technically fine, but probably not desirable.
+	// Connections ack at least one packet per tick for up to a second, more at
+	// higher packet rates. The ack window must be large enough to hold that.
 	static_assert(
-		tickrate == Engine::Net::AckBitset::capacity(),
-		"Tick rate does not align with network ack size. "
-		"This will lead to a smaller or larger ack window, which may be fine, but is something needs to be considered."
+		tickrate <= Engine::Net::AckBitset::size(),
+		"Tick rate is larger than the network ack window. "
+		"Packets will be considered lost before they would normally be acked."
 	);
 
+	Engine::Net::UDPSocket makeSocket() {
+		const auto& cfg = Engine::getGlobalConfig();
+		if (cfg.loopback) {
+			return Engine::Net::UDPSocket{*cfg.loopback, cfg.port};
+		}
+
+		return Engine::Net::UDPSocket{cfg.port, Engine::Net::SocketFlag::NonBlocking | (cfg.cvars.net_socket_reuse_port ? Engine::Net::SocketFlag::ReusePort : Engine::Net::SocketFlag::None)};
+	}
+
 	constexpr uint8 msgPadSeq[] = {0x54, 0x68, 0x65, 0x20, 0x63, 0x61, 0x6B, 0x65, 0x20, 0x69, 0x73, 0x20, 0x61, 0x20, 0x6C, 0x69, 0x65, 0x2E, 0x20};
+}
 
+namespace Game {
 	void writeMessagePadding(Engine::Net::StaticBufferWriter& msg) {
 		while (msg.write(msgPadSeq)) {}
 		msg.write(msgPadSeq, msg.space());
@@ -127,7 +147,69 @@ namespace {
 
 		return true;
 	}
+
+	Engine::Net::PacketCodec loadPacketCodec() {
+		constexpr auto path = "net.dict";
+		if (!std::filesystem::exists(path)) { return {}; }
+
+		const auto data = Engine::Utility::readFile(path);
+		ENGINE_LOG2("Loaded packet dictionary {} ({} bytes)", path, data.size());
+		return Engine::Net::PacketCodec{{reinterpret_cast<const byte*>(data.data()), data.size()}};
+	}
+
+	std::vector<byte> trainPacketDictionary(const std::string& capture, const Engine::Net::PacketCodec& codec, int32 size) {
+		Engine::Net::PacketReplay replay{capture};
+		if (!replay.isOpen()) {
+			ENGINE_WARN2("Unable to open packet capture {}", capture);
+			return {};
+		}
+
+		std::vector<std::vector<byte>> samples;
+		int64 skipped = 0;
+		Engine::Net::Packet packet;
+		byte buff[sizeof(packet.body)];
+
+		while (replay.next()) {
+			for (const auto& entry : replay.getFrame()) {
+				const auto sz = static_cast<int32>(entry.data.size());
+				if (sz <= static_cast<int32>(sizeof(packet.head)) || sz > static_cast<int32>(sizeof(packet))) {
+					++skipped;
+					continue;
+				}
+
+				// Copy so the packet is correctly aligned.
+				memcpy(&packet, entry.data.data(), sz);
+				if (packet.getProtocol() != Engine::Net::protocol || packet.getVersion() != Engine::Net::Packet::version) {
+					++skipped;
+					continue;
+				}
+
+				Engine::Net::AckBitset acks;
+				const auto bodySize = packet.readAcks(acks, sz - static_cast<int32>(sizeof(packet.head)));
+				if (bodySize <= 0) {
+					++skipped;
+					continue;
+				}
+
+				std::span<const byte> body{packet.body, static_cast<uintz>(bodySize)};
+				if (packet.getFlags() & Engine::Net::PacketFlag::Compressed) {
+					const auto len = codec.decompress(body, buff);
+					if (len <= 0) {
+						++skipped;
+						continue;
+					}
+					body = {buff, static_cast<uintz>(len)};
+				}
+
+				samples.emplace_back(body.begin(), body.end());
+			}
+		}
+
+		ENGINE_LOG2("Training packet dictionary from {} packets ({} skipped)", samples.size(), skipped);
+		return Engine::Net::PacketCodec::train(samples, size);
+	}
 }
+
 #if DEBUG
 namespace {
 	struct HandleMessageDef_DebugBreak_Struct {
@@ -150,124 +232,6 @@ namespace {
 
 
 namespace Game {
-	#if ENGINE_SERVER
-		HandleMessageDef(MessageType::DISCOVER_SERVER)
-			// TODO: rate limit per ip (longer if invalid packet)
-			if (verifyMessagePadding(msg)) {
-				if (auto reply = from.beginMessage<MessageType::SERVER_INFO>()) {
-					//constexpr char name[] = "This is the name of the server";
-					std::string name = "This is the name of the server ";
-					name += std::to_string(Engine::getGlobalConfig().port);
-					reply.write<int>(int(std::size(name)));
-					reply.write(name.data(), std::size(name));
-				}
-			} else if constexpr (ENGINE_DEBUG) {
-				[[maybe_unused]] const auto rem = msg.remaining();
-				ENGINE_DEBUG_ASSERT(false);
-			}
-
-			msg.discard();
-		}
-
-		HandleMessageDef(MessageType::CONNECT_REQUEST)
-			uint16 remote = {};
-			msg.read<uint16>(&remote);
-
-			if (!verifyMessagePadding(msg)) {
-				// TODO: rate limit connections with invalid messages
-				ENGINE_WARN("Got invalid connection request from ", from.address());
-				return;
-			} else {
-				msg.discard();
-			}
-
-			if (from.getKeyRemote() && from.getKeyRemote() != remote) {
-				ENGINE_WARN("Got connection request with invalid key from ", from.address(), " (", remote, " != ", from.getKeyRemote(), ")");
-				return msg.discard();
-			} else {
-				from.setKeyRemote(remote);
-			}
-
-			if (from.getState() == ConnectionState::Disconnected) {
-				ENGINE_DEBUG_ASSERT(from.getKeyLocal() == 0, "It should not be possible to have a local key in an unconnected state. This is a bug.");
-				from.setState(ConnectionState::Connecting);
-
-				auto& world = engine.getWorld();
-				auto& netSys = world.getSystem<NetworkingSystem>();
-				from.setKeyLocal(netSys.genKey());
-			} else {
-				ENGINE_DEBUG_ASSERT(from.getKeyLocal() != 0, "It should not be possible to be missing a local key in any non-unconnected state. This is a bug.");
-			}
-
-			if (auto reply = from.beginMessage<MessageType::CONNECT_CHALLENGE>()) {
-				reply.write(from.getKeyLocal());
-				ENGINE_LOG("CONNECT_REQUEST from ", from.address(), " lkey: ", from.getKeyLocal(), " rkey: ", from.getKeyRemote());
-			}
-		}
-
-		HandleMessageDef(MessageType::CONNECT_AUTH)
-			uint16 key = {};
-			msg.read<uint16>(&key);
-
-			if (key != from.getKeyLocal()) {
-				ENGINE_WARN("CONNECT_AUTH: Invalid recv key ", key, " != ", from.getKeyLocal());
-				return msg.discard();
-			}
-
-			if (!verifyMessagePadding(msg)) {
-				// TODO: rate limit connections with invalid messages
-				ENGINE_WARN("Got invalid connection confirm from ", from.address());
-				return;
-			} else {
-				msg.discard();
-			}
-
-			auto& world = engine.getWorld();
-			from.setState(ConnectionState::Connected);
-			ENGINE_LOG("CONNECT_AUTH from ", from.address(), " - ", &from, " lkey: ", from.getKeyLocal(), " rkey: ", from.getKeyRemote(), " tick: ", world.getTick(), " ", from.ent);
-
-			// TODO: query map system and find good spawn location and realm
-			auto& zoneSys = world.getSystem<ZoneManagementSystem>();
-			constexpr WorldAbsVec pos = {0, 2};
-
-			const auto zoneId = zoneSys.findOrCreateZoneFor(0, pos);
-			const auto& zone = zoneSys.getZone(zoneId);
-			const auto finalPos = world.getSystem<NetworkingSystem>().addPlayer(from, zoneId, absolueToRelative(pos, zone.offset));
-
-			// It is important that all three of these messages are sent in the same
-			// packet so that the are processed immediately and before messages in
-			// other channels. That should be true since these messages are very
-			// small and we shouldn't be sending any other messages at this time.
-			// See notes above (top of file) for details.
-			if (auto reply = from.beginMessage<MessageType::CONNECT_CONFIRM>()) {
-			} else {
-				// TODO: handle. If we cant send the
-				//       CONNECT_CONFIRM/ECS_INIT/CONFIG_NETWORK we need to abort
-				//       this connection and wait on the client to restart the
-				//       handshake process.
-			}
-
-			// TODO: change message type of this (for client). This isnt a confirmation this is initial sync or similar.
-			if (auto reply = from.beginMessage<MessageType::ECS_INIT>()) {
-				ENGINE_DEBUG_ASSERT(from.ent, "Attempting to network invalid entity.");
-				reply.write(from.ent);
-				reply.write(world.getTick());
-				reply.write(zoneId);
-				reply.write(zone.realmId);
-				reply.write(zone.offset);
-				reply.write(finalPos);
-			} else {
-				// TODO: handle
-			}
-
-			if (auto reply = from.beginMessage<MessageType::CONFIG_NETWORK>()) {
-				reply.write(from.getPacketRecvRate());
-			} else {
-				// TODO: handle
-			}
-		}
-	#endif // ENGINE_SERVER
-
 	#if ENGINE_CLIENT
 		HandleMessageDef(MessageType::SERVER_INFO)
 			int len;
@@ -282,32 +246,35 @@ namespace Game {
 		}
 
 		HandleMessageDef(MessageType::CONNECT_CHALLENGE)
-			if (from.getKeyRemote()) {
-				ENGINE_WARN("Extraneous CONNECT_CHALLENGE received. Ignoring.");
-				ENGINE_DEBUG_ASSERT(from.getState() == ConnectionState::Connected);
-				return msg.discard();
-			}
-
-			uint16 remote = {};
-			if (!msg.read<uint16>(&remote)) {
+			uint32 cookie = {};
+			if (!msg.read<uint32>(&cookie)) {
 				ENGINE_WARN("Invalid connection challenge received.");
 				return msg.discard();
 			}
 
+			// The server doesn't keep any state until it gets a valid cookie back
+			// so every challenge is answered, even repeated ones.
 			if (auto reply = from.beginMessage<MessageType::CONNECT_AUTH>()) {
-				reply.write(remote);
+				reply.write(from.getKeyLocal());
+				reply.write(cookie);
 				writeMessagePadding(reply.getBufferWriter());
 
-				from.setKeyRemote(remote);
-
-				ENGINE_LOG("CONNECT_CHALLENGE from ", from.address(), " - ", &from, " lkey: ", from.getKeyLocal(), " rkey: ", from.getKeyRemote());
+				ENGINE_LOG("CONNECT_CHALLENGE from ", from.address(), " - ", &from, " lkey: ", from.getKeyLocal());
 			} else [[unlikely]] {
 				ENGINE_WARN("Unable to send CONNECT_AUTH");
 			}
 		}
 
 		HandleMessageDef(MessageType::CONNECT_CONFIRM)
-			ENGINE_INFO2("CONNECT_CONFIRM");
+			// The server only assigns its key once the handshake is complete.
+			uint32 key = {};
+			if (!msg.read<uint32>(&key) || !key) {
+				ENGINE_WARN("Invalid connection confirm received.");
+				return msg.discard();
+			}
+
+			ENGINE_INFO2("CONNECT_CONFIRM rkey: {}", key);
+			from.setKeyRemote(key);
 			from.setState(ConnectionState::Connected);
 		}
 	#endif // ENGINE_CLIENT
@@ -321,15 +288,29 @@ namespace Game {
 
 	HandleMessageDef(MessageType::CONFIG_NETWORK)
 		float32 rate;
-		if (!msg.read(&rate)) {
+		uint32 codecId;
+		if (!msg.read(&rate) || !msg.read(&codecId)) {
 			ENGINE_WARN("Invalid CONFIG_NETWORK received.");
 			return;
 		}
 
 		if constexpr (ENGINE_CLIENT) {
+			// Accept the server's codec if we have the same dictionary.
+			if (codecId != from.getPacketCodecId()) {
+				const auto& codec = engine.getWorld().getSystem<NetworkingSystem>().getPacketCodec();
+				const bool accept = codecId == codec.getId() && Engine::getGlobalConfig().cvars.net_compression;
+				from.setPacketCodec(accept ? &codec : nullptr);
+				from.setPacketCompression(accept);
+				ENGINE_LOG2("Packet compression {}", accept ? "enabled" : "disabled");
+			}
+
 			if (auto reply = from.beginMessage<MessageType::CONFIG_NETWORK>()) {
 				reply.write(from.getPacketRecvRate());
+				reply.write(from.getPacketCodecId());
 			}
+		} else {
+			// The client has accepted or declined our codec.
+			from.setPacketCompression(codecId && codecId == from.getPacketCodecId());
 		}
 
 		const float32 maxSendRate = Engine::getGlobalConfig().cvars.net_packet_rate_max;
@@ -352,23 +333,80 @@ namespace Game {
 	NetworkingSystem::NetworkingSystem(SystemArg arg)
 		: System{arg}
 		, group{Engine::getGlobalConfig().group}
-		, socket{Engine::getGlobalConfig().port, Engine::Net::SocketFlag::NonBlocking}
+		, socket{makeSocket()}
 		#if ENGINE_SERVER
 		, discoverServerSocket{Net::UDPSocket::doNotInitialize}
 		#endif
-		, rng{pcg_extras::seed_seq_from<std::random_device>{}} {
+		, codec{loadPacketCodec()}
+		// Clients only have a single connection so there is nothing to split between threads.
+		, assembler{ENGINE_SERVER ? static_cast<int32>(Engine::getGlobalConfig().cvars.net_send_threads) : 0}
+		#if ENGINE_SERVER
+		, handshakeLimiter{4096, Engine::getGlobalConfig().cvars.net_handshake_rate, Engine::getGlobalConfig().cvars.net_handshake_total_rate}
+		#endif
+		{
+
+		ENGINE_LOG2("Listening on {}port {}", socket.isLoopback() ? "loopback " : "", socket.getAddress().port);
+
+		{
+			const auto& cfg = Engine::getGlobalConfig();
+
+			// Keys are generated from this so it needs to be the same when replaying a capture.
+			std::random_device rd;
+			auto seed = (static_cast<uint64>(rd()) << 32) | rd();
+
+			if (!cfg.replay.empty()) {
+				replay = std::make_unique<Engine::Net::PacketReplay>(cfg.replay);
+				if (replay->isOpen()) {
+					seed = replay->getSeed();
+					ENGINE_LOG2("Replaying packet capture {}", cfg.replay);
+				} else {
+					replay.reset();
+				}
+			}
+
+			if (!cfg.capture.empty()) {
+				capture = std::make_unique<Engine::Net::PacketCapture>(cfg.capture, seed);
+				if (capture->isOpen()) {
+					ENGINE_LOG2("Capturing packets to {}", cfg.capture);
+				} else {
+					capture.reset();
+				}
+			}
+
+			rng.seed(seed);
+
+			#if ENGINE_SERVER
+				const auto k0 = (static_cast<uint64>(rng()) << 32) | rng();
+				const auto k1 = (static_cast<uint64>(rng()) << 32) | rng();
+				cookies = {k0, k1};
+			#endif
+		}
+
+		updateSimSettings();
 
-		ENGINE_LOG2("Listening on port {}", socket.getAddress().port);
+		{
+			const auto& cvars = Engine::getGlobalConfig().cvars;
+			// Socket options don't apply to loopback sockets.
+			if (!socket.isLoopback()) {
+				if (cvars.net_socket_recv_buffer && !socket.setOption<Net::SocketOption::RecvBufferSize>(static_cast<int32>(cvars.net_socket_recv_buffer * 1024))) {
+					ENGINE_WARN2("Unable to set socket receive buffer size to {}KB", cvars.net_socket_recv_buffer);
+				}
+
+				if (cvars.net_socket_send_buffer && !socket.setOption<Net::SocketOption::SendBufferSize>(static_cast<int32>(cvars.net_socket_send_buffer * 1024))) {
+					ENGINE_WARN2("Unable to set socket send buffer size to {}KB", cvars.net_socket_send_buffer);
+				}
+			}
+
+			// There is nothing to receive while replaying.
+			if (cvars.net_thread && !replay) {
+				netThread = std::make_unique<Engine::Net::NetworkThread>(socket);
+				ENGINE_LOG2("Using network thread");
+			}
+		}
 
 		setMessageHandler(MessageType::DISCONNECT, handleMessageType<MessageType::DISCONNECT>);
 		setMessageHandler(MessageType::CONFIG_NETWORK, handleMessageType<MessageType::CONFIG_NETWORK>);
 
-		ENGINE_SERVER_ONLY(
-			setMessageHandler(MessageType::DISCOVER_SERVER, handleMessageType<MessageType::DISCOVER_SERVER>);
-			setMessageHandler(MessageType::CONNECT_REQUEST, handleMessageType<MessageType::CONNECT_REQUEST>);
-			setMessageHandler(MessageType::CONNECT_AUTH, handleMessageType<MessageType::CONNECT_AUTH>);
-		);
-
 		ENGINE_CLIENT_ONLY(
 			setMessageHandler(MessageType::SERVER_INFO, handleMessageType<MessageType::SERVER_INFO>);
 			setMessageHandler(MessageType::CONNECT_CONFIRM, handleMessageType<MessageType::CONNECT_CONFIRM>);
@@ -410,34 +448,272 @@ namespace Game {
 	#endif
 
 	void NetworkingSystem::recvAndDispatchMessages(Engine::Net::UDPSocket& sock) {
-		int32 sz;
-		Engine::Net::IPv4Address addr;
+		while (true) {
+			for (uintz i = 0; i < packets.size(); ++i) {
+				datagrams[i] = {.data = &packets[i], .size = sizeof(packets[i])};
+			}
 
-		while ((sz = sock.recv(&packet, sizeof(packet), addr)) > -1) {
-			// TODO: move back to connection
-			if (packet.getProtocol() != Engine::Net::protocol) {
-				ENGINE_WARN("Invalid protocol");
-				continue;
+			const auto count = sock.recvBatch(datagrams);
+			for (int32 i = 0; i < count; ++i) {
+				dispatchPacket(packets[i], datagrams[i].size, datagrams[i].address, now);
 			}
 
-			auto& conn = getOrCreateConnection(addr);
-			if (conn.getKeyLocal() != packet.getKey()) {
-				if (conn.getState() == ConnectionState::Connected) {
-					ENGINE_WARN("Invalid key for ", conn.address(), " ", packet.getKey(), " != ", conn.getKeyLocal());
-					continue;
+			// A partial batch means there is nothing left to read.
+			if (count < std::ssize(datagrams)) { break; }
+		}
+	}
+
+	void NetworkingSystem::replayMessages() {
+		if (!replay->isOpen()) { return; }
+
+		if (replay->next()) {
+			if (replayStart == Engine::Clock::TimePoint{}) { replayStart = now; }
+
+			for (const auto& entry : replay->getFrame()) {
+				// Copy so the packet is correctly aligned.
+				const auto sz = std::min<int32>(static_cast<int32>(entry.data.size()), sizeof(packets[0]));
+				memcpy(&packets[0], entry.data.data(), sz);
+				dispatchPacket(packets[0], sz, entry.address, replayStart + entry.time);
+			}
+		}
+
+		if (!replay->isOpen()) {
+			ENGINE_LOG2("Packet replay finished. Replayed {} datagrams over {} updates.", replay->getDatagramCount(), replay->getFrameCount());
+		}
+	}
+
+	void NetworkingSystem::dispatchPacket(const Engine::Net::Packet& packet, int32 sz, const Engine::Net::IPv4Address& addr, Engine::Clock::TimePoint time) {
+		if (capture) {
+			capture->datagram(time, addr, {reinterpret_cast<const byte*>(&packet), static_cast<uintz>(sz)});
+		}
+
+		// TODO: move back to connection
+		if (packet.getProtocol() != Engine::Net::protocol) {
+			ENGINE_WARN("Invalid protocol");
+			return;
+		}
+
+		if (packet.getVersion() != Engine::Net::Packet::version) {
+			ENGINE_WARN("Unsupported packet version ", +packet.getVersion(), " from ", addr);
+			return;
+		}
+
+		auto* conn = findConnection(packet.getKey(), addr);
+		if (!conn) {
+			#if ENGINE_SERVER
+				recvHandshake(packet, sz, addr, time);
+				return;
+			#else
+				// Clients only have a few connections. Anything without a valid key,
+				// such as server info replies, is matched by address instead.
+				conn = &getOrCreateConnection(addr);
+				if (conn->getState() == ConnectionState::Connected) {
+					ENGINE_WARN("Invalid key for ", conn->address(), " ", packet.getKey(), " != ", conn->getKeyLocal());
+					return;
+				}
+			#endif
+		}
+
+		if (!conn->recv(packet, sz, time)) { return; }
+
+		while (true) {
+			auto [hdr, msg] = conn->recvNext();
+			if (hdr.type == 0) { break; }
+			dispatchMessage(*conn, hdr, msg);
+			ENGINE_DEBUG_ASSERT(msg.remaining() == 0, "Incomplete read of network message.");
+		}
+	}
+
+	#if ENGINE_SERVER
+	void NetworkingSystem::sendStateless(const Engine::Net::IPv4Address& addr, uint32 key, MessageType type, auto&& write) {
+		// Nothing is sent to the captured addresses while replaying.
+		if (replay) { return; }
+
+		// Sequence numbers and acks are left as zero. Handshake messages are
+		// unreliable so it doesn't matter which packet they arrive in.
+		Engine::Net::Packet pkt;
+		pkt.setProtocol(Engine::Net::protocol);
+		pkt.setVersion(Engine::Net::Packet::version);
+		pkt.setKey(key);
+
+		Engine::Net::StaticBufferWriter buff{pkt.body};
+		buff.write(Engine::Net::MessageHeader{});
+		write(buff);
+
+		// The body isn't aligned so the header is copied in instead of written in place.
+		const Engine::Net::MessageHeader hdr = {
+			.type = type,
+			.size = static_cast<uint16>(buff.size() - sizeof(Engine::Net::MessageHeader)),
+		};
+		memcpy(pkt.body, &hdr, sizeof(hdr));
+
+		const auto bodySize = pkt.writeAcks({}, 1, static_cast<int32>(buff.size()));
+		const auto sz = static_cast<int32>(sizeof(pkt.head)) + bodySize;
+		if (netThread) {
+			netThread->queue(&pkt, sz, addr);
+		} else {
+			socket.queue(&pkt, sz, addr);
+		}
+	}
+
+	void NetworkingSystem::recvHandshake(const Engine::Net::Packet& packet, int32 sz, const Engine::Net::IPv4Address& addr, Engine::Clock::TimePoint time) {
+		// Anyone can send to this path so it is limited before doing any other
+		// work. This keeps connection storms, such as every player reconnecting
+		// after a restart, from using the whole tick.
+		if (!handshakeLimiter.allow(addr, time)) { return; }
+
+		// Handshake messages are padded to fill the whole body so there is only ever one message.
+		Engine::Net::AckBitset acks;
+		const auto bodySize = packet.readAcks(acks, sz - static_cast<int32>(sizeof(packet.head)));
+		if (bodySize != sizeof(packet.body) || (packet.getFlags() & Engine::Net::PacketFlag::Compressed)) { return; }
+
+		Engine::Net::BufferReader msg{packet.body, bodySize};
+		Engine::Net::MessageHeader hdr;
+		if (!msg.read(&hdr) || sizeof(hdr) + hdr.size != bodySize) { return; }
+
+		const auto since = time - handshakeEpoch;
+		switch (hdr.type) {
+			case MessageType::DISCOVER_SERVER: {
+				if (!verifyMessagePadding(msg)) { return; }
+
+				sendStateless(addr, packet.getKey(), MessageType::SERVER_INFO, [&](Engine::Net::StaticBufferWriter& buff){
+					std::string name = "This is the name of the server ";
+					name += std::to_string(Engine::getGlobalConfig().port);
+					buff.write<int>(int(std::size(name)));
+					buff.write(name.data(), std::size(name));
+				});
+				break;
+			}
+			case MessageType::CONNECT_REQUEST: {
+				uint32 keyRemote = {};
+				if (!msg.read(&keyRemote) || !keyRemote || !verifyMessagePadding(msg)) {
+					ENGINE_WARN("Got invalid connection request from ", addr);
+					return;
+				}
+
+				const auto cookie = cookies.make(addr, keyRemote, since);
+				sendStateless(addr, keyRemote, MessageType::CONNECT_CHALLENGE, [&](Engine::Net::StaticBufferWriter& buff){
+					buff.write(cookie);
+				});
+
+				ENGINE_LOG("CONNECT_REQUEST from ", addr, " rkey: ", keyRemote);
+				break;
+			}
+			case MessageType::CONNECT_AUTH: {
+				uint32 keyRemote = {};
+				uint32 cookie = {};
+				if (!msg.read(&keyRemote) || !msg.read(&cookie) || !verifyMessagePadding(msg)) {
+					ENGINE_WARN("Got invalid connection confirm from ", addr);
+					return;
+				}
+
+				if (!cookies.verify(cookie, addr, keyRemote, since)) {
+					ENGINE_WARN("Got expired or invalid handshake cookie from ", addr);
+					return;
 				}
+
+				acceptConnection(addr, keyRemote);
+				break;
+			}
+			default: {
+				// Anything else without a connection is ignored. This is usually
+				// late packets from a connection that has already been closed.
 			}
+		}
+	}
+
+	void NetworkingSystem::acceptConnection(const Engine::Net::IPv4Address& addr, uint32 keyRemote) {
+		if (auto* existing = getConnection(addr)) {
+			// A duplicate or repeated auth for a connection that has already been accepted.
+			if (existing->getKeyRemote() == keyRemote) { return; }
+
+			// The remote has restarted and is connecting again.
+			ENGINE_LOG("Replacing connection for ", addr);
+			disconnect(*existing);
+		}
+
+		if (freeSlots.empty() && slots.size() > std::numeric_limits<uint16>::max()) {
+			ENGINE_WARN("No free connection slots. Ignoring connection from ", addr);
+			return;
+		}
 
-			// ENGINE_LOG("****** ", conn.getKeySend(), " ", conn.getKeyRecv(), " ", packet.getKey(), " ", packet.getSeqNum());
-			
-			if (!conn.recv(packet, sz, now)) { continue; }
+		auto& from = getOrCreateConnection(addr);
+		from.setKeyRemote(keyRemote);
+		from.setKeyLocal(genKey(from.slot));
+		from.setState(ConnectionState::Connected);
+		from.setPacketCodec(nullptr);
+		ENGINE_LOG("CONNECT_AUTH from ", from.address(), " - ", &from, " lkey: ", from.getKeyLocal(), " rkey: ", from.getKeyRemote(), " tick: ", world.getTick(), " ", from.ent);
+
+		ENGINE_DEBUG_ONLY(from._debug_AllowMessages = true);
+
+		// TODO: query map system and find good spawn location and realm
+		auto& zoneSys = world.getSystem<ZoneManagementSystem>();
+		constexpr WorldAbsVec pos = {0, 2};
+
+		const auto zoneId = zoneSys.findOrCreateZoneFor(0, pos);
+		const auto& zone = zoneSys.getZone(zoneId);
+		const auto finalPos = addPlayer(from, zoneId, absolueToRelative(pos, zone.offset));
+
+		// It is important that all three of these messages are sent in the same
+		// packet so that the are processed immediately and before messages in
+		// other channels. That should be true since these messages are very
+		// small and we shouldn't be sending any other messages at this time.
+		// See notes above (top of file) for details.
+		if (auto reply = from.beginMessage<MessageType::CONNECT_CONFIRM>()) {
+			reply.write(from.getKeyLocal());
+		} else {
+			// TODO: handle. If we cant send the
+			//       CONNECT_CONFIRM/ECS_INIT/CONFIG_NETWORK we need to abort
+			//       this connection and wait on the client to restart the
+			//       handshake process.
+		}
+
+		// TODO: change message type of this (for client). This isnt a confirmation this is initial sync or similar.
+		if (auto reply = from.beginMessage<MessageType::ECS_INIT>()) {
+			ENGINE_DEBUG_ASSERT(from.ent, "Attempting to network invalid entity.");
+			reply.write(from.ent);
+			reply.write(world.getTick());
+			reply.write(zoneId);
+			reply.write(zone.realmId);
+			reply.write(zone.offset);
+			reply.write(finalPos);
+		} else {
+			// TODO: handle
+		}
 
-			while (true) {
-				auto [hdr, msg] = conn.recvNext();
-				if (hdr.type == 0) { break; }
-				dispatchMessage(conn, hdr, msg);
-				ENGINE_DEBUG_ASSERT(msg.remaining() == 0, "Incomplete read of network message.");
+		if (auto reply = from.beginMessage<MessageType::CONFIG_NETWORK>()) {
+			// Offer compression. We need to be able to decompress as soon as the
+			// client has the offer, but only compress once it has accepted.
+			if (Engine::getGlobalConfig().cvars.net_compression) {
+				from.setPacketCodec(&codec);
 			}
+
+			reply.write(from.getPacketRecvRate());
+			reply.write(from.getPacketCodecId());
+		} else {
+			// TODO: handle
+		}
+
+		ENGINE_DEBUG_ONLY(from._debug_AllowMessages = false);
+	}
+	#endif
+
+	void NetworkingSystem::sendAll() {
+		// Each connection only touches its own state and sink so they can be
+		// written in parallel. Anything shared, such as the socket, is only
+		// used once all connections are done.
+		assembler.assemble(static_cast<int32>(sendQueue.size()), [&](int32 i, Engine::Net::PacketAssembler::Sink& sink){
+			sendQueue[i]->send(sink);
+		});
+		sendQueue.clear();
+
+		// Nothing is sent to the captured addresses while replaying.
+		if (replay) { return; }
+
+		if (netThread) {
+			assembler.flush(*netThread);
+		} else {
+			assembler.flush(socket);
 		}
 	}
 
@@ -446,11 +722,30 @@ namespace Game {
 
 		now = world.getTime();
 
-		// Recv messages
 		#if ENGINE_SERVER
-			recvAndDispatchMessages(discoverServerSocket);
+			if (handshakeEpoch == Engine::Clock::TimePoint{}) { handshakeEpoch = now; }
+
+			const auto& cvars = Engine::getGlobalConfig().cvars;
+			handshakeLimiter.setRates(cvars.net_handshake_rate, cvars.net_handshake_total_rate);
 		#endif
-		recvAndDispatchMessages(socket);
+
+		// Recv messages
+		if (capture) { capture->frame(now); }
+
+		if (replay) {
+			replayMessages();
+		} else {
+			#if ENGINE_SERVER
+				recvAndDispatchMessages(discoverServerSocket);
+			#endif
+			if (netThread) {
+				netThread->recvAll([&](const Engine::Net::NetworkThread::RecvPacket& pkt){
+					dispatchPacket(pkt.packet, pkt.size, pkt.address, pkt.time);
+				});
+			} else {
+				recvAndDispatchMessages(socket);
+			}
+		}
 
 		// TODO: This distribution is largely untested since we don't currently
 		//       have an easy way to test with a large number of players.
@@ -540,21 +835,25 @@ namespace Game {
 				ENGINE_DEBUG_ONLY(for (auto& [ply, netComp] : plysThisUpdate) { netComp.get()._debug_AllowMessages = false; });
 
 				for (const auto& [ply, netComp] : plysThisUpdate) {
-					netComp.get().send(socket);
+					sendQueue.push_back(&netComp.get());
 				}
 			}
 		}
 
+		// Send for any connections that don't have an associated entity and
+		// as such won't be handled above. Send them on the last step since
+		// that step will always have the least entities due to remainder.
+		if (step + 1 == fullUpdatesPerNetworkInterval) {
+			for (const auto& [addr, conn] : addrToConn) {
+				if (!conn->ent) { sendQueue.push_back(conn.get()); }
+			}
+		}
+
+		sendAll();
+
 		for (auto cur =  addrToConn.begin(), end = addrToConn.end(); cur != end;) {
 			auto& [addr, conn] = *cur;
 
-			// Send for any connections that don't have an associated entity and
-			// as such won't be handled above. Send them on the last step since
-			// that step will always have the least entities due to remainder.
-			if (!conn->ent && (step + 1 == fullUpdatesPerNetworkInterval)) {
-				conn->send(socket);
-			}
-
 			// Handle any disconnects
 			if (now - conn->recvTime() >= timeout) { // Timeout, havent received a message recently.
 				cur = disconnect(cur);
@@ -571,9 +870,32 @@ namespace Game {
 			++cur;
 		}
 		
-		#ifdef ENGINE_UDP_NETWORK_SIM
+		// Connections only queue packets. Send them all at once. When using a
+		// network thread it owns the socket and handles this itself.
+		if (!netThread) {
+			socket.flush();
+
 			socket.realSimSend();
-		#endif
+		}
+	}
+
+	void NetworkingSystem::updateSimSettings() {
+		const auto& cvars = Engine::getGlobalConfig().cvars;
+		setSimSettings({
+			.halfPingAdd = cvars.net_sim_half_ping,
+			.jitter = cvars.net_sim_jitter,
+			.duplicate = cvars.net_sim_duplicate,
+			.loss = cvars.net_sim_loss,
+		});
+	}
+
+	void NetworkingSystem::setSimSettings(const Engine::Net::UDPSimSettings& settings) {
+		simSettings = settings;
+		if (netThread) {
+			netThread->setSimSettings(settings);
+		} else {
+			socket.getSimSettings() = settings;
+		}
 	}
 
 	int32 NetworkingSystem::playerCount() const {
@@ -612,8 +934,12 @@ namespace Game {
 	}
 
 	auto NetworkingSystem::disconnect(ConnIt connIt) -> ConnIt {
-		ENGINE_LOG("Disconnect ", connIt->second->address());
-		cleanECS(*connIt->second);
+		auto& conn = *connIt->second;
+		ENGINE_LOG("Disconnect ", conn.address());
+		cleanECS(conn);
+
+		slots[conn.slot] = nullptr;
+		freeSlots.push_back(conn.slot);
 		return addrToConn.erase(connIt);
 	}
 
@@ -666,9 +992,10 @@ namespace Game {
 		
 		conn.setKeyRemote(0);
 		conn.setState(ConnectionState::Connecting);
+		conn.setPacketCodec(nullptr);
 
 		if (!conn.getKeyLocal()) {
-			conn.setKeyLocal(genKey());
+			conn.setKeyLocal(genKey(conn.slot));
 		}
 		ENGINE_LOG("TRY CONNECT TO: ", addr, " lkey: ", conn.getKeyLocal(), " rkey: ",  conn.getKeyRemote(), " Tick: ", world.getTick());
 
@@ -731,8 +1058,21 @@ namespace Game {
 		if (found == addrToConn.end()) {
 			auto [it, _] = addrToConn.emplace(addr, std::make_unique<ConnectionInfo>(addr, now));
 			found = it;
-			found->second->setState(ConnectionState::Disconnected);
-			ENGINE_INFO2("Create connection: {} - {:0X}", addr, (intptr_t)found->second.get());
+
+			auto& conn = *found->second;
+			conn.setState(ConnectionState::Disconnected);
+
+			if (freeSlots.empty()) {
+				ENGINE_DEBUG_ASSERT(slots.size() <= std::numeric_limits<uint16>::max(), "Too many connections.");
+				conn.slot = static_cast<uint16>(slots.size());
+				slots.push_back(&conn);
+			} else {
+				conn.slot = freeSlots.back();
+				freeSlots.pop_back();
+				slots[conn.slot] = &conn;
+			}
+
+			ENGINE_INFO2("Create connection: {} - {:0X} (slot {})", addr, (intptr_t)&conn, conn.slot);
 		}
 		return *found->second;
 	}
@@ -17,20 +17,37 @@ namespace {
 }
 
 namespace Game {
+	PhysicsSystem::ZoneWorld::ZoneWorld(PhysicsSystem& physSys)
+		: b2World{b2Vec2_zero} {
+
+		SetContactListener(&physSys);
+		SetContactFilter(&physSys);
+
+		#if defined(DEBUG_PHYSICS)
+			SetDebugDraw(&physSys.debugDraw);
+		#endif
+	}
+
 	PhysicsSystem::PhysicsSystem(SystemArg arg)
 		: System{arg}
-		, physWorld{b2Vec2_zero} {
-
-		physWorld.SetContactListener(this);
-		physWorld.SetContactFilter(this);
+		, useZoneWorlds{ENGINE_SERVER_ONLY(Engine::getGlobalConfig().cvars.phys_zone_worlds != 0) ENGINE_CLIENT_ONLY(false)}
+		, workers{ENGINE_SERVER_ONLY(static_cast<int32>(Engine::getGlobalConfig().cvars.phys_step_threads)) ENGINE_CLIENT_ONLY(0)} {
 
 		#if defined(DEBUG_PHYSICS)
 			debugDraw.SetFlags(b2Draw::e_shapeBit | b2Draw::e_jointBit | b2Draw::e_pairBit | b2Draw::e_centerOfMassBit);
-			physWorld.SetDebugDraw(&debugDraw);
 			debugDraw.setup(engine.getCamera());
 		#endif
 	}
 
+	PhysicsSystem::ZoneWorld& PhysicsSystem::getZoneWorld(ZoneId zoneId) {
+		const auto i = useZoneWorlds ? zoneId : 0;
+		if (zoneWorlds.size() <= i) { zoneWorlds.resize(i + 1); }
+
+		auto& zoneWorld = zoneWorlds[i];
+		if (!zoneWorld) { zoneWorld = std::make_unique<ZoneWorld>(*this); }
+		return *zoneWorld;
+	}
+
 
 	void PhysicsSystem::onComponentAdded(const Engine::ECS::Entity ent, PhysicsBodyComponent& comp) {
 		// ENGINE_INFO(" PhysicsSystem - component added to ", ent);
@@ -38,7 +55,8 @@ namespace Game {
 
 	void PhysicsSystem::onComponentRemoved(const Engine::ECS::Entity ent, PhysicsBodyComponent& comp) {
 		// ENGINE_INFO(" PhysicsSystem - component removed from ", ent);
-		physWorld.DestroyBody(comp.takeOwnership());
+		auto* body = comp.takeOwnership();
+		body->GetWorld()->DestroyBody(body);
 	};
 
 	void PhysicsSystem::tick() {
@@ -133,14 +151,57 @@ namespace Game {
 			}
 		}
 
-		physWorld.Step(world.getTickDelta(), 8, 3);
+		if constexpr (ENGINE_DEBUG) {
+			if (useZoneWorlds) {
+				for (ZoneId zoneId = 0; zoneId < zoneWorlds.size(); ++zoneId) {
+					if (!zoneWorlds[zoneId]) { continue; }
+					for (const auto* body = zoneWorlds[zoneId]->GetBodyList(); body; body = body->GetNext()) {
+						const auto* fixture = body->GetFixtureList();
+						if (fixture && fixture->GetFilterData().groupIndex != static_cast<decltype(b2Filter::groupIndex)>(zoneId)) {
+							ENGINE_WARN2("Physics body for {} is in the world for zone {} but is in zone {}. Missing call to updateZoneWorld.", toEntity(fixture), zoneId, fixture->GetFilterData().groupIndex);
+						}
+					}
+				}
+			}
+		}
+
+		stepQueue.clear();
+		for (auto& zoneWorld : zoneWorlds) {
+			if (zoneWorld && zoneWorld->GetBodyCount() > 0) {
+				zoneWorld->buffering = true;
+				stepQueue.push_back(zoneWorld.get());
+			}
+		}
+
+		const auto tickDelta = world.getTickDelta();
+		workers.run(static_cast<int32>(stepQueue.size()), [&](int32 i){
+			stepQueue[i]->Step(tickDelta, 8, 3);
+		});
+
+		// Replay contacts in zone order so listeners see the same order regardless of the thread count.
+		for (auto* zoneWorld : stepQueue) {
+			zoneWorld->buffering = false;
+			for (const auto& event : zoneWorld->contacts) {
+				if (event.begin && consumeMovedContact(event)) { continue; }
+				dispatch(event);
+			}
+			zoneWorld->contacts.clear();
+		}
+
+		// Any moved contacts that didn't begin again in the new world have ended.
+		for (const auto& event : movedContacts) {
+			dispatch(event);
+		}
+		movedContacts.clear();
 	}
 
 	void PhysicsSystem::render(const RenderLayer layer) {
 		#if defined(DEBUG_PHYSICS)
 		if (layer == RenderLayer::PhysicsDebug) {
 			debugDraw.reset();
-			physWorld.DrawDebugData();
+			for (auto& zoneWorld : zoneWorlds) {
+				if (zoneWorld) { zoneWorld->DrawDebugData(); }
+			}
 			debugDraw.draw();
 		}
 		#endif
@@ -168,7 +229,7 @@ namespace Game {
 	}
 
 	PhysicsBody PhysicsSystem::createBody(Engine::ECS::Entity ent, b2BodyDef& bodyDef, ZoneId zoneId) {
-		auto body = physWorld.CreateBody(&bodyDef);
+		auto body = getZoneWorld(zoneId).CreateBody(&bodyDef);
 		static_assert(sizeof(void*) >= sizeof(ent), "Engine::ECS::Entity is to large to store in userdata pointer.");
 		body->SetUserData(reinterpret_cast<void*>(reinterpret_cast<std::uintptr_t&>(ent)));
 
@@ -179,31 +240,116 @@ namespace Game {
 	void PhysicsSystem::destroyBody(PhysicsBody& body) {
 		const auto ptr = body.takeOwnership();
 		ENGINE_DEBUG_ASSERT(ptr != nullptr, "Attempting to destroy null physics body");
-		physWorld.DestroyBody(ptr);
+		ptr->GetWorld()->DestroyBody(ptr);
+	}
+
+	void PhysicsSystem::updateZoneWorld(PhysicsBody& physBody) {
+		if (!useZoneWorlds) { return; }
+
+		auto* body = physBody.body;
+		auto& oldWorld = static_cast<ZoneWorld&>(*body->GetWorld());
+		auto& newWorld = getZoneWorld(physBody.getZoneId());
+		if (&oldWorld == &newWorld) { return; }
+		ENGINE_DEBUG_ASSERT(!oldWorld.IsLocked() && !newWorld.IsLocked(), "Attempting to move a physics body while stepping.");
+
+		b2BodyDef bodyDef;
+		bodyDef.type = body->GetType();
+		bodyDef.position = body->GetPosition();
+		bodyDef.angle = body->GetAngle();
+		bodyDef.linearVelocity = body->GetLinearVelocity();
+		bodyDef.angularVelocity = body->GetAngularVelocity();
+		bodyDef.linearDamping = body->GetLinearDamping();
+		bodyDef.angularDamping = body->GetAngularDamping();
+		bodyDef.allowSleep = body->IsSleepingAllowed();
+		bodyDef.awake = body->IsAwake();
+		bodyDef.fixedRotation = body->IsFixedRotation();
+		bodyDef.bullet = body->IsBullet();
+		bodyDef.active = body->IsActive();
+		bodyDef.userData = body->GetUserData();
+		bodyDef.gravityScale = body->GetGravityScale();
+		auto* moved = newWorld.CreateBody(&bodyDef);
+
+		// Box2D stores fixtures newest first so recreate them in reverse to keep the same order.
+		std::vector<const b2Fixture*> fixtures;
+		for (const auto* fixture = body->GetFixtureList(); fixture; fixture = fixture->GetNext()) {
+			fixtures.push_back(fixture);
+		}
+
+		for (auto it = fixtures.rbegin(); it != fixtures.rend(); ++it) {
+			const auto* fixture = *it;
+			b2FixtureDef fixtureDef;
+			fixtureDef.shape = fixture->GetShape();
+			fixtureDef.userData = fixture->GetUserData();
+			fixtureDef.friction = fixture->GetFriction();
+			fixtureDef.restitution = fixture->GetRestitution();
+			fixtureDef.density = fixture->GetDensity();
+			fixtureDef.isSensor = fixture->IsSensor();
+			fixtureDef.filter = fixture->GetFilterData();
+			moved->CreateFixture(&fixtureDef);
+		}
+
+		// Existing contacts end here and begin again in the new world on the next step. Hold
+		// on to the end events until then so contacts that are still touching don't change.
+		movingBody = true;
+		oldWorld.DestroyBody(body);
+		movingBody = false;
+		physBody.body = moved;
 	}
 
 	void PhysicsSystem::addListener(PhysicsListener* listener) {
 		listeners.push_back(listener);
 	}
 
-	void PhysicsSystem::BeginContact(b2Contact* contact) {
-		const auto entA = toEntity(contact->GetFixtureA()->GetBody()->GetUserData());
-		const auto entB = toEntity(contact->GetFixtureB()->GetBody()->GetUserData());
+	void PhysicsSystem::onContact(b2Contact* contact, bool begin) {
+		auto* bodyA = contact->GetFixtureA()->GetBody();
+		const ContactEvent event = {
+			.entA = toEntity(bodyA->GetUserData()),
+			.entB = toEntity(contact->GetFixtureB()->GetBody()->GetUserData()),
+			.begin = begin,
+		};
 
-		for (auto listener : listeners) {
-			listener->beginContact(entA, entB);
+		if (movingBody) {
+			ENGINE_DEBUG_ASSERT(!begin);
+			movedContacts.push_back(event);
+			return;
+		}
+
+		// Worlds may be stepped on other threads so only touch the world the contact is from.
+		auto& zoneWorld = static_cast<ZoneWorld&>(*bodyA->GetWorld());
+		if (zoneWorld.buffering) {
+			zoneWorld.contacts.push_back(event);
+		} else {
+			dispatch(event);
 		}
 	}
 
-	void PhysicsSystem::EndContact(b2Contact* contact) {
-		const auto entA = toEntity(contact->GetFixtureA()->GetBody()->GetUserData());
-		const auto entB = toEntity(contact->GetFixtureB()->GetBody()->GetUserData());
+	bool PhysicsSystem::consumeMovedContact(const ContactEvent& event) {
+		const auto found = std::ranges::find_if(movedContacts, [&](const ContactEvent& moved){ return moved.samePair(event); });
+		if (found == movedContacts.end()) { return false; }
+		movedContacts.erase(found);
+		return true;
+	}
 
-		for (auto listener : listeners) {
-			listener->endContact(entA, entB);
+	void PhysicsSystem::dispatch(const ContactEvent& event) {
+		if (event.begin) {
+			for (auto listener : listeners) {
+				listener->beginContact(event.entA, event.entB);
+			}
+		} else {
+			for (auto listener : listeners) {
+				listener->endContact(event.entA, event.entB);
+			}
 		}
 	}
 
+	void PhysicsSystem::BeginContact(b2Contact* contact) {
+		onContact(contact, true);
+	}
+
+	void PhysicsSystem::EndContact(b2Contact* contact) {
+		onContact(contact, false);
+	}
+
 	bool PhysicsSystem::ShouldCollide(b2Fixture* fixtureA, b2Fixture* fixtureB) {
 		//   groupIndex = "I only collide with fixtures in this group" (int)
 		// categoryBits = "I'm a ..." (bitset, usually just one bit should be set)
@@ -106,7 +106,7 @@ namespace Game {
 
 		for (const auto& ent : filter) {
 			const glm::vec3 pos = {Engine::Glue::as<glm::vec2>(world.getComponent<Game::PhysicsInterpComponent>(ent).getPosition()), 0.0f};
-			const auto& spriteComp = world.getComponent<Game::SpriteComponent>(ent);
+			const auto& spriteComp = std::as_const(world).getComponent<Game::SpriteComponent>(ent);
 			sprites.push_back({
 				.layer = spriteComp.layer,
 				.texture = spriteComp.texture->tex.get(),
@@ -21,19 +21,8 @@ namespace {
 	using Engine::Net::MessageHeader;
 	using Engine::Net::BufferReader;
 
-	ENGINE_INLINE WorldAbsUnit manhattanDist(const WorldAbsVec& a, const WorldAbsVec& b) noexcept {
-		ENGINE_FLATTEN return glm::compAdd(glm::abs(a - b));
-	}
-
-	// The metric to use for comparing distances.
-	// - Using Euclidean is bad because we need to take a square root.
-	// - Using squared Euclidean is bad because it greatly limits our world size to sqrt(INT_MAX)
-	// - Chebyshev or Manhattan should be fine.
-	// 
-	// I went with Manhattan to have less aggressive merges. Might be a
-	// problem depnding on desired interaction range but I doubt we will
-	// need interactions that far out anyways.
-	constexpr auto metric = manhattanDist;
+	// The metric to use for comparing distances. Must be the same as used for joins.
+	constexpr auto metric = ZoneClusterer::metric;
 }
 
 namespace Game {
@@ -70,184 +59,72 @@ namespace Game {
 			"Unexpectedly high number of zones. This is likely a bug/leak."
 		);
 
-		//
-		// TODO: One option to support higher player counts might be do instead
-		// do something like have each zone track its total radius and then use
-		// that info as a rough broad phase for which zones potentially need
-		// merged or recalculated instead of doing that on a per player basis
-		// always.
-		// 
-		// n = #players
-		// m = #zones
-		// 
-		// Current edge calculations are  n(n-1)/2 = O(n^2)  The proposed method
-		// is approximately  n*m  but it is very likely that  m << n  so in
-		// reality this is probably closer to something like  n^1.3  which
-		// starts paying off around  n=4  and is worst case still only  n^2
-		// plus the overhead for zone management. Probably worth looking into if
-		// this is a perf issue.
-		//
-		// Beyond that we could also distribute either the current or proposed
-		// method across frames assuming some maximum player move speed. We
-		// would need to make sure to account for teleporting between areas
-		// though.
-		//
-
 		// TODO: one problem is our world scale is a bit off. Should probably be more like 6-8 blocks per meter instead of 4/5.
 
-		// TODO: we can probably combine most of these loops once we have the logic figured out.
 		// TODO: look into various clustering algos, k-means, etc.
-		groupRemaps.clear();
 		groupStorage.clear();
 		groupRealms.clear();
-		merged.clear();
-		relations.clear();
 		ZONE_DEBUG("=========================================");
 
-		// TODO: shouldn't need this. Should be assigned when entity created. Change to a if-constexpr-debug check.
+		// The grouping is spread across ticks. Only players that have moved
+		// enough are re-evaluated and splits are handled lazily, both limited by
+		// a budget. Teleports between realms are always handled immediately.
+		// See ZoneClusterer for details.
+		const auto& cvars = Engine::getGlobalConfig().cvars;
+		clusterer.setMoveThreshold(cvars.zone_move_threshold);
+		clusterer.beginUpdate();
+
 		for (const auto ply : playerFilter) {
 			auto& physComp = world.getComponent<PhysicsBodyComponent>(ply);
 			//ENGINE_WARN2("\n\nCheck: {} {}\n", ply, physComp.zone.id);
 
+			// TODO: shouldn't need this. Should be assigned when entity created. Change to a if-constexpr-debug check.
 			if (physComp.zone.id == zoneInvalidId) {
 				ENGINE_WARN2("\n\nAdding to zone: {}\n", ply);
 				physComp.zone.id = 0;
 				zones[0].addPlayer(ply);
 			}
-		}
-
-		{ // Calculate and cache player to player distances
-			auto cur = playerFilter.begin();
-			const auto end = playerFilter.end();
-			for (; cur != end; ++cur) {
-				auto& physComp1 = world.getComponent<PhysicsBodyComponent>(*cur);
-				physComp1.zone.group = -1; // Reset for the next pass
-
-				for (auto next = cur; ++next != end;) {
-					const auto& physComp2 = world.getComponent<PhysicsBodyComponent>(*next);
-					const auto& zone1 = zones[physComp1.zone.id];
-					const auto& zone2 = zones[physComp2.zone.id];
-
-					// TODO: We should really batch relations on a per Realm basis. That
-					//       would make things more efficient since it cuts down the size of N,
-					//       which is big since this is N^2. Although it would probably be even
-					//       better to do some kind of BSP if perf is really our goal here.
-					if (zone1.realmId != zone2.realmId) {
-						// No specified distance = default = max
-						[[maybe_unused]] const auto& rel = relations.emplace_back(*cur, *next);
-						ZONE_DEBUG("Relation between {} and {} = inf", *cur, *next);
-
-						// The distance here should be large enough that it is effectively
-						// infinite. The one hundred factor is an arbitrary "should be big enough"
-						// number, although anything over the split distance should work.
-						ENGINE_DEBUG_ASSERT(rel.dist > 100*zoneMustSplitDist, "Incorrect distance value for players in separate zones.");
-						continue;
-					}
-
-					const auto relPos1 = physComp1.getPosition();
-					const auto relPos2 = physComp2.getPosition();
-					const auto globalPos1 = worldToAbsolute(Engine::Glue::as<WorldVec>(relPos1), zone1.offset);
-					const auto globalPos2 = worldToAbsolute(Engine::Glue::as<WorldVec>(relPos2), zone2.offset);
-					const auto dist = metric(globalPos1, globalPos2);
-					relations.emplace_back(*cur, *next, dist);
-					ZONE_DEBUG("Relation between {} and {} = {}", *cur, *next, dist);
-				}
-			}
 
-			// TODO: if we merge the must join loop into the above then we should be able to remove this step.
-			// Sort to make the distance check logic simpler. Must join, must split, etc. are now all grouped.
-			std::ranges::sort(relations, [](const auto& a, const auto& b){
-				return a.dist < b.dist;
-			});
+			const auto& zone = zones[physComp.zone.id];
+			const auto pos = worldToAbsolute(Engine::Glue::as<WorldVec>(physComp.getPosition()), zone.offset);
+			clusterer.update(ply, zone.realmId, pos);
 		}
 
-		{ // Players that need to be in the same zone.
-			auto cur = relations.begin();
-			const auto end = relations.end();
-
-			// TODO: probably a better scheme for remaps. Need to think a about it a bit.
-			// TODO: could just do this step while calcing distances
-			for (; cur != end; ++cur) {
-				if (cur->dist > zoneMustJoinDist) { break; }
-				auto& physComp1 = world.getComponent<PhysicsBodyComponent>(cur->ply1);
-				auto& physComp2 = world.getComponent<PhysicsBodyComponent>(cur->ply2);
-
-				// TODO: Test if keeping zone avg totals here is faster than doing it later
-
-				if (physComp1.zone.group != -1) { // ply1 is in a group
-					if (physComp2.zone.group != -1) { // Both are in a group
-						if (groupRemaps[physComp1.zone.group] == groupRemaps[physComp2.zone.group]) { continue; }
-						const auto [min, max] = std::minmax(physComp1.zone.group, physComp2.zone.group);
-						ZONE_DEBUG("{} - Merging group {} into {} because of {} and {}", world.getTick(), max, min, cur->ply1, cur->ply2);
-						//ENGINE_DEBUG_ASSERT(physComp1.zone.group != physComp2.zone.group, world.getTick(), " - Attempting to merge group with itself");
-
-						// Merge the larger id group into the smaller id group
-						groupStorage[groupRemaps[min]].append_range(groupStorage[groupRemaps[max]]);
-						groupStorage[groupRemaps[max]].clear();
-
-						physComp1.zone.group = min;
-						physComp2.zone.group = min;
-
-						// Update any groups that reference max
-						for (auto& gid : groupRemaps) {
-							if (gid == max) {
-								const auto original = std::ranges::find(groupRemaps, gid) - groupRemaps.begin();
-								ZONE_DEBUG("    Merge update {} > {} > {}", original, gid, min);
-								gid = min;
-							}
-						}
-					} else { // ONLY ply1 is in a group. Use that group.
-						physComp2.zone.group = physComp1.zone.group;
-						groupStorage[groupRemaps[physComp1.zone.group]].push_back(cur->ply2);
-						ZONE_DEBUG("{} - Adding1 {} to existing group {} with {}", world.getTick(), cur->ply2, physComp2.zone.group, cur->ply1);
-					}
-				} else if (physComp2.zone.group != -1) { // Only ply2 is in a group. Use that group.
-					physComp1.zone.group = physComp2.zone.group;
-					groupStorage[groupRemaps[physComp2.zone.group]].push_back(cur->ply1);
-					ZONE_DEBUG("{} - Adding2 {} to existing group {} with {}", world.getTick(), cur->ply1, physComp2.zone.group, cur->ply2);
-				} else { // Neither is in a group
-					const auto groupId = static_cast<ZoneId>(groupStorage.size());
-					physComp1.zone.group = groupId;
-					physComp2.zone.group = groupId;
-
-					ENGINE_DEBUG_ASSERT(groupStorage.size() == groupRemaps.size());
-
-					groupRemaps.emplace_back(groupId);
-					auto& group = groupStorage.emplace_back();
-					group.push_back(cur->ply1);
-					group.push_back(cur->ply2);
-					ZONE_DEBUG("{} - Creating new group {} for {} and {}", world.getTick(), physComp2.zone.group, cur->ply1, cur->ply2);
+		clusterer.endUpdate();
+		clusterer.process(cvars.zone_update_budget);
+
+		// Players that need to be in the same zone. Players that haven't been
+		// evaluated yet aren't in a group and stay in their current zone.
+		for (const auto& group : clusterer.getGroups()) {
+			if (group.members.size() > 1) {
+				ZONE_DEBUG("{} - Creating new group {}", world.getTick(), groupStorage.size());
+				auto& storage = groupStorage.emplace_back();
+				for (const auto i : group.members) {
+					storage.push_back(clusterer.getPlayer(i).ent);
 				}
+				groupRealms.push_back(clusterer.getPlayer(group.members.front()).realmId);
+				continue;
 			}
-		}
 
-		// Split solo players outside of split range.
-		// - If they are in a group they should be handled already below.
-		// - If they are not in a group and they aren't outside the split range
-		//   then nothing needs to happen so it should be fine.
-		for (const auto ply : playerFilter) {
-			auto& physComp = world.getComponent<PhysicsBodyComponent>(ply);
-			if (physComp.zone.group == -1) {
-				const auto pos = physComp.getPosition();
-				const auto dist = metric({pos.x, pos.y}, {});
-				if (dist > zoneMustSplitDist) {
-					const auto groupId = static_cast<ZoneId>(groupStorage.size());
-					groupRemaps.emplace_back(groupId);
-					groupRealms.emplace_back(zones[physComp.zone.id].realmId); // Same realm as current zone
-					auto& group = groupStorage.emplace_back();
-					group.push_back(ply);
-					physComp.zone.group = groupId;
-					ZONE_DEBUG("{} - Creating new group {} for {}", world.getTick(), groupId, ply);
-				}
+			if (group.members.empty()) { continue; }
+
+			// Split solo players outside of split range. If they aren't outside the
+			// split range then nothing needs to happen.
+			const auto& ply = clusterer.getPlayer(group.members.front());
+			const auto pos = world.getComponent<PhysicsBodyComponent>(ply.ent).getPosition();
+			const auto dist = metric({pos.x, pos.y}, {});
+			if (dist > zoneMustSplitDist) {
+				ZONE_DEBUG("{} - Creating new group {} for {}", world.getTick(), groupStorage.size(), ply.ent);
+				groupStorage.emplace_back().push_back(ply.ent);
+				groupRealms.push_back(ply.realmId); // Same realm as current zone
 			}
 		}
 
 		ENGINE_DEBUG_ASSERT(groupStorage.size() == groupRealms.size());
 
 		// Create zones and shift entities.
-		for (const auto& groupStorageId : groupRemaps) {
-			const auto& group = groupStorage[groupStorageId];
-			if (group.empty()) { continue; }
+		for (int32 groupId = 0; groupId < std::ssize(groupStorage); ++groupId) {
+			const auto& group = groupStorage[groupId];
 
 			// Figure out ideal zone origin.
 			// TODO: Potential overflow with `ideal` (avg) position here? This would break/overflow with large values.
@@ -276,7 +153,7 @@ namespace Game {
 
 			// No existing zone is close enough to use.
 			if (zoneId == -1) {
-				const auto realmId = groupRealms[groupStorageId];
+				const auto realmId = groupRealms[groupId];
 				zoneId = createNewZone(realmId, ideal);
 				ZONE_DEBUG("{} - Creating new zone: realm={}, zone={}, offset={}", world.getTick(), realmId, zoneId, zones[zoneId].offset);
 			} else {
@@ -294,6 +171,15 @@ namespace Game {
 				migratePlayer(ply, zoneId, physComp);
 			}
 		}
+
+		// Done after all merges and splits so bodies that changed zones more than once, such as
+		// neighbors shared by multiple players, are only moved between physics worlds once.
+		auto& physSys = world.getSystem<PhysicsSystem>();
+		for (const auto ent : migrated) {
+			if (!world.isAlive(ent) || !world.hasComponent<PhysicsBodyComponent>(ent)) { continue; }
+			physSys.updateZoneWorld(world.getComponent<PhysicsBodyComponent>(ent));
+		}
+		migrated.clear();
 	}
 	#endif // ENGINE_SERVER
 
@@ -411,7 +297,7 @@ namespace Game {
 		oldZone.removePlayer(ply);
 		newZone.addPlayer(ply);
 
-		migrateEntity(newZoneId, newPos, physComp);
+		migrateEntity(ply, newZoneId, newPos, physComp);
 
 		if constexpr (ENGINE_SERVER) {
 			// Mark entities for network zone updates.
@@ -455,12 +341,13 @@ namespace Game {
 
 		const auto zoneOffsetDiff = static_cast<WorldVec>(newZone.offset - oldZone.offset);
 		const auto oldPos = Engine::Glue::as<WorldVec>(physComp.getPosition());
-		migrateEntity(newZoneId, oldPos - zoneOffsetDiff, physComp);
+		migrateEntity(ent, newZoneId, oldPos - zoneOffsetDiff, physComp);
 	}
 
-	void ZoneManagementSystem::migrateEntity(const ZoneId newZoneId, const WorldVec newPos, PhysicsBodyComponent& physComp) {
+	void ZoneManagementSystem::migrateEntity(const Engine::ECS::Entity ent, const ZoneId newZoneId, const WorldVec newPos, PhysicsBodyComponent& physComp) {
 		physComp.setPosition({newPos.x, newPos.y});
 		physComp.setZone(newZoneId);
+		ENGINE_SERVER_ONLY(migrated.push_back(ent));
 	}
 	
 	#if ENGINE_SERVER
@@ -29,6 +29,7 @@
 #include <Game/UI/ConsoleWindow.hpp>
 #include <Game/UI/MapPreview.hpp>
 #include <Game/GameSink.hpp>
+#include <Game/LoadTest.hpp>
 
 // FMT
 #include <fmt/xchar.h>
@@ -716,6 +717,23 @@ void run(int argc, char* argv[]) {
 		windowCallbacks
 	};
 	
+	////////////////////////////////////////////////////////////////////////////////////////////////
+	// Load test
+	////////////////////////////////////////////////////////////////////////////////////////////////
+	// Must be before the engine so the server socket is created on the loopback network.
+	//
+	// Only the bots are headless. EngineInstance owns the textures, shaders
+	// and UI so the server still needs the window and OpenGL context created
+	// above. This is a tool for manually profiling a server under load, not
+	// an unattended CI runner. Running without a window would require
+	// splitting the graphics resources out of EngineInstance first.
+	std::unique_ptr<Game::LoadTest> loadTest;
+	if (ENGINE_SERVER && Engine::getGlobalConfig().bots) {
+		loadTest = std::make_unique<Game::LoadTest>(Engine::getGlobalConfig().bots);
+		Engine::getGlobalConfig<true>().loopback = &loadTest->getNetwork();
+		ENGINE_LOG2("Running load test with {} bots", Engine::getGlobalConfig().bots);
+	}
+
 	////////////////////////////////////////////////////////////////////////////////////////////////
 	// Engine
 	////////////////////////////////////////////////////////////////////////////////////////////////
@@ -845,7 +863,12 @@ void run(int argc, char* argv[]) {
 		glClear(GL_COLOR_BUFFER_BIT);
 
 		// ECS
+		const auto runStart = Engine::Clock::now();
 		world.run();
+
+		if (loadTest) {
+			loadTest->update(world, Engine::Clock::now() - runStart);
+		}
 		
 		// Frame rate
 		deltas[deltaIndex] = world.getDeltaTime();
@@ -907,6 +930,12 @@ int entry(int argc, char* argv[]) {
 				"The port to listen on.")
 			.add<IPv4Address>("group", 'g', {224,0,0,212, 12121},
 				"The multicast group to join for server discovery. Zero to disable.")
+			.add<uint16>("bots", 'b', 0,
+				"Server only. The number of headless bots to run against the server over an in-process loopback network. The server itself still needs a window and OpenGL context.")
+			.add<std::string>("capture", "",
+				"Write all received game packets to the given file.")
+			.add<std::string>("replay", "",
+				"Replay the game packets from the given capture file instead of using the network.")
 			.add<std::string>("log", 'l', "",
 				"The file to use for logging.")
 			.add<bool>("logColor",
@@ -985,6 +1014,15 @@ int entry(int argc, char* argv[]) {
 
 			const auto* group = parser.get<Engine::Net::IPv4Address>("group");
 			if (group) { cfg.group = *group; }
+
+			const auto* bots = parser.get<uint16>("bots");
+			if (bots) { cfg.bots = *bots; }
+
+			const auto* capture = parser.get<std::string>("capture");
+			if (capture) { cfg.capture = *capture; }
+
+			const auto* replay = parser.get<std::string>("replay");
+			if (replay) { cfg.replay = *replay; }
 		}
 
 		{ // Setup logger
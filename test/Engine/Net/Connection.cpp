@@ -0,0 +1,421 @@
+// STD
+#include <algorithm>
+#include <limits>
+#include <random>
+#include <thread>
+#include <vector>
+
+// Google Test
+#include <gtest/gtest.h>
+
+// Engine
+#include <Engine/Net/Connection.hpp>
+
+namespace Engine::Net {
+	namespace {
+		const MessageMetaInfo testMessageInfo = {
+			.dir = MessageDirection::Bidirectional,
+			.sendState = 1,
+			.recvState = 1,
+			.name = "TEST",
+		};
+	}
+
+	template<> const MessageMetaInfo& getMessageMetaInfo<0>() { return testMessageInfo; }
+	template<> const MessageMetaInfo& getMessageMetaInfo<1>() { return testMessageInfo; }
+	template<> const MessageMetaInfo& getMessageMetaInfo<2>() { return testMessageInfo; }
+	template<> const MessageMetaInfo& getMessageMetaInfo<3>() { return testMessageInfo; }
+}
+
+namespace {
+	using namespace Engine::Net;
+	// Message type zero is reserved for no message but must still be handled by a channel.
+	using TestConnection = Connection<Channel_UnreliableUnordered<0, 1>, Channel_ReliableOrdered<2>>;
+
+	/** Collects queued packets so they can be delivered, or dropped, by the test. */
+	class TestSink {
+		public:
+			std::vector<std::vector<byte>> queued;
+
+			void queue(const void* data, int32 size, const IPv4Address&) {
+				const auto* bytes = static_cast<const byte*>(data);
+				queued.emplace_back(bytes, bytes + size);
+			}
+	};
+
+	class Peer {
+		public:
+			TestConnection conn;
+			TestSink sink;
+			uint32 nextUnreliable = 0;
+			uint32 nextReliable = 0;
+			uint32 unreliableRecv = 0;
+			uint32 reliableRecv = 0;
+			bool reliableInOrder = true;
+
+			Peer(IPv4Address addr) : conn{addr, Engine::Clock::now()} {
+				conn.setState(1);
+				conn.setPacketSendRate(1'000'000.0f);
+			}
+
+			void write(bool reliable) {
+				if (auto msg = conn.beginMessage<1>()) {
+					msg.write(nextUnreliable++);
+				}
+
+				if (reliable) {
+					if (auto msg = conn.beginMessage<2>()) {
+						msg.write(nextReliable++);
+					}
+				}
+			}
+
+			void deliver(Peer& to, std::mt19937& rng, float32 loss) {
+				conn.send(sink);
+				for (const auto& data : sink.queued) {
+					if (std::uniform_real_distribution<float32>{}(rng) < loss) { continue; }
+
+					Packet pkt;
+					memcpy(&pkt, data.data(), data.size());
+					if (!to.conn.recv(pkt, static_cast<int32>(data.size()), Engine::Clock::now())) { continue; }
+
+					while (true) {
+						auto [hdr, msg] = to.conn.recvNext();
+						if (hdr.type == 0) { break; }
+
+						uint32 value = 0;
+						msg.read(&value);
+						if (hdr.type == 1) {
+							++to.unreliableRecv;
+						} else if (hdr.type == 2) {
+							to.reliableInOrder = to.reliableInOrder && value == to.reliableRecv;
+							++to.reliableRecv;
+						}
+					}
+				}
+				sink.queued.clear();
+			}
+	};
+
+	constexpr LargeChannelConfig testLargeConfig = {
+		.maxBlobs = 8,
+		.window = 64,
+		.fragmentSize = 256,
+		.bandwidthPercent = 100,
+	};
+	using TestLargeChannel = Channel_LargeReliableOrdered<testLargeConfig, 3>;
+	using TestLargeConnection = Connection<Channel_UnreliableUnordered<0, 1, 2>, TestLargeChannel>;
+
+	/** The size of the payload after the blob id. Varies so blobs have a mix of fragment counts, including partial and single fragments. */
+	int32 blobPayloadSize(uint32 id) {
+		return static_cast<int32>((id * 7919) % (testLargeConfig.fragmentSize * 12));
+	}
+
+	byte blobByte(uint32 id, int32 i) {
+		return static_cast<byte>(id * 31 + i * 7);
+	}
+
+	class LargePeer {
+		public:
+			TestLargeConnection conn;
+			TestSink sink;
+			uint32 nextBlob = 0;
+			uint32 blobsRecv = 0;
+			bool blobsValid = true;
+
+			LargePeer(IPv4Address addr) : conn{addr, Engine::Clock::now()} {
+				conn.setState(1);
+				conn.setPacketSendRate(1'000'000.0f);
+			}
+
+			void write(uint32 blobCount) {
+				// Acks are only sent with other messages. Always have something to send like a real connection would.
+				if (auto msg = conn.beginMessage<1>()) {
+					msg.write(uint32{0});
+				}
+
+				// Fails while maxBlobs are still being sent. Try again next time.
+				if (nextBlob == blobCount) { return; }
+				if (auto msg = conn.beginMessage<3>()) {
+					const auto id = nextBlob++;
+					msg.write(id);
+
+					const auto size = blobPayloadSize(id);
+					std::vector<byte> data(size);
+					for (int32 i = 0; i < size; ++i) { data[i] = blobByte(id, i); }
+					if (size > 0) { msg.write(data.data(), data.size()); }
+				}
+			}
+
+			/** Delivers queued packets to @p to with loss, duplication and reordering. */
+			void deliver(LargePeer& to, std::mt19937& rng, float32 loss) {
+				conn.send(sink);
+				auto& queued = sink.queued;
+
+				std::uniform_real_distribution<float32> dist{};
+				for (int32 i = 1; i < std::ssize(queued); ++i) {
+					if (dist(rng) < 0.3f) { std::swap(queued[i - 1], queued[i]); }
+				}
+
+				for (int32 i = 0; i < std::ssize(queued); ++i) {
+					if (dist(rng) < loss) { continue; }
+					if (dist(rng) < 0.05f) { to.recv(queued[i]); }
+					to.recv(queued[i]);
+				}
+				queued.clear();
+			}
+
+			void recv(const std::vector<byte>& data) {
+				Packet pkt;
+				memcpy(&pkt, data.data(), data.size());
+				if (!conn.recv(pkt, static_cast<int32>(data.size()), Engine::Clock::now())) { return; }
+
+				while (true) {
+					auto [hdr, msg] = conn.recvNext();
+					if (hdr.type == 0) { break; }
+					if (hdr.type != 3) { continue; }
+
+					uint32 id = 0;
+					const auto size = blobPayloadSize(blobsRecv);
+					bool valid = msg.read(&id) && id == blobsRecv && static_cast<int32>(msg.remaining()) == size;
+					if (valid && size > 0) {
+						const auto* data = msg.read(size);
+						for (int32 i = 0; valid && i < size; ++i) {
+							valid = data[i] == blobByte(id, i);
+						}
+					}
+
+					blobsValid = blobsValid && valid;
+					++blobsRecv;
+				}
+			}
+	};
+
+	TEST(Engine_Net_Connection, HeaderRoundTrip) {
+		alignas(8) byte storage[sizeof(Packet) + 1];
+
+		// Use an odd address so any unaligned access in the accessors would be caught by UBSan.
+		auto& pkt = *new (storage + 1) Packet{};
+		pkt.setProtocol(protocol);
+		pkt.setVersion(Packet::version);
+		pkt.setFlags(PacketFlag::Compressed);
+		pkt.setSeqNum(65535);
+		pkt.setNextAck(12345);
+		pkt.setKey(0xFEDC4321);
+
+		AckBitset acks;
+		acks.set(0);
+		acks.set(63);
+		acks.set(64);
+		acks.set(200);
+
+		const auto bodySize = pkt.writeAcks(acks, Packet::maxAckWords, 10);
+		ASSERT_EQ(bodySize, 10 + (Packet::maxAckWords - 1) * 8);
+
+		ASSERT_EQ(pkt.getProtocol(), protocol);
+		ASSERT_EQ(pkt.getVersion(), Packet::version);
+		ASSERT_EQ(pkt.getFlags(), PacketFlag::Compressed);
+		ASSERT_EQ(pkt.getSeqNum(), 65535);
+		ASSERT_EQ(pkt.getNextAck(), 12345);
+		ASSERT_EQ(pkt.getKey(), 0xFEDC4321);
+		ASSERT_EQ(pkt.getAckWordCount(), Packet::maxAckWords);
+
+		AckBitset read;
+		ASSERT_EQ(pkt.readAcks(read, bodySize), 10);
+		ASSERT_EQ(read, acks);
+
+		// Only the first word.
+		ASSERT_EQ(pkt.writeAcks(acks, 1, 10), 10);
+		ASSERT_EQ(pkt.readAcks(read, 10), 10);
+		ASSERT_TRUE(read.test(0));
+		ASSERT_TRUE(read.test(63));
+		ASSERT_FALSE(read.test(64));
+		ASSERT_FALSE(read.test(200));
+
+		// Not enough body for the extra words.
+		pkt.writeAcks(acks, 2, 0);
+		ASSERT_EQ(pkt.readAcks(read, 4), -1);
+	}
+
+	TEST(Engine_Net_Connection, SequenceWrap) {
+		std::mt19937 rng{1234};
+		Peer a{{127, 0, 0, 1, 2}};
+		Peer b{{127, 0, 0, 1, 1}};
+
+		// Enough packets for the sequence numbers to wrap twice.
+		constexpr int32 iterations = 2 * 65536 + 4096;
+		constexpr float32 loss = 0.1f;
+		for (int32 i = 0; i < iterations; ++i) {
+			a.write(i % 4 == 0);
+			b.write(i % 4 == 2);
+			a.deliver(b, rng, loss);
+			b.deliver(a, rng, loss);
+		}
+
+		// Let any lost reliable messages be resent.
+		const auto stop = Engine::Clock::now() + std::chrono::seconds{10};
+		while ((a.reliableRecv != b.nextReliable || b.reliableRecv != a.nextReliable) && Engine::Clock::now() < stop) {
+			a.write(false);
+			b.write(false);
+			a.deliver(b, rng, loss);
+			b.deliver(a, rng, loss);
+		}
+
+		for (const auto* peer : {&a, &b}) {
+			const auto& other = peer == &a ? b : a;
+			EXPECT_GT(peer->unreliableRecv, other.nextUnreliable * (1 - loss) * 0.9f);
+			EXPECT_GT(other.nextReliable, 0u);
+			EXPECT_EQ(peer->reliableRecv, other.nextReliable);
+			EXPECT_TRUE(peer->reliableInOrder);
+
+			// If acks stopped working after wrapping every packet would look lost.
+			EXPECT_LT(peer->conn.getLoss(), loss * 2);
+		}
+	}
+
+	TEST(Engine_Net_Connection, LargeBlobLossReorder) {
+		std::mt19937 rng{4321};
+		LargePeer a{{127, 0, 0, 1, 2}};
+		LargePeer b{{127, 0, 0, 1, 1}};
+
+		constexpr uint32 blobCount = 2000;
+		constexpr float32 loss = 0.1f;
+
+		const auto stop = Engine::Clock::now() + std::chrono::seconds{60};
+		while ((b.blobsRecv < blobCount || a.blobsRecv < blobCount) && Engine::Clock::now() < stop) {
+			a.write(blobCount);
+			b.write(blobCount);
+			a.deliver(b, rng, loss);
+			b.deliver(a, rng, loss);
+		}
+
+		for (const auto* peer : {&a, &b}) {
+			EXPECT_EQ(peer->blobsRecv, blobCount);
+			EXPECT_TRUE(peer->blobsValid);
+		}
+	}
+
+	TEST(Engine_Net_Connection, LargeBlobInvalidSize) {
+		TestLargeChannel channel;
+
+		// A full first fragment so only the size is invalid.
+		struct {
+			int32 blobSize;
+			int32 index;
+			byte data[testLargeConfig.fragmentSize];
+		} frag = {};
+
+		const MessageHeader hdr = {.type = 3, .size = sizeof(frag), .seq = 0};
+		for (const int32 blobSize : {-1, std::numeric_limits<int32>::min(), std::numeric_limits<int32>::max(), std::numeric_limits<int32>::max() - 10}) {
+			frag.blobSize = blobSize;
+			ASSERT_FALSE(channel.recv(hdr, {&frag, static_cast<int64>(sizeof(frag))}));
+			ASSERT_EQ(channel.recvNext(), nullptr);
+		}
+
+		// A valid blob is still delivered afterwards.
+		frag.blobSize = testLargeConfig.fragmentSize;
+		channel.recv(hdr, {&frag, static_cast<int64>(sizeof(frag))});
+		ASSERT_NE(channel.recvNext(), nullptr);
+	}
+
+	TEST(Engine_Net_Connection, ReliableSendable) {
+		Channel_ReliableOrdered<2> channel;
+		channel.setRetransmitTimeout(std::chrono::seconds{60});
+
+		if (auto msg = channel.beginMessage(channel, 2)) {
+			msg.write(uint32{1234});
+		}
+		ASSERT_EQ(channel.getQueueSize(), 1);
+		ASSERT_EQ(channel.getSendableSize(), sizeof(MessageHeader) + sizeof(uint32));
+
+		// Waiting on an ack isn't sendable so the channel doesn't compete for packet space.
+		byte data[sizeof(Packet::body)];
+		StaticBufferWriter buff{data};
+		channel.fill(0, buff);
+		ASSERT_EQ(channel.getQueueSize(), 1);
+		ASSERT_EQ(channel.getSendableSize(), 0);
+
+		channel.recvPacketAck(0);
+		ASSERT_EQ(channel.getQueueSize(), 0);
+		ASSERT_EQ(channel.getSendableSize(), 0);
+	}
+
+	TEST(Engine_Net_Connection, ReliableResendShare) {
+		Channel_ReliableOrdered<2> channel;
+		channel.setRetransmitTimeout({});
+
+		constexpr int32 payload = 100;
+		constexpr int32 msgSize = sizeof(MessageHeader) + payload;
+		const auto write = [&](int32 count){
+			for (int32 i = 0; i < count; ++i) {
+				if (auto msg = channel.beginMessage(channel, 2)) {
+					byte data[payload] = {};
+					msg.write(data, payload);
+				}
+			}
+		};
+
+		// Enough to fill a whole packet.
+		constexpr int32 count = sizeof(Packet::body) / msgSize;
+		byte data[sizeof(Packet::body)];
+		write(count);
+		{
+			StaticBufferWriter buff{data};
+			channel.fill(0, buff);
+			ASSERT_EQ(buff.size(), count * msgSize);
+		}
+
+		// Everything is due for a resend. Fill the next packet in small parts like Connection::fillPacket
+		// can. Each part is too small for a resend on its own but the share should carry across parts.
+		write(count);
+		constexpr int32 partSize = msgSize + msgSize / 2;
+		int32 resent = 0;
+		int32 used = 0;
+		while (used + partSize <= static_cast<int32>(sizeof(data))) {
+			StaticBufferWriter buff{data + used, partSize};
+			channel.fill(1, buff);
+			for (int32 off = 0; off < buff.size(); off += msgSize) {
+				resent += reinterpret_cast<const MessageHeader*>(buff.data() + off)->seq < count;
+			}
+			used += partSize;
+		}
+
+		EXPECT_GT(resent, 0);
+		EXPECT_LE(resent * msgSize, used / 2);
+	}
+
+	TEST(Engine_Net_Connection, LargeBlobLossBackoff) {
+		TestLargeChannel channel;
+		channel.setSendBandwidth(1'000'000.0f);
+		channel.setRetransmitTimeout(std::chrono::milliseconds{10});
+
+		byte data[sizeof(Packet::body)];
+		{
+			StaticBufferWriter buff{data};
+			auto msg = channel.beginMessage(channel, 3, buff);
+			ASSERT_TRUE(msg);
+			std::vector<byte> blob(testLargeConfig.fragmentSize * testLargeConfig.window * 2);
+			msg.write(blob.data(), blob.size());
+			channel.endMessage(msg.getBufferWriter());
+		}
+
+		// Nothing is ever acked. Without backoff and ack based pacing every fragment in the window
+		// would be resent each retransmission timeout, up to the full bandwidth.
+		SeqNum seq = 0;
+		int64 firstSent = 0;
+		int64 lastSent = 0;
+		const auto start = Engine::Clock::now();
+		while (true) {
+			const auto elapsed = Engine::Clock::now() - start;
+			if (elapsed >= std::chrono::milliseconds{600}) { break; }
+
+			StaticBufferWriter buff{data};
+			channel.fill(seq++, buff);
+			(elapsed < std::chrono::milliseconds{400} ? firstSent : lastSent) += buff.size();
+			std::this_thread::sleep_for(std::chrono::milliseconds{1});
+		}
+
+		EXPECT_GE(firstSent, testLargeConfig.window * testLargeConfig.fragmentSize);
+		EXPECT_LT(lastSent, 16 * testLargeConfig.fragmentSize);
+	}
+}
@@ -0,0 +1,66 @@
+// Google Test
+#include <gtest/gtest.h>
+
+// Engine
+#include <Engine/Net/Delta.hpp>
+
+namespace {
+	using namespace Engine::Net;
+
+	struct State {
+		int32 a;
+		float32 b;
+		uint8 c;
+
+		bool operator==(const State&) const = default;
+	};
+
+	using StateDelta = Delta<&State::a, &State::b, &State::c>;
+
+	static_assert(StateDelta::bit<&State::a>() == 1 << 0);
+	static_assert(StateDelta::bit<&State::b>() == 1 << 1);
+	static_assert(StateDelta::bit<&State::c>() == 1 << 2);
+
+	TEST(Engine_Net_Delta, RoundTrip) {
+		byte data[64];
+		const State first = {.a = 1, .b = 2.0f, .c = 3};
+
+		// No previous state, every field is written.
+		{
+			StaticBufferWriter buff{data};
+			ASSERT_EQ(StateDelta::write(first, nullptr, buff), 0b111);
+			ASSERT_EQ(buff.size(), 1 + 4 + 4 + 1);
+
+			State read = {};
+			StateDelta::Mask fields;
+			BufferReader reader{buff.data(), buff.size()};
+			ASSERT_TRUE(StateDelta::read(read, fields, reader));
+			ASSERT_EQ(fields, 0b111);
+			ASSERT_EQ(read, first);
+			ASSERT_EQ(reader.remaining(), 0);
+		}
+
+		// Only the changed field is written and only it is changed when read.
+		{
+			const State second = {.a = 1, .b = 7.5f, .c = 3};
+			StaticBufferWriter buff{data};
+			ASSERT_EQ(StateDelta::write(second, &first, buff), StateDelta::bit<&State::b>());
+			ASSERT_EQ(buff.size(), 1 + 4);
+
+			State read = {.a = -1, .b = 0.0f, .c = 9};
+			StateDelta::Mask fields;
+			BufferReader reader{buff.data(), buff.size()};
+			ASSERT_TRUE(StateDelta::read(read, fields, reader));
+			ASSERT_EQ(fields, StateDelta::bit<&State::b>());
+			ASSERT_EQ(read, (State{.a = -1, .b = 7.5f, .c = 9}));
+			ASSERT_EQ(reader.remaining(), 0);
+		}
+
+		// Nothing changed, only the mask is written.
+		{
+			StaticBufferWriter buff{data};
+			ASSERT_EQ(StateDelta::write(first, &first, buff), 0);
+			ASSERT_EQ(buff.size(), 1);
+		}
+	}
+}
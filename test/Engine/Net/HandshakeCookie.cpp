@@ -0,0 +1,29 @@
+// Google Test
+#include <gtest/gtest.h>
+
+// Engine
+#include <Engine/Net/HandshakeCookie.hpp>
+
+namespace {
+	using namespace Engine::Net;
+
+	TEST(Engine_Net_HandshakeCookie, Verify) {
+		const HandshakeCookie cookies{0x0123456789ABCDEF, 0xFEDCBA9876543210};
+		const IPv4Address addr = {192, 168, 0, 10, 21212};
+		constexpr uint32 key = 0x00051234;
+		const auto time = HandshakeCookie::period * 10;
+		const auto cookie = cookies.make(addr, key, time);
+
+		ASSERT_TRUE(cookies.verify(cookie, addr, key, time));
+		ASSERT_TRUE(cookies.verify(cookie, addr, key, time + HandshakeCookie::period));
+		ASSERT_FALSE(cookies.verify(cookie, addr, key, time + HandshakeCookie::period * 2));
+
+		ASSERT_FALSE(cookies.verify(cookie, addr, key + 1, time));
+		ASSERT_FALSE(cookies.verify(cookie, {192, 168, 0, 11, 21212}, key, time));
+		ASSERT_FALSE(cookies.verify(cookie, {192, 168, 0, 10, 21213}, key, time));
+
+		// A different secret gives different cookies.
+		const HandshakeCookie other{1, 2};
+		ASSERT_FALSE(other.verify(cookie, addr, key, time));
+	}
+}
@@ -0,0 +1,97 @@
+// STD
+#include <thread>
+
+// Google Test
+#include <gtest/gtest.h>
+
+// Engine
+#include <Engine/Net/LoopbackNetwork.hpp>
+#include <Engine/Net/UDPSocket.hpp>
+
+namespace {
+	using namespace Engine::Net;
+
+	TEST(Engine_Net_LoopbackNetwork, SendRecv) {
+		LoopbackNetwork net;
+		const auto a = net.bind(1000);
+		const auto b = net.bind(0);
+		ASSERT_EQ(a, 1000);
+		ASSERT_NE(b, 0);
+		ASSERT_NE(b, a);
+		ASSERT_EQ(net.bind(1000), 0);
+
+		const int32 data[] = {1, 2, 3};
+		ASSERT_TRUE(net.send(a, LoopbackNetwork::address(b), data, sizeof(data)));
+		ASSERT_TRUE(net.send(a, LoopbackNetwork::address(b), data, sizeof(int32)));
+		ASSERT_FALSE(net.send(a, LoopbackNetwork::address(5), data, sizeof(data)));
+		ASSERT_FALSE(net.send(a, IPv4Address{10, 0, 0, 1, b}, data, sizeof(data)));
+
+		int32 out[3] = {};
+		IPv4Address from;
+		ASSERT_EQ(net.recv(b, out, sizeof(out), from), sizeof(data));
+		ASSERT_EQ(from, LoopbackNetwork::address(a));
+		ASSERT_EQ(out[2], 3);
+
+		ASSERT_EQ(net.recv(b, out, sizeof(out), from), sizeof(int32));
+		ASSERT_EQ(net.recv(b, out, sizeof(out), from), -1);
+
+		// Truncated like a real datagram socket.
+		ASSERT_TRUE(net.send(a, LoopbackNetwork::address(b), data, sizeof(data)));
+		ASSERT_EQ(net.recv(b, out, sizeof(int32), from), sizeof(int32));
+		ASSERT_EQ(net.recv(b, out, sizeof(out), from), -1);
+
+		net.unbind(b);
+		ASSERT_FALSE(net.send(a, LoopbackNetwork::address(b), data, sizeof(data)));
+	}
+
+	TEST(Engine_Net_LoopbackNetwork, QueueLimit) {
+		LoopbackNetwork net;
+		const auto a = net.bind(0);
+		const byte data = 7;
+		for (uintz i = 0; i < LoopbackNetwork::maxQueued; ++i) {
+			ASSERT_TRUE(net.send(a, LoopbackNetwork::address(a), &data, 1));
+		}
+		ASSERT_FALSE(net.send(a, LoopbackNetwork::address(a), &data, 1));
+	}
+
+	TEST(Engine_Net_LoopbackNetwork, Wait) {
+		LoopbackNetwork net;
+		const auto a = net.bind(0);
+		const auto b = net.bind(0);
+		ASSERT_FALSE(net.wait(b, std::chrono::milliseconds{1}));
+
+		std::jthread thread{[&]{
+			std::this_thread::sleep_for(std::chrono::milliseconds{10});
+			const byte data = 1;
+			net.send(a, LoopbackNetwork::address(b), &data, 1);
+		}};
+
+		ASSERT_TRUE(net.wait(b, std::chrono::seconds{5}));
+	}
+
+	TEST(Engine_Net_LoopbackNetwork, Socket) {
+		LoopbackNetwork net;
+		UDPSocket a{net, 0};
+		UDPSocket b{net, 0};
+		ASSERT_TRUE(a.isLoopback());
+		ASSERT_EQ(a.getAddress().a, 127);
+
+		int32 value = 42;
+		a.queue(&value, sizeof(value), b.getAddress());
+		a.queue(&value, sizeof(value), b.getAddress());
+		a.flush();
+
+		int32 out[2] = {};
+		Datagram dgrams[4] = {};
+		for (auto& d : dgrams) { d = {.data = &out, .size = sizeof(out)}; }
+		ASSERT_EQ(b.recvBatch(dgrams), 2);
+		ASSERT_EQ(dgrams[1].size, sizeof(value));
+		ASSERT_EQ(dgrams[1].address, a.getAddress());
+		ASSERT_EQ(out[0], 42);
+
+		// Unbound on destruction.
+		const auto port = b.getAddress().port;
+		{ UDPSocket moved = std::move(b); }
+		ASSERT_EQ(net.bind(port), port);
+	}
+}
@@ -0,0 +1,60 @@
+// STD
+#include <vector>
+
+// Google Test
+#include <gtest/gtest.h>
+
+// Engine
+#include <Engine/Net/PacketAssembler.hpp>
+
+namespace {
+	using namespace Engine::Net;
+
+	class TestSink {
+		public:
+			std::vector<std::vector<byte>> queued;
+			std::vector<IPv4Address> addresses;
+
+			void queue(const void* data, int32 size, const IPv4Address& addr) {
+				const auto* bytes = static_cast<const byte*>(data);
+				queued.emplace_back(bytes, bytes + size);
+				addresses.push_back(addr);
+			}
+	};
+
+	/** Each job queues a different number of datagrams so any ordering issues are visible. */
+	void writeJob(int32 i, auto& sink) {
+		for (int32 n = 0; n <= i % 3; ++n) {
+			const byte data[] = {static_cast<byte>(i), static_cast<byte>(n), static_cast<byte>(i >> 8)};
+			sink.queue(data, 1 + n, {127, 0, 0, 1, static_cast<uint16>(i)});
+		}
+	}
+
+	TEST(Engine_Net_PacketAssembler, MatchesSerial) {
+		constexpr int32 count = 1000;
+
+		TestSink expected;
+		for (int32 i = 0; i < count; ++i) { writeJob(i, expected); }
+
+		for (const int32 threads : {0, 1, 4}) {
+			PacketAssembler assembler{threads};
+			ASSERT_EQ(assembler.getThreadCount(), threads);
+
+			// Run multiple times to make sure the sinks are reset.
+			for (int32 run = 0; run < 3; ++run) {
+				assembler.assemble(count, [](int32 i, PacketAssembler::Sink& sink){ writeJob(i, sink); });
+
+				TestSink actual;
+				assembler.flush(actual);
+				ASSERT_EQ(actual.queued, expected.queued);
+				ASSERT_EQ(actual.addresses, expected.addresses);
+			}
+
+			// Fewer jobs than last time.
+			assembler.assemble(1, [](int32 i, PacketAssembler::Sink& sink){ writeJob(i, sink); });
+			TestSink actual;
+			assembler.flush(actual);
+			ASSERT_EQ(actual.queued.size(), 1);
+		}
+	}
+}
@@ -0,0 +1,84 @@
+// STD
+#include <cstdio>
+#include <filesystem>
+
+// Google Test
+#include <gtest/gtest.h>
+
+// Engine
+#include <Engine/Net/PacketCapture.hpp>
+
+namespace {
+	using namespace Engine::Net;
+
+	TEST(Engine_Net_PacketCapture, RoundTrip) {
+		const auto path = (std::filesystem::temp_directory_path() / "Engine_Net_PacketCapture_RoundTrip.cap").string();
+		const auto start = Engine::Clock::now();
+		const IPv4Address addrA = {127, 0, 0, 1, 1234};
+		const IPv4Address addrB = {10, 0, 0, 2, 4321};
+		const byte dataA[] = {1, 2, 3, 4, 5};
+		const byte dataB[] = {6, 7};
+
+		{
+			PacketCapture capture{path, 0x0123456789ABCDEF};
+			ASSERT_TRUE(capture.isOpen());
+
+			capture.frame(start);
+			capture.datagram(start, addrA, dataA);
+			capture.datagram(start + std::chrono::milliseconds{1}, addrB, dataB);
+
+			// Empty frame.
+			capture.frame(start + std::chrono::milliseconds{10});
+
+			capture.frame(start + std::chrono::milliseconds{20});
+			capture.datagram(start + std::chrono::milliseconds{25}, addrB, dataA);
+		}
+
+		PacketReplay replay{path};
+		ASSERT_TRUE(replay.isOpen());
+		ASSERT_EQ(replay.getSeed(), 0x0123456789ABCDEF);
+
+		ASSERT_TRUE(replay.next());
+		auto frame = replay.getFrame();
+		ASSERT_EQ(frame.size(), 2);
+		ASSERT_EQ(frame[0].time, Engine::Clock::Duration{});
+		ASSERT_EQ(frame[0].address, addrA);
+		ASSERT_TRUE(std::ranges::equal(frame[0].data, dataA));
+		ASSERT_EQ(frame[1].time, std::chrono::milliseconds{1});
+		ASSERT_EQ(frame[1].address, addrB);
+		ASSERT_TRUE(std::ranges::equal(frame[1].data, dataB));
+
+		ASSERT_TRUE(replay.next());
+		ASSERT_TRUE(replay.getFrame().empty());
+
+		ASSERT_TRUE(replay.next());
+		frame = replay.getFrame();
+		ASSERT_EQ(frame.size(), 1);
+		ASSERT_EQ(frame[0].time, std::chrono::milliseconds{25});
+		ASSERT_TRUE(std::ranges::equal(frame[0].data, dataA));
+
+		ASSERT_FALSE(replay.next());
+		ASSERT_FALSE(replay.isOpen());
+		ASSERT_EQ(replay.getFrameCount(), 3);
+		ASSERT_EQ(replay.getDatagramCount(), 3);
+
+		std::filesystem::remove(path);
+	}
+
+	TEST(Engine_Net_PacketCapture, Invalid) {
+		const auto path = (std::filesystem::temp_directory_path() / "Engine_Net_PacketCapture_Invalid.cap").string();
+
+		{
+			auto* file = fopen(path.c_str(), "wb");
+			ASSERT_NE(file, nullptr);
+			fputs("not a capture file", file);
+			fclose(file);
+		}
+
+		PacketReplay replay{path};
+		ASSERT_FALSE(replay.isOpen());
+		ASSERT_FALSE(replay.next());
+
+		std::filesystem::remove(path);
+	}
+}
@@ -0,0 +1,121 @@
+// STD
+#include <cstring>
+#include <random>
+
+// Google Test
+#include <gtest/gtest.h>
+
+// Engine
+#include <Engine/Net/PacketCodec.hpp>
+#include <Engine/Net/Packet.hpp>
+
+namespace {
+	using namespace Engine::Net;
+
+	/** Something that looks a bit like replication traffic: repeated headers with a few changing bytes. */
+	std::vector<byte> makePayload(std::mt19937& rng, int32 size) {
+		std::vector<byte> data;
+		while (std::ssize(data) < size) {
+			const byte msg[] = {7, 24, 0, 0, 0, 0x10, 0x20, 0x30, 0x40, 0, 0, 0x80, 0x3F, 0, 0, 0, 0};
+			data.insert(data.end(), std::begin(msg), std::end(msg));
+			for (int32 i = 0; i < 4; ++i) { data.push_back(static_cast<byte>(rng())); }
+		}
+		data.resize(size);
+		return data;
+	}
+
+	void roundTrip(const PacketCodec& codec, const std::vector<byte>& data) {
+		byte comp[sizeof(Packet::body) * 2];
+		byte decomp[sizeof(Packet::body)];
+
+		const auto csz = codec.compress(data, comp);
+		ASSERT_GT(csz, 0);
+
+		const auto dsz = codec.decompress({comp, static_cast<uintz>(csz)}, decomp);
+		ASSERT_EQ(dsz, std::ssize(data));
+		ASSERT_EQ(memcmp(decomp, data.data(), data.size()), 0);
+	}
+
+	TEST(Engine_Net_PacketCodec, RoundTrip) {
+		std::mt19937 rng{1234};
+		const PacketCodec codec;
+
+		for (int32 size : {1, 3, 4, 5, 16, 17, 100, 300, static_cast<int32>(sizeof(Packet::body))}) {
+			roundTrip(codec, makePayload(rng, size));
+
+			std::vector<byte> random(size);
+			for (auto& b : random) { b = static_cast<byte>(rng()); }
+			roundTrip(codec, random);
+		}
+
+		// Long runs need length continuation bytes.
+		roundTrip(codec, std::vector<byte>(sizeof(Packet::body), 42));
+	}
+
+	TEST(Engine_Net_PacketCodec, Incompressible) {
+		std::mt19937 rng{1234};
+		const PacketCodec codec;
+
+		std::vector<byte> random(sizeof(Packet::body));
+		for (auto& b : random) { b = static_cast<byte>(rng()); }
+
+		byte comp[sizeof(Packet::body)];
+		ASSERT_EQ(codec.compress(random, {comp, random.size() - 1}), 0);
+	}
+
+	TEST(Engine_Net_PacketCodec, Dictionary) {
+		std::mt19937 rng{1234};
+		std::vector<std::vector<byte>> samples;
+		for (int32 i = 0; i < 64; ++i) {
+			samples.push_back(makePayload(rng, 200));
+		}
+
+		const auto dict = PacketCodec::train(samples, 1024);
+		ASSERT_FALSE(dict.empty());
+		ASSERT_LE(dict.size(), 1024);
+
+		const PacketCodec plain;
+		const PacketCodec trained{dict};
+		ASSERT_NE(plain.getId(), trained.getId());
+		ASSERT_EQ(trained.getId(), PacketCodec{dict}.getId());
+
+		// Small payloads have little to reference without a dictionary.
+		const auto data = makePayload(rng, 64);
+		byte comp[sizeof(Packet::body)];
+		const auto plainSize = plain.compress(data, comp);
+		const auto trainedSize = trained.compress(data, comp);
+		ASSERT_GT(trainedSize, 0);
+		ASSERT_TRUE(plainSize == 0 || trainedSize < plainSize);
+
+		roundTrip(trained, data);
+		roundTrip(trained, makePayload(rng, sizeof(Packet::body)));
+	}
+
+	TEST(Engine_Net_PacketCodec, Malformed) {
+		std::mt19937 rng{1234};
+		const PacketCodec codec;
+		byte out[sizeof(Packet::body)];
+
+		// Offset before the start of the data.
+		const byte badOffset[] = {0x10, 1, 5, 0};
+		ASSERT_EQ(codec.decompress(badOffset, out), -1);
+
+		// Literals past the end of the input.
+		const byte badLiterals[] = {0x50, 1, 2};
+		ASSERT_EQ(codec.decompress(badLiterals, out), -1);
+
+		// Output larger than the destination.
+		const auto data = std::vector<byte>(sizeof(Packet::body), 1);
+		byte comp[sizeof(Packet::body)];
+		const auto csz = codec.compress(data, comp);
+		ASSERT_GT(csz, 0);
+		ASSERT_EQ(codec.decompress({comp, static_cast<uintz>(csz)}, {out, 100}), -1);
+
+		// Random garbage should never read or write out of bounds.
+		for (int32 i = 0; i < 1000; ++i) {
+			byte garbage[64];
+			for (auto& b : garbage) { b = static_cast<byte>(rng()); }
+			codec.decompress(garbage, out);
+		}
+	}
+}
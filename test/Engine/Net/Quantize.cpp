@@ -0,0 +1,145 @@
+// STD
+#include <random>
+
+// Google Test
+#include <gtest/gtest.h>
+
+// Engine
+#include <Engine/Net/Quantize.hpp>
+
+namespace {
+	using namespace Engine::Net;
+
+	constexpr QuantizedFloat posQuant{-4096.0f, 4096.0f, 1.0f / 1000.0f};
+	constexpr QuantizedFloat unitQuant{0.0f, 1.0f, 1.0f / 255.0f};
+	constexpr QuantizedInt intQuant{-100, 1000};
+	constexpr QuantizedQuat quatQuant{10};
+
+	static_assert(posQuant.bits() == 23);
+	static_assert(unitQuant.bits() == 8);
+	static_assert(intQuant.bits() == 11);
+	static_assert(quatQuant.component().bits() == 10);
+
+	/**
+	 * Writes values with @p write, reads them back with @p read and checks that the buffer
+	 * was fully consumed.
+	 */
+	void roundTrip(auto&& write, auto&& read) {
+		byte data[4096];
+		StaticBufferWriter writer{data};
+		write(writer);
+		writer.writeFlushBits();
+
+		BufferReader reader{data, writer.size()};
+		read(reader);
+		reader.readFlushBits();
+		ASSERT_EQ(reader.remaining(), 0);
+	}
+
+	TEST(Engine_Net_Quantize, Float) {
+		std::mt19937 rng{1234};
+		std::uniform_real_distribution<float32> dist{posQuant.min, posQuant.max};
+		std::vector<float32> values(500);
+		for (auto& v : values) { v = dist(rng); }
+		values.push_back(posQuant.min);
+		values.push_back(posQuant.max);
+		values.push_back(0.0f);
+
+		roundTrip([&](auto& buff){
+			for (const auto v : values) { writeQuantized<posQuant>(buff, v); }
+		}, [&](auto& buff){
+			for (const auto v : values) {
+				float32 res;
+				ASSERT_TRUE(readQuantized<posQuant>(buff, res));
+				ASSERT_LE(std::abs(res - v), posQuant.precision * 0.5f + 0.0005f) << v;
+			}
+		});
+	}
+
+	TEST(Engine_Net_Quantize, FloatClamp) {
+		roundTrip([&](auto& buff){
+			writeQuantized<unitQuant>(buff, -5.0f);
+			writeQuantized<unitQuant>(buff, 5.0f);
+		}, [&](auto& buff){
+			float32 res;
+			ASSERT_TRUE(readQuantized<unitQuant>(buff, res));
+			ASSERT_EQ(res, 0.0f);
+			ASSERT_TRUE(readQuantized<unitQuant>(buff, res));
+			ASSERT_EQ(res, 1.0f);
+		});
+
+		static_assert(unitQuant.contains(0.0f) && unitQuant.contains(1.0f));
+		static_assert(!unitQuant.contains(-0.001f) && !unitQuant.contains(1.001f));
+	}
+
+	TEST(Engine_Net_Quantize, Int) {
+		roundTrip([&](auto& buff){
+			for (int32 i = intQuant.min; i <= intQuant.max; ++i) { writeQuantized<intQuant>(buff, i); }
+			writeQuantized<intQuant>(buff, 5000);
+		}, [&](auto& buff){
+			int32 res;
+			for (int32 i = intQuant.min; i <= intQuant.max; ++i) {
+				ASSERT_TRUE(readQuantized<intQuant>(buff, res));
+				ASSERT_EQ(res, i);
+			}
+			ASSERT_TRUE(readQuantized<intQuant>(buff, res));
+			ASSERT_EQ(res, intQuant.max);
+		});
+	}
+
+	TEST(Engine_Net_Quantize, Quat) {
+		std::mt19937 rng{4321};
+		std::normal_distribution<float32> dist;
+		std::vector<glm::quat> values(500);
+		for (auto& q : values) {
+			q.x = dist(rng);
+			q.y = dist(rng);
+			q.z = dist(rng);
+			q.w = dist(rng);
+			const auto len = std::sqrt(q.x*q.x + q.y*q.y + q.z*q.z + q.w*q.w);
+			q.x /= len; q.y /= len; q.z /= len; q.w /= len;
+		}
+
+		roundTrip([&](auto& buff){
+			for (const auto& q : values) { writeQuantized<quatQuant>(buff, q); }
+		}, [&](auto& buff){
+			for (const auto& q : values) {
+				glm::quat res;
+				ASSERT_TRUE(readQuantized<quatQuant>(buff, res));
+
+				// q and -q are the same rotation so compare using |dot|.
+				const auto dot = std::abs(q.x*res.x + q.y*res.y + q.z*res.z + q.w*res.w);
+				ASSERT_GT(dot, 0.9999f);
+			}
+		});
+	}
+
+	TEST(Engine_Net_Quantize, Mixed) {
+		roundTrip([&](auto& buff){
+			writeQuantized<unitQuant>(buff, 0.5f);
+			writeQuantized<intQuant>(buff, 7);
+			buff.writeFlushBits();
+			buff.write(int32{12345});
+			writeQuantized<posQuant>(buff, glm::vec2{-1.5f, 2.25f});
+		}, [&](auto& buff){
+			float32 f;
+			int32 i;
+			glm::vec2 v;
+			ASSERT_TRUE(readQuantized<unitQuant>(buff, f));
+			ASSERT_TRUE(readQuantized<intQuant>(buff, i));
+			buff.readFlushBits();
+			ASSERT_TRUE(buff.read(&i));
+			ASSERT_EQ(i, 12345);
+			ASSERT_TRUE(readQuantized<posQuant>(buff, v));
+			ASSERT_NEAR(v.x, -1.5f, 0.001f);
+			ASSERT_NEAR(v.y, 2.25f, 0.001f);
+		});
+	}
+
+	TEST(Engine_Net_Quantize, ReadPastEnd) {
+		byte data[2] = {};
+		BufferReader reader{data, sizeof(data)};
+		float32 res;
+		ASSERT_FALSE(readQuantized<posQuant>(reader, res));
+	}
+}
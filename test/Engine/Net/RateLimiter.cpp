@@ -0,0 +1,49 @@
+// Google Test
+#include <gtest/gtest.h>
+
+// Engine
+#include <Engine/Net/RateLimiter.hpp>
+
+namespace {
+	using namespace Engine::Net;
+	using namespace std::chrono_literals;
+
+	TEST(Engine_Net_RateLimiter, PerAddress) {
+		RateLimiter limiter{64, 2, 1000};
+		const IPv4Address a = {127, 0, 0, 1, 1000};
+		const IPv4Address b = {127, 0, 0, 2, 1000};
+		auto time = Engine::Clock::TimePoint{} + 1s;
+
+		// Buckets start full.
+		ASSERT_TRUE(limiter.allow(a, time));
+		ASSERT_TRUE(limiter.allow(a, time));
+		ASSERT_FALSE(limiter.allow(a, time));
+		ASSERT_EQ(limiter.getDeniedCount(), 1);
+
+		// Other ports on the same IP share the bucket.
+		ASSERT_FALSE(limiter.allow({127, 0, 0, 1, 1001}, time));
+		ASSERT_EQ(limiter.getDeniedCount(), 2);
+
+		// Other addresses are unaffected unless they share a bucket.
+		ASSERT_TRUE(limiter.allow(b, time));
+
+		// Refills at the given rate.
+		time += 500ms;
+		ASSERT_TRUE(limiter.allow(a, time));
+		ASSERT_FALSE(limiter.allow(a, time));
+		ASSERT_EQ(limiter.getDeniedCount(), 3);
+	}
+
+	TEST(Engine_Net_RateLimiter, Total) {
+		RateLimiter limiter{64, 100, 10};
+		const auto time = Engine::Clock::TimePoint{} + 1s;
+
+		int32 allowed = 0;
+		for (uint8 host = 0; host < 100; ++host) {
+			allowed += limiter.allow({10, 0, 0, host, 1000}, time);
+		}
+
+		ASSERT_EQ(allowed, 10);
+		ASSERT_EQ(limiter.getDeniedCount(), 90);
+	}
+}
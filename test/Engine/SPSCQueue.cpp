@@ -0,0 +1,69 @@
+// STD
+#include <thread>
+
+// Google Test
+#include <gtest/gtest.h>
+
+// Engine
+#include <Engine/SPSCQueue.hpp>
+
+namespace {
+	TEST(Engine_SPSCQueue, PushPop) {
+		Engine::SPSCQueue<int32, 4> queue;
+		int32 value = 0;
+
+		ASSERT_TRUE(queue.empty());
+		ASSERT_FALSE(queue.pop(value));
+
+		for (int32 i = 0; i < 4; ++i) {
+			ASSERT_TRUE(queue.push(i));
+		}
+		ASSERT_FALSE(queue.push(4));
+		ASSERT_EQ(queue.size(), 4);
+
+		for (int32 i = 0; i < 4; ++i) {
+			ASSERT_TRUE(queue.pop(value));
+			ASSERT_EQ(value, i);
+		}
+		ASSERT_TRUE(queue.empty());
+	}
+
+	TEST(Engine_SPSCQueue, Wrap) {
+		Engine::SPSCQueue<int32, 4> queue;
+		int32 value = 0;
+
+		for (int32 i = 0; i < 1000; ++i) {
+			ASSERT_TRUE(queue.push(i));
+			ASSERT_TRUE(queue.push(-i));
+			ASSERT_TRUE(queue.pop(value));
+			ASSERT_EQ(value, i);
+			ASSERT_TRUE(queue.pop(value));
+			ASSERT_EQ(value, -i);
+		}
+	}
+
+	TEST(Engine_SPSCQueue, Threaded) {
+		constexpr int32 count = 100'000;
+		Engine::SPSCQueue<int32, 256> queue;
+
+		std::thread producer{[&]{
+			for (int32 i = 0; i < count;) {
+				if (queue.push(i)) { ++i; } else { std::this_thread::yield(); }
+			}
+		}};
+
+		int32 expected = 0;
+		while (expected < count) {
+			int32 value;
+			if (queue.pop(value)) {
+				ASSERT_EQ(value, expected);
+				++expected;
+			} else {
+				std::this_thread::yield();
+			}
+		}
+
+		producer.join();
+		ASSERT_TRUE(queue.empty());
+	}
+}
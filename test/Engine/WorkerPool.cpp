@@ -0,0 +1,28 @@
+// STD
+#include <atomic>
+#include <vector>
+
+// Google Test
+#include <gtest/gtest.h>
+
+// Engine
+#include <Engine/WorkerPool.hpp>
+
+namespace {
+	TEST(Engine_WorkerPool, RunsEachIndexOnce) {
+		for (const int32 threads : {0, 1, 4}) {
+			Engine::WorkerPool pool{threads};
+			ASSERT_EQ(pool.getThreadCount(), threads);
+
+			// Run a few batches to make sure the workers are reused correctly.
+			for (const int32 count : {0, 1, 7, 1000}) {
+				std::vector<std::atomic<int32>> calls(count);
+				pool.run(count, [&](int32 i){ ++calls[i]; });
+
+				for (int32 i = 0; i < count; ++i) {
+					ASSERT_EQ(calls[i], 1) << "threads " << threads << " count " << count << " index " << i;
+				}
+			}
+		}
+	}
+}
@@ -0,0 +1,102 @@
+// STD
+#include <random>
+#include <vector>
+
+// Google Test
+#include <gtest/gtest.h>
+
+// Engine
+#include <Engine/Net/BufferWriter.hpp>
+
+// Game
+#include <Game/comps/ActionComponent.hpp>
+
+namespace {
+	using Game::Action;
+	using Game::ActionState;
+
+	/** Adapts StaticBufferWriter to the bit writing interface of message writers. */
+	class TestWriter {
+		public:
+			Engine::Net::StaticBufferWriter& buff;
+
+			template<int N>
+			void write(uint32 t) { buff.writeBits<N>(t); }
+	};
+
+	/** Mostly unchanged states with occasional changes, similar to real input. */
+	std::vector<ActionState> makeStates(int32 count, uint32 seed) {
+		std::mt19937 rng{seed};
+		std::vector<ActionState> states(count);
+		ActionState curr = {};
+
+		for (auto& state : states) {
+			const auto r = rng() % 8;
+			if (r == 0) {
+				auto& btn = curr.buttons[rng() % static_cast<int32>(Action::_button_count)];
+				btn.latest = !btn.latest;
+				btn.pressCount = btn.latest;
+				btn.releaseCount = !btn.latest;
+			} else if (r == 1) {
+				curr.target = {static_cast<float32>(rng() % 100) * 0.25f, -static_cast<float32>(rng() % 100)};
+			} else {
+				for (auto& btn : curr.buttons) { btn.pressCount = 0; btn.releaseCount = 0; }
+			}
+			state = curr;
+		}
+
+		return states;
+	}
+
+	TEST(Game_ActionState, WindowRoundTrip) {
+		for (const int32 count : {1, 2, 16, 17, 32, 255}) {
+			const auto states = makeStates(count, count);
+			const auto get = [&](int32 age) -> const ActionState& { return states[count - 1 - age]; };
+
+			byte data[4096] = {};
+			Engine::Net::StaticBufferWriter buff{data};
+			TestWriter writer{buff};
+			ActionState::netWriteWindow(writer, count, get);
+			buff.writeFlushBits();
+
+			// Should be much smaller than writing every state in full.
+			ASSERT_LT(buff.size(), count * 15 + 15);
+
+			std::vector<int32> ages;
+			Engine::Net::BufferReader msg{data, buff.size()};
+			const auto ok = ActionState::netReadWindow(msg, count, [&](int32 age, const ActionState& state){
+				ages.push_back(age);
+				ASSERT_TRUE(state.netEqual(get(age))) << "age " << age << " of " << count;
+			});
+
+			ASSERT_TRUE(ok);
+			ASSERT_EQ(ages.size(), count);
+			for (int32 i = 0; i < count; ++i) { ASSERT_EQ(ages[i], count - 1 - i); }
+		}
+	}
+
+	TEST(Game_ActionState, WindowMalformed) {
+		const auto states = makeStates(32, 1);
+		const auto get = [&](int32 age) -> const ActionState& { return states[31 - age]; };
+
+		byte data[4096] = {};
+		Engine::Net::StaticBufferWriter buff{data};
+		TestWriter writer{buff};
+		ActionState::netWriteWindow(writer, 32, get);
+		buff.writeFlushBits();
+
+		// Larger than allowed.
+		{
+			Engine::Net::BufferReader msg{data, buff.size()};
+			ASSERT_FALSE(ActionState::netReadWindow(msg, 16, [](int32, const ActionState&){}));
+		}
+
+		// Truncated.
+		{
+			int32 calls = 0;
+			Engine::Net::BufferReader msg{data, buff.size() - 1};
+			ASSERT_FALSE(ActionState::netReadWindow(msg, 32, [&](int32, const ActionState&){ ++calls; }));
+			ASSERT_LT(calls, 32);
+		}
+	}
+}
@@ -0,0 +1,185 @@
+// STD
+#include <utility>
+
+// Google Test
+#include <gtest/gtest.h>
+
+// Meta
+#include <Meta/TypeSet/TypeSet.hpp>
+
+// Engine
+#include <Engine/ECS/World.hpp>
+#include <Engine/Net/BufferWriter.hpp>
+#include <Engine/Net/Delta.hpp>
+
+// Game
+#include <Game/comps/ECSNetworkingComponent.hpp>
+
+namespace {
+	class TrackedComponent {
+		public:
+			int32 a = 0;
+			float32 b = 0;
+			uint8 c = 0;
+	};
+
+	class UntrackedComponent {
+		public:
+			int32 value = 0;
+	};
+
+	class TestSystem {
+		public:
+			TestSystem(int) {}
+			void setup() {}
+			void preTick() {}
+			void tick() {}
+			void postTick() {}
+			void update(float32 dt) {}
+			void preStoreSnapshot() {}
+			void postLoadSnapshot() {}
+	};
+
+	using TestWorld = Engine::ECS::WorldHelper<64,
+		Meta::TypeSet::TypeSet<TestSystem>,
+		Meta::TypeSet::TypeSet<TrackedComponent, UntrackedComponent>,
+		Meta::TypeSet::TypeSet<>
+	>;
+}
+
+template<>
+struct Engine::ECS::IsModifiedTracked<TrackedComponent> : std::true_type {};
+
+#define ECS_WORLD_TYPE TestWorld::BaseType
+#define ECS_WORLD_ARG int&&
+#include <Engine/ECS/World.ipp>
+
+namespace {
+	using Game::ECSNetworkingComponent;
+	using Engine::ECS::Entity;
+
+	struct Baseline {
+		int32 a;
+		float32 b;
+		uint8 c;
+
+		bool operator==(const Baseline&) const = default;
+	};
+
+	using TestDelta = Engine::Net::Delta<&Baseline::a, &Baseline::b, &Baseline::c>;
+
+	/** The same baseline handling as EntityNetworkingSystem::networkComponentUpdate, writing to @p buff instead of a message. */
+	bool networkUpdate(const TestWorld& world, Entity ent, ECSNetworkingComponent::NeighborData& data, Engine::Net::StaticBufferWriter& buff, int32& bytes) {
+		return data.updateBaseline(TestWorld::getComponentId<TrackedComponent>(), world.getModifiedStamp<TrackedComponent>(ent),
+			[&]{
+				const auto& comp = world.getComponent<TrackedComponent>(ent);
+				return Baseline{.a = comp.a, .b = comp.b, .c = comp.c};
+			},
+			[&](const Baseline& curr, const Baseline* prev){
+				// Fails when there isn't room, like beginMessage when the send queue is full.
+				if (buff.space() < sizeof(TestDelta::Mask) + sizeof(Baseline)) { return false; }
+				const auto start = buff.size();
+				TestDelta::write(curr, prev, buff);
+				bytes += static_cast<int32>(buff.size() - start);
+				return true;
+			}
+		);
+	}
+
+	void applyDelta(TrackedComponent& comp, Engine::Net::BufferReader& buff) {
+		Baseline delta = {};
+		TestDelta::Mask fields;
+		ASSERT_TRUE(TestDelta::read(delta, fields, buff));
+		if (fields & TestDelta::bit<&Baseline::a>()) { comp.a = delta.a; }
+		if (fields & TestDelta::bit<&Baseline::b>()) { comp.b = delta.b; }
+		if (fields & TestDelta::bit<&Baseline::c>()) { comp.c = delta.c; }
+	}
+
+	TEST(Game_ComponentDelta, MarkedOnMutableAccess) {
+		int arg = 0;
+		TestWorld world{std::move(arg)};
+		const auto ent = world.createEntity();
+		world.addComponent<TrackedComponent>(ent);
+		world.addComponent<UntrackedComponent>(ent);
+
+		const auto tracked = world.getModifiedStamp<TrackedComponent>(ent);
+		const auto untracked = world.getModifiedStamp<UntrackedComponent>(ent);
+		ASSERT_NE(tracked, 0);
+		ASSERT_NE(untracked, 0);
+
+		// Reading through a const world must not mark.
+		std::as_const(world).getComponent<TrackedComponent>(ent);
+		std::as_const(world).tryComponent<TrackedComponent>(ent);
+		ASSERT_EQ(world.getModifiedStamp<TrackedComponent>(ent), tracked);
+
+		world.getComponent<TrackedComponent>(ent).a = 5;
+		ASSERT_NE(world.getModifiedStamp<TrackedComponent>(ent), tracked);
+
+		world.getComponent<UntrackedComponent>(ent).value = 5;
+		ASSERT_EQ(world.getModifiedStamp<UntrackedComponent>(ent), untracked);
+
+		world.markModified<UntrackedComponent>(ent);
+		ASSERT_NE(world.getModifiedStamp<UntrackedComponent>(ent), untracked);
+	}
+
+	TEST(Game_ComponentDelta, RoundTrip) {
+		int arg = 0;
+		TestWorld world{std::move(arg)};
+		const auto ent = world.createEntity();
+		auto& comp = world.addComponent<TrackedComponent>(ent);
+		comp = {.a = 1, .b = 2.0f, .c = 3};
+
+		ECSNetworkingComponent::NeighborData data{ECSNetworkingComponent::NeighborState::Current};
+		TrackedComponent remote = {};
+		byte storage[256];
+
+		const auto sendAndApply = [&]{
+			Engine::Net::StaticBufferWriter buff{storage};
+			int32 bytes = 0;
+			EXPECT_TRUE(networkUpdate(world, ent, data, buff, bytes));
+			if (bytes) {
+				Engine::Net::BufferReader reader{buff.data(), buff.size()};
+				applyDelta(remote, reader);
+				EXPECT_EQ(reader.remaining(), 0);
+			}
+			return bytes;
+		};
+
+		// No baseline yet, every field is sent.
+		ASSERT_EQ(sendAndApply(), 1 + 4 + 4 + 1);
+		ASSERT_EQ(remote.a, 1);
+		ASSERT_EQ(remote.b, 2.0f);
+		ASSERT_EQ(remote.c, 3);
+
+		// Untouched, nothing is sent.
+		ASSERT_EQ(sendAndApply(), 0);
+
+		// Only the changed field is sent.
+		world.getComponent<TrackedComponent>(ent).b = 7.5f;
+		ASSERT_EQ(sendAndApply(), 1 + 4);
+		ASSERT_EQ(remote.a, 1);
+		ASSERT_EQ(remote.b, 7.5f);
+		ASSERT_EQ(remote.c, 3);
+
+		// Touched but unchanged, nothing is sent.
+		world.getComponent<TrackedComponent>(ent).c = 3;
+		ASSERT_EQ(sendAndApply(), 0);
+
+		world.getComponent<TrackedComponent>(ent) = {.a = -4, .b = 7.5f, .c = 9};
+		ASSERT_EQ(sendAndApply(), 1 + 4 + 1);
+		ASSERT_EQ(remote.a, -4);
+		ASSERT_EQ(remote.b, 7.5f);
+		ASSERT_EQ(remote.c, 9);
+
+		// If the delta can't be written the baseline is kept and it is sent next time.
+		world.getComponent<TrackedComponent>(ent).a = 11;
+		{
+			Engine::Net::StaticBufferWriter full{storage, uintz{0}};
+			int32 bytes = 0;
+			ASSERT_FALSE(networkUpdate(world, ent, data, full, bytes));
+			ASSERT_EQ(bytes, 0);
+		}
+		ASSERT_EQ(sendAndApply(), 1 + 4);
+		ASSERT_EQ(remote.a, 11);
+	}
+}
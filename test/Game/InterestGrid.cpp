@@ -0,0 +1,108 @@
+// STD
+#include <algorithm>
+#include <random>
+
+// Google Test
+#include <gtest/gtest.h>
+
+// Game
+#include <Game/InterestGrid.hpp>
+
+namespace {
+	using Game::InterestGrid;
+	using Game::WorldVec;
+	using Engine::ECS::Entity;
+
+	/** Entities as (id, gen) pairs so failures are printable without linking the engine. */
+	using Ents = std::vector<std::pair<uint16, uint16>>;
+
+	Ents query(const InterestGrid& grid, Game::ZoneId zoneId, WorldVec center, Game::WorldUnit range) {
+		Ents result;
+		grid.query(zoneId, center, range, [&](Entity ent){ result.emplace_back(ent.id, ent.gen); });
+		std::ranges::sort(result);
+		return result;
+	}
+
+	TEST(Game_InterestGrid, Query) {
+		InterestGrid grid;
+		grid.update({1, 0}, 0, {0, 0});
+		grid.update({2, 0}, 0, {4.9f, -4.9f});
+		grid.update({3, 0}, 0, {5.1f, 0});
+		grid.update({4, 0}, 1, {1, 1});
+
+		ASSERT_EQ(query(grid, 0, {0, 0}, 5), (Ents{{1, 0}, {2, 0}}));
+		ASSERT_EQ(query(grid, 0, {0, 0}, 6), (Ents{{1, 0}, {2, 0}, {3, 0}}));
+		ASSERT_EQ(query(grid, 1, {0, 0}, 6), (Ents{{4, 0}}));
+		ASSERT_EQ(query(grid, 2, {0, 0}, 6), (Ents{}));
+	}
+
+	TEST(Game_InterestGrid, MoveAndRemove) {
+		InterestGrid grid;
+		grid.update({1, 0}, 0, {0, 0});
+		grid.update({2, 0}, 0, {1, 0});
+		grid.update({3, 0}, 0, {2, 0});
+
+		grid.update({1, 0}, 0, {100, 100});
+		ASSERT_EQ(query(grid, 0, {0, 0}, 5), (Ents{{2, 0}, {3, 0}}));
+		ASSERT_EQ(query(grid, 0, {100, 100}, 5), (Ents{{1, 0}}));
+
+		grid.remove({2, 0});
+		ASSERT_FALSE(grid.contains({2, 0}));
+		ASSERT_EQ(query(grid, 0, {0, 0}, 5), (Ents{{3, 0}}));
+
+		// Reused id with a new generation replaces the old entity.
+		grid.update({3, 1}, 0, {-50, 0});
+		ASSERT_FALSE(grid.contains({3, 0}));
+		ASSERT_EQ(query(grid, 0, {0, 0}, 5), (Ents{}));
+		ASSERT_EQ(query(grid, 0, {-50, 0}, 5), (Ents{{3, 1}}));
+	}
+
+	TEST(Game_InterestGrid, BruteForce) {
+		constexpr int32 count = 300;
+		std::mt19937 rng{4444};
+		std::uniform_real_distribution<float32> posDist{-60, 60};
+		std::uniform_real_distribution<float32> moveDist{-10, 10};
+		std::uniform_int_distribution<Game::ZoneId> zoneDist{0, 2};
+
+		InterestGrid grid;
+		std::vector<WorldVec> pos(count);
+		std::vector<Game::ZoneId> zone(count);
+		std::vector<bool> alive(count, true);
+
+		for (int32 i = 0; i < count; ++i) {
+			pos[i] = {posDist(rng), posDist(rng)};
+			zone[i] = zoneDist(rng);
+			grid.update({static_cast<uint16>(i), 0}, zone[i], pos[i]);
+		}
+
+		for (int32 step = 0; step < 50; ++step) {
+			for (int32 i = 0; i < count; ++i) {
+				if (!alive[i]) { continue; }
+				if (rng() % 50 == 0) {
+					alive[i] = false;
+					grid.remove({static_cast<uint16>(i), 0});
+					continue;
+				}
+
+				pos[i] += WorldVec{moveDist(rng), moveDist(rng)};
+				if (rng() % 20 == 0) { zone[i] = zoneDist(rng); }
+				grid.update({static_cast<uint16>(i), 0}, zone[i], pos[i]);
+			}
+
+			const WorldVec center = {posDist(rng), posDist(rng)};
+			const auto zoneId = zoneDist(rng);
+			for (const Game::WorldUnit range : {5.0f, 20.0f}) {
+				Ents expected;
+				for (int32 i = 0; i < count; ++i) {
+					const auto diff = glm::abs(pos[i] - center);
+					if (alive[i] && zone[i] == zoneId && diff.x <= range && diff.y <= range) {
+						expected.emplace_back(static_cast<uint16>(i), 0);
+					}
+				}
+
+				std::ranges::sort(expected);
+				ASSERT_EQ(query(grid, zoneId, center, range), expected);
+			}
+		}
+	}
+}
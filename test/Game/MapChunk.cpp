@@ -0,0 +1,97 @@
+// STD
+#include <random>
+
+// Google Test
+#include <gtest/gtest.h>
+
+// Game
+#include <Game/MapChunk.hpp>
+
+namespace {
+	using Game::BlockId;
+	using Game::MapChunk;
+	using Game::chunkSize;
+
+	constexpr int32 chunkArea = chunkSize.x * chunkSize.y;
+
+	void fillRandomRuns(MapChunk& chunk, std::mt19937& rng, int32 maxRun) {
+		std::uniform_int_distribution<int32> runDist{1, maxRun};
+		std::uniform_int_distribution<int32> blockDist{0, BlockId::_count - 1};
+		BlockId* linear = &chunk.data[0][0];
+
+		for (int32 i = 0; i < chunkArea;) {
+			const auto bid = static_cast<BlockId>(blockDist(rng));
+			const auto stop = std::min(i + runDist(rng), chunkArea);
+			for (; i < stop; ++i) { linear[i] = bid; }
+		}
+	}
+
+	void expectRoundTrip(const MapChunk& chunk) {
+		std::vector<byte> encoding;
+		chunk.toRLE(encoding);
+
+		#if GAME_RLE_SIMD
+		{
+			std::vector<byte> scalar;
+			chunk.toRLE_Scalar(scalar);
+			ASSERT_EQ(encoding, scalar);
+		}
+		#endif
+
+		MapChunk decoded;
+		decoded.fromRLE(encoding.data(), encoding.data() + encoding.size());
+
+		// BlockId::None runs are skipped by the decoder so they stay as the default (None).
+		ASSERT_EQ(chunk.data, decoded.data);
+	}
+
+	TEST(Game_MapChunk, RLE_Uniform) {
+		MapChunk chunk;
+		std::ranges::fill(&chunk.data[0][0], &chunk.data[0][0] + chunkArea, BlockId::Dirt);
+		expectRoundTrip(chunk);
+
+		std::vector<byte> encoding;
+		chunk.toRLE(encoding);
+		ASSERT_EQ(encoding.size(), sizeof(MapChunk::RLEPair));
+	}
+
+	TEST(Game_MapChunk, RLE_Alternating) {
+		MapChunk chunk;
+		BlockId* linear = &chunk.data[0][0];
+		for (int32 i = 0; i < chunkArea; ++i) {
+			linear[i] = (i & 1) ? BlockId::Dirt : BlockId::Grass;
+		}
+		expectRoundTrip(chunk);
+
+		std::vector<byte> encoding;
+		chunk.toRLE(encoding);
+		ASSERT_EQ(encoding.size(), chunkArea * sizeof(BlockId));
+	}
+
+	TEST(Game_MapChunk, RLE_Fuzz) {
+		std::mt19937 rng{0x5EED};
+		for (int32 maxRun : {1, 2, 7, 8, 9, 64, 500, chunkArea}) {
+			for (int32 i = 0; i < 64; ++i) {
+				MapChunk chunk;
+				fillRandomRuns(chunk, rng, maxRun);
+				expectRoundTrip(chunk);
+			}
+		}
+	}
+
+	TEST(Game_MapChunk, RLE_DecodeReportsEdits) {
+		std::mt19937 rng{1234};
+		MapChunk chunk;
+		fillRandomRuns(chunk, rng, 32);
+		chunk.data[0][0] = BlockId::Dirt;
+
+		std::vector<byte> encoding;
+		chunk.toRLE(encoding);
+
+		MapChunk copy = chunk;
+		ASSERT_FALSE(copy.fromRLE(encoding.data(), encoding.data() + encoding.size()));
+
+		MapChunk empty;
+		ASSERT_TRUE(empty.fromRLE(encoding.data(), encoding.data() + encoding.size()));
+	}
+}
@@ -0,0 +1,192 @@
+// STD
+#include <algorithm>
+#include <limits>
+#include <random>
+
+// Google Test
+#include <gtest/gtest.h>
+
+// Game
+#include <Game/ZoneClusterer.hpp>
+
+namespace {
+	using Game::ZoneClusterer;
+	using Game::WorldAbsVec;
+	using Game::zoneMustJoinDist;
+	using Engine::ECS::Entity;
+
+	class TestPlayer {
+		public:
+			bool alive = false;
+			Game::RealmId realmId = 0;
+			WorldAbsVec pos = {};
+	};
+
+	/** The group of each player, by entity id, as the smallest entity id in the group. Dead players are -1. */
+	using Groups = std::vector<int32>;
+
+	constexpr auto unlimited = std::numeric_limits<int64>::max();
+
+	/** Reference implementation checking every pair of players. */
+	Groups bruteForce(const std::vector<TestPlayer>& players) {
+		const auto count = static_cast<int32>(players.size());
+		Groups groups(count, -1);
+		for (int32 i = 0; i < count; ++i) {
+			if (players[i].alive) { groups[i] = i; }
+		}
+
+		// Repeatedly relabel until nothing changes. Slow but obviously correct.
+		for (bool changed = true; changed;) {
+			changed = false;
+			for (int32 a = 0; a < count; ++a) {
+				for (int32 b = a + 1; b < count; ++b) {
+					if (!players[a].alive || !players[b].alive) { continue; }
+					if (players[a].realmId != players[b].realmId) { continue; }
+					if (ZoneClusterer::metric(players[a].pos, players[b].pos) > zoneMustJoinDist) { continue; }
+					if (groups[a] == groups[b]) { continue; }
+					const auto min = std::min(groups[a], groups[b]);
+					groups[a] = groups[b] = min;
+					changed = true;
+				}
+			}
+		}
+
+		return groups;
+	}
+
+	Groups clustered(const ZoneClusterer& clusterer, int32 count) {
+		Groups groups(count, -1);
+		for (const auto& group : clusterer.getGroups()) {
+			int32 min = std::numeric_limits<int32>::max();
+			for (const auto i : group.members) {
+				min = std::min<int32>(min, clusterer.getPlayer(i).ent.id);
+			}
+
+			for (const auto i : group.members) {
+				groups[clusterer.getPlayer(i).ent.id] = min;
+			}
+		}
+		return groups;
+	}
+
+	void updateAll(ZoneClusterer& clusterer, const std::vector<TestPlayer>& players) {
+		clusterer.beginUpdate();
+		for (int32 i = 0; i < std::ssize(players); ++i) {
+			const auto& ply = players[i];
+			if (ply.alive) { clusterer.update({static_cast<uint16>(i), 0}, ply.realmId, ply.pos); }
+		}
+		clusterer.endUpdate();
+	}
+
+	TEST(Game_ZoneClusterer, MatchesBruteForce) {
+		std::mt19937 rng{1234};
+
+		for (int32 run = 0; run < 50; ++run) {
+			// Vary the density so there are a mix of large groups and solo players.
+			const auto count = 1 + static_cast<int32>(rng() % 200);
+			const auto range = static_cast<int64>(zoneMustJoinDist) * (1 + rng() % 20);
+			std::uniform_int_distribution<int64> posDist{-range, range};
+
+			std::vector<TestPlayer> players(count);
+			for (auto& ply : players) {
+				ply = {true, static_cast<Game::RealmId>(rng() % 3), {posDist(rng), posDist(rng)}};
+			}
+
+			ZoneClusterer clusterer;
+			updateAll(clusterer, players);
+			clusterer.process(unlimited);
+			ASSERT_TRUE(clusterer.idle());
+			ASSERT_EQ(clustered(clusterer, count), bruteForce(players)) << "run " << run;
+		}
+	}
+
+	TEST(Game_ZoneClusterer, JoinDistance) {
+		ZoneClusterer clusterer;
+		clusterer.beginUpdate();
+
+		// Exactly the join distance apart across a cell boundary.
+		clusterer.update({0, 0}, 0, {-1, 0});
+		clusterer.update({1, 0}, 0, {zoneMustJoinDist - 1, 0});
+
+		// Just over the join distance.
+		clusterer.update({2, 0}, 0, {5 * zoneMustJoinDist, 0});
+		clusterer.update({3, 0}, 0, {6 * zoneMustJoinDist, 1});
+
+		// Same position different realm.
+		clusterer.update({4, 0}, 1, {-1, 0});
+
+		clusterer.endUpdate();
+		clusterer.process(unlimited);
+		ASSERT_EQ(clustered(clusterer, 5), (Groups{0, 0, 2, 3, 4}));
+	}
+
+	TEST(Game_ZoneClusterer, IncrementalMatchesBruteForce) {
+		std::mt19937 rng{5678};
+		constexpr int32 count = 150;
+		constexpr int64 range = 20 * zoneMustJoinDist;
+
+		for (const int64 threshold : {0, 10}) {
+			std::vector<TestPlayer> players(count);
+			ZoneClusterer clusterer;
+			clusterer.setMoveThreshold(threshold);
+
+			for (int32 tick = 0; tick < 300; ++tick) {
+				for (auto& ply : players) {
+					const auto r = rng() % 1000;
+					if (!ply.alive) {
+						// Join somewhere random.
+						if (r < 20) {
+							ply = {true, static_cast<Game::RealmId>(rng() % 2), {static_cast<int64>(rng() % range), static_cast<int64>(rng() % range)}};
+						}
+					} else if (r < 2) {
+						// Leave.
+						ply.alive = false;
+					} else if (r < 4) {
+						// Teleport to a different realm.
+						ply.realmId = !ply.realmId;
+					} else if (r < 10) {
+						// Teleport in the same realm.
+						ply.pos = {static_cast<int64>(rng() % range), static_cast<int64>(rng() % range)};
+					} else {
+						// Walk. Some players stand still.
+						constexpr int64 speed = 8;
+						ply.pos.x += static_cast<int64>(rng() % (2 * speed + 1)) - speed;
+						ply.pos.y += static_cast<int64>(rng() % (2 * speed + 1)) - speed;
+					}
+				}
+
+				updateAll(clusterer, players);
+
+				// Not enough budget to keep up with all of the changes.
+				clusterer.process(1 + rng() % 64);
+
+				// Every so often let everything settle and check against the reference.
+				if (tick % 10 == 0) {
+					while (!clusterer.idle()) { clusterer.process(64); }
+
+					// Compare against the positions last evaluated at since players
+					// may have moved less than the threshold.
+					auto evaluated = players;
+					for (const auto& group : clusterer.getGroups()) {
+						for (const auto i : group.members) {
+							const auto& ply = clusterer.getPlayer(i);
+							evaluated[ply.ent.id].realmId = ply.realmId;
+							evaluated[ply.ent.id].pos = ply.pos;
+						}
+					}
+
+					for (int32 i = 0; i < count; ++i) {
+						if (!players[i].alive) { continue; }
+						ASSERT_EQ(evaluated[i].realmId, players[i].realmId);
+						ASSERT_LE(ZoneClusterer::metric(evaluated[i].pos, players[i].pos), threshold);
+					}
+
+					ASSERT_EQ(clustered(clusterer, count), bruteForce(evaluated)) << "tick " << tick << " threshold " << threshold;
+					if (threshold == 0) {
+						ASSERT_EQ(clustered(clusterer, count), bruteForce(players)) << "tick " << tick;
+					}
+				}
+			}
+		}
+	}
+}